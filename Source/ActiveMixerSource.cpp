@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    ActiveMixerSource.cpp
+    Created: 17 Oct 2026 9:12:40pm
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#include "ActiveMixerSource.h"
+
+/******************************************
+* Name:
+*  ActiveMixerSource
+* Description:
+*  constructor of the ActiveMixerSource class. Mixes only
+*  the DJAudioPlayers of the pool that are currently in use,
+*  instead of every player in the pool.
+* Parameters:
+*  playerPool: reference to global PlayerPool
+* Output:
+*  N/A
+*******************************************/
+ActiveMixerSource::ActiveMixerSource(PlayerPool& _playerPool) :
+    playerPool(_playerPool)
+{
+    // no players have been rendered yet
+    for (auto i = 0; i < PlayerPool::N; ++i) {
+        rendered[i] = false;
+    }
+}
+
+/******************************************
+* Name:
+*  prepareToPlay
+* Description:
+*  override of the base class prepareToPlay method. Prepares
+*  every player in the pool up front, so a player can start being
+*  mixed the moment it is taken from the pool, and allocates the
+*  scratch buffer used for mixing.
+* Parameters:
+*  samplesPerBlockExpected: no. of samples to return on each getNextAudioBlock call
+*  sampleRate: audio sampling rate
+* Output:
+*  N/A
+*******************************************/
+void ActiveMixerSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    // allocate scratch buffer so the audio thread does not need to
+    tempBuffer.setSize(2, samplesPerBlockExpected);
+
+    // prepare all players, active or not
+    for (auto i = 0; i < playerPool.size(); ++i) {
+        playerPool.getPlayer(i)->prepareToPlay(samplesPerBlockExpected, sampleRate);
+        rendered[i] = false;
+    }
+}
+
+/******************************************
+* Name:
+*  getNextAudioBlock
+* Description:
+*  override of the base class getNextAudioBlock method. Reads the
+*  set of active players from the pool without locking and sums
+*  only the players that are playing (or have just stopped, so the
+*  transport can fade out) into the output buffer.
+* Parameters:
+*  bufferToFill: a descriptor representing the read and write audio buffers.
+* Output:
+*  N/A
+*******************************************/
+void ActiveMixerSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) {
+    // snapshot of the players currently taken from the pool
+    auto active = playerPool.getActivePlayers();
+    auto first = true;
+
+    for (auto i = 0; i < PlayerPool::N; ++i) {
+        auto* player = playerPool.getPlayer(i);
+        auto isActive = (active & (1u << i)) != 0;
+        auto isPlaying = isActive && player->isPlaying();
+
+        // skip idle players, but render one more block after a player stops
+        // so the transport source can fade out without a click
+        if (!isPlaying && !rendered[i]) {
+            continue;
+        }
+        rendered[i] = isPlaying;
+
+        // first player renders straight into the output buffer
+        if (first) {
+            player->getNextAudioBlock(bufferToFill);
+            first = false;
+        }
+        // other players render into the scratch buffer and are summed in
+        else {
+            auto nChannels = bufferToFill.buffer->getNumChannels();
+            tempBuffer.setSize(jmax(1, nChannels), bufferToFill.numSamples, false, false, true);
+            AudioSourceChannelInfo info(&tempBuffer, 0, bufferToFill.numSamples);
+            player->getNextAudioBlock(info);
+
+            for (auto ch = 0; ch < nChannels; ++ch) {
+                bufferToFill.buffer->addFrom(ch, bufferToFill.startSample, tempBuffer, ch, 0,
+                    bufferToFill.numSamples);
+            }
+        }
+    }
+
+    // no players rendered, output silence
+    if (first) {
+        bufferToFill.clearActiveBufferRegion();
+    }
+}
+
+/******************************************
+* Name:
+*  releaseResources
+* Description:
+*  override of the base class releaseResources method. Releases
+*  the scratch buffer and cleans up every player in the pool.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void ActiveMixerSource::releaseResources() {
+    // clean up all players
+    for (auto i = 0; i < playerPool.size(); ++i) {
+        playerPool.getPlayer(i)->releaseResources();
+    }
+    tempBuffer.setSize(2, 0);
+}
\ No newline at end of file
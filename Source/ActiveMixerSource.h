@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    ActiveMixerSource.h
+    Created: 17 Oct 2026 9:12:40pm
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+using namespace juce;
+
+#include "PlayerPool.h"
+
+class ActiveMixerSource : public AudioSource {
+public:
+    // constructors & destructors
+    /******************************************
+    * Name:
+    *  ActiveMixerSource
+    * Description:
+    *  constructor of the ActiveMixerSource class. Mixes only
+    *  the DJAudioPlayers of the pool that are currently in use,
+    *  instead of every player in the pool.
+    * Parameters:
+    *  playerPool: reference to global PlayerPool
+    * Output:
+    *  N/A
+    *******************************************/
+    ActiveMixerSource(PlayerPool& playerPool);
+
+    // base class overrides
+    /******************************************
+    * Name:
+    *  prepareToPlay
+    * Description:
+    *  override of the base class prepareToPlay method. Prepares
+    *  every player in the pool up front, so a player can start being
+    *  mixed the moment it is taken from the pool, and allocates the
+    *  scratch buffer used for mixing.
+    * Parameters:
+    *  samplesPerBlockExpected: no. of samples to return on each getNextAudioBlock call
+    *  sampleRate: audio sampling rate
+    * Output:
+    *  N/A
+    *******************************************/
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /******************************************
+    * Name:
+    *  getNextAudioBlock
+    * Description:
+    *  override of the base class getNextAudioBlock method. Reads the
+    *  set of active players from the pool without locking and sums
+    *  only the players that are playing (or have just stopped, so the
+    *  transport can fade out) into the output buffer.
+    * Parameters:
+    *  bufferToFill: a descriptor representing the read and write audio buffers.
+    * Output:
+    *  N/A
+    *******************************************/
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    /******************************************
+    * Name:
+    *  releaseResources
+    * Description:
+    *  override of the base class releaseResources method. Releases
+    *  the scratch buffer and cleans up every player in the pool.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void releaseResources() override;
+
+private:
+    // functionality members
+    PlayerPool& playerPool; // reference to global PlayerPool
+    AudioBuffer<float> tempBuffer;  // scratch buffer for rendering the 2nd, 3rd.. players
+    bool rendered[PlayerPool::N];   // if a player was rendered in the last block (audio thread only)
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ActiveMixerSource)
+};
\ No newline at end of file
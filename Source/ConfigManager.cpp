@@ -12,6 +12,10 @@
 
 // config file relative path
 const String ConfigManager::PATH_CONFIG = "config.json";
+// library database file relative path
+const String ConfigManager::PATH_LIBRARY = "library.db";
+// waveform peak files folder relative path
+const String ConfigManager::PATH_WAVEFORMS = "waveforms";
 
 /******************************************
 * Name:
@@ -25,11 +29,8 @@ const String ConfigManager::PATH_CONFIG = "config.json";
 *  N/A
 *******************************************/
 void ConfigManager::save(const var& config) {
-    // construct full path
-    auto path = File::getCurrentWorkingDirectory().getFullPathName() + File::getSeparatorChar() + PATH_CONFIG;
-
     // open file
-    File f(path);
+    auto f = getFile(PATH_CONFIG);
 
     // write to file
     f.replaceWithText(JSON::toString(config));
@@ -47,11 +48,8 @@ void ConfigManager::save(const var& config) {
 *  JSON formatted config to initialize track list from
 *******************************************/
 const var ConfigManager::load() {
-    // construct full path
-    auto path = File::getCurrentWorkingDirectory().getFullPathName() + File::getSeparatorChar() + PATH_CONFIG;
-
     // open file
-    File f(path);
+    auto f = getFile(PATH_CONFIG);
 
     if (!f.exists()) {
         return false;
@@ -63,3 +61,21 @@ const var ConfigManager::load() {
 
     return config;
 }
+
+/******************************************
+* Name:
+*  getFile
+* Description:
+*  function used to locate a file saved by the program,
+*  relative to the current working directory.
+* Parameters:
+*  relativePath: path of the file relative to the working directory
+* Output:
+*  the file at the given path
+*******************************************/
+File ConfigManager::getFile(const String& relativePath) {
+    // construct full path
+    auto path = File::getCurrentWorkingDirectory().getFullPathName() + File::getSeparatorChar() + relativePath;
+
+    return File(path);
+}
\ No newline at end of file
@@ -16,6 +16,8 @@ class ConfigManager {
 public:
     // public constants
     static const String PATH_CONFIG;    // config file relative path
+    static const String PATH_LIBRARY;   // library database file relative path
+    static const String PATH_WAVEFORMS; // waveform peak files folder relative path
 
     // methods
     /******************************************
@@ -44,4 +46,17 @@ public:
     *******************************************/
     static const var load();
 
+    /******************************************
+    * Name:
+    *  getFile
+    * Description:
+    *  function used to locate a file saved by the program,
+    *  relative to the current working directory.
+    * Parameters:
+    *  relativePath: path of the file relative to the working directory
+    * Output:
+    *  the file at the given path
+    *******************************************/
+    static File getFile(const String& relativePath);
+
 };
\ No newline at end of file
@@ -16,24 +16,29 @@
 *  DJAudioPlayer
 * Description:
 *  constructor of the DJAudioPlayer class. Set sampleRate
-*  to default setting so the LPF and HPF audio sources can be
-*  initialized.
+*  to default setting until the player is prepared.
 * Parameters:
 *  _formatManager: reference to global AudioFormatManager
+*  _readAheadThread: reference to shared thread used to decode ahead
 *  _id: ID of the associated track
 * Output:
 *  N/A
 *******************************************/
-DJAudioPlayer::DJAudioPlayer(AudioFormatManager& _formatManager, int _id):
+DJAudioPlayer::DJAudioPlayer(AudioFormatManager& _formatManager, 
+    TimeSliceThread& _readAheadThread, int _id):
     formatManager(_formatManager), 
+    readAheadThread(_readAheadThread),
     id(_id), 
     sampleRate(DEFAULT_SAMPLE_RATE),
     frequencyDisplay(nullptr),
-    speed(DEFAULT_SPEED)
+    speed(DEFAULT_SPEED),
+    keyLock(false)
 {
-    // initialize the LPF and HPF audio sources by setting their cutoff frequencies.
-    lpfSource.setCoefficients(IIRCoefficients::makeLowPass(sampleRate, MAX_CUTOFF_FREQUENCY));
-    hpfSource.setCoefficients(IIRCoefficients::makeHighPass(sampleRate, MIN_CUTOFF_FREQUENCY));
+    // EQ starts flat
+    for (auto b = 0; b < FilterAudioSource::numBands; ++b) {
+        eqGains[b] = DEFAULT_EQ_GAIN;
+        eqKills[b] = false;
+    }
 }
 
 /******************************************
@@ -57,9 +62,9 @@ DJAudioPlayer::~DJAudioPlayer() {
 *  prepareToPlay
 * Description:
 *  override of the base class prepareToPlay method. Prepares
-*  the various linked audio sources in the player, transport, resampling,
-*  LPF and HPF sources. Stores the passed sampleRate to use for later
-*  changes to the bandwidth in the filters.
+*  the various linked audio sources in the player, transport, time-stretching,
+*  resampling and filter sources. Stores the passed sampleRate to pass on to
+*  the frequency display.
 * Parameters:
 *  samplesPerBlockExpected: no. of samples to return on each getNextAudioBlock call
 *  sampleRate: audio sampling rate
@@ -69,11 +74,11 @@ DJAudioPlayer::~DJAudioPlayer() {
 void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
     // initialize all sub audio sources
     transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    stretchSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
     resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    lpfSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    hpfSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    filterSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
 
-    // keep a copy of the sampling rate to use for HPF, LPF audio source changes later
+    // keep a copy of the sampling rate to pass on to the frequency display
     this->sampleRate = sampleRate;
 }
 
@@ -82,7 +87,7 @@ void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate
 *  getNextAudioBlock
 * Description:
 *  overide of the base class's getNextAudioBlock metod. Only need to pass the
-*  call to the last audio source in the processing chain, that is the HPF audio source.
+*  call to the last audio source in the processing chain, that is the filter audio source.
 *  Also, if there's an associated frequency display, push the processing completed samples
 *  to it, so it can perform FFT on it.
 * Parameters:
@@ -92,14 +97,13 @@ void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate
 *******************************************/
 void DJAudioPlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) {
     // start the audio source chain processing by calling the last in the chain
-    hpfSource.getNextAudioBlock(bufferToFill);
+    filterSource.getNextAudioBlock(bufferToFill);
 
-    // if associated with a frequency display, pass samples to it, so it can perform FFT
-    if (frequencyDisplay != nullptr && bufferToFill.buffer->getNumChannels() > 0) {
+    // if associated with a frequency display, write the block to the analysis fifo in one
+    // go, the display reads it on its own thread so it can perform FFT
+    if (analysing.load() && bufferToFill.buffer->getNumChannels() > 0) {
         auto* channelData = bufferToFill.buffer->getReadPointer(0, bufferToFill.startSample);
-        for (auto i = 0; i < bufferToFill.numSamples; ++i) {
-            frequencyDisplay->pushNextSample(channelData[i]);
-        }
+        analysisFifo.push(channelData, bufferToFill.numSamples);
     }
 }
 
@@ -108,8 +112,8 @@ void DJAudioPlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& buffer
 *  releaseResources
 * Description:
 *  override of the base class releaseResources method. Used to clean up on termination
-*  and thus calls the relevant methods of the transport, resampling, LPF and HPF audio
-*  sources.
+*  and thus calls the relevant methods of the transport, time-stretching, resampling
+*  and filter audio sources.
 * Parameters:
 *  N/A
 * Output:
@@ -118,17 +122,17 @@ void DJAudioPlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& buffer
 void DJAudioPlayer::releaseResources() {
     // clean up for all sub audio sources
     transportSource.releaseResources();
+    stretchSource.releaseResources();
     resampleSource.releaseResources();
-    lpfSource.releaseResources();
-    hpfSource.releaseResources();
+    filterSource.releaseResources();
 }
 
 /******************************************
 * Name:
 *  setCutoffFrequency
 * Description:
-*  setter for the bandwidth lower and upper limits. Updates the
-*  LPF and HPF audio sources, by creating new coefficients.
+*  setter for the bandwidth lower and upper limits. Passes them
+*  on to the filter audio source, which glides to them.
 * Parameters:
 *  fLow - lower bandwidth limit
 *  fHigh - higher bandwidth limit
@@ -141,26 +145,107 @@ void DJAudioPlayer::setCutoffFrequency(double fLow, double fHigh) {
         DBG("DJAudioPlayer::setCutoffFrequency: cutoff frequency must be between " <<
             MIN_CUTOFF_FREQUENCY << " and " << MAX_CUTOFF_FREQUENCY << newLine);
     }
-    // otherwise, update HPF, LPF filter coefficients
+    // otherwise, update the target cutoff frequencies, the coefficients follow on the audio thread
+    else {
+        filterSource.setCutoffFrequencies(fLow, fHigh);
+    }
+}
+
+/******************************************
+* Name:
+*  setFilterSlope
+* Description:
+*  setter for the slope of the bandwidth filters.
+* Parameters:
+*  slope: 12, 24 or 48 dB/oct
+* Output:
+*  N/A
+*******************************************/
+void DJAudioPlayer::setFilterSlope(FilterAudioSource::Slope slope) {
+    filterSource.setSlope(slope);
+}
+
+/******************************************
+* Name:
+*  setEqGain
+* Description:
+*  setter for the gain of an EQ band.
+* Parameters:
+*  band: low, mid or high
+*  gainDb: gain of the band in dB (MIN_EQ_GAIN-MAX_EQ_GAIN)
+* Output:
+*  N/A
+*******************************************/
+void DJAudioPlayer::setEqGain(FilterAudioSource::Band band, double gainDb) {
+    // range check, on fail, print error to debug
+    if (gainDb < MIN_EQ_GAIN || gainDb > MAX_EQ_GAIN) {
+        DBG("DJAudioPlayer::setEqGain: gain should be between " << MIN_EQ_GAIN <<
+            " and " << MAX_EQ_GAIN << newLine);
+    }
+    // otherwise update the band's gain
     else {
-        lpfSource.setCoefficients(IIRCoefficients::makeLowPass(sampleRate, fHigh));
-        hpfSource.setCoefficients(IIRCoefficients::makeHighPass(sampleRate, fLow));
+        eqGains[band] = gainDb;
+        updateEqGain(band);
     }
 }
 
+/******************************************
+* Name:
+*  setEqKill
+* Description:
+*  setter for the kill switch of an EQ band. A killed band
+*  is silenced, its gain is kept for when it is restored.
+* Parameters:
+*  band: low, mid or high
+*  isKilled: true to silence the band
+* Output:
+*  N/A
+*******************************************/
+void DJAudioPlayer::setEqKill(FilterAudioSource::Band band, bool isKilled) {
+    eqKills[band] = isKilled;
+    updateEqGain(band);
+}
+
+/******************************************
+* Name:
+*  updateEqGain
+* Description:
+*  passes the gain of an EQ band on to the filter audio source,
+*  silenced if the band is killed.
+* Parameters:
+*  band: low, mid or high
+* Output:
+*  N/A
+*******************************************/
+void DJAudioPlayer::updateEqGain(FilterAudioSource::Band band) {
+    auto gain = eqKills[band] ? 0.0f : Decibels::decibelsToGain((float)eqGains[band]);
+    filterSource.setBandGain(band, gain);
+}
+
 /******************************************
 * Name:
 *  setFrequencyDisplay
 * Description:
-*  setter for setting up associated frequency display.
+*  setter for setting up associated frequency display. The
+*  display reads the player's output from the analysis fifo,
+*  the audio thread never calls into the display.
 * Parameters:
 *  frequencyDisplay: pointer to frequency display to associate with.
 * Output:
 *  N/A
 *******************************************/
 void DJAudioPlayer::setFrequencyDisplay(FrequencyDisplay* _frequencyDisplay) {
+    // detach previous frequency display
+    if (frequencyDisplay != nullptr) {
+        frequencyDisplay->setSampleFifo(nullptr, sampleRate);
+    }
+
     // associate with passed frequency display
     frequencyDisplay = _frequencyDisplay;
+    if (frequencyDisplay != nullptr) {
+        frequencyDisplay->setSampleFifo(&analysisFifo, sampleRate);
+    }
+    analysing.store(frequencyDisplay != nullptr);
 }
 
 /******************************************
@@ -204,6 +289,8 @@ void DJAudioPlayer::setPosition(double posInSecs) {
     // otherwise, update playback position
     else {
         transportSource.setPosition(posInSecs);
+        // drop audio buffered for stretching from the old position
+        stretchSource.reset();
     }
 }
 
@@ -234,8 +321,9 @@ void DJAudioPlayer::setPositionRelative(double pos) {
 * Name:
 *  setSpeed
 * Description:
-*  setter for playback speed. Sets the playback speed by passing
-*  the speed ratio on the resampling audio source.
+*  setter for playback speed. With key lock on, the speed ratio
+*  is passed on to the time-stretching audio source so the pitch
+*  is kept, otherwise to the resampling audio source.
 * Parameters:
 *  ratio: playback speed ratio
 * Output:
@@ -250,10 +338,44 @@ void DJAudioPlayer::setSpeed(double ratio) {
     // otherwise set playback speed
     else {
         speed = ratio;
-        resampleSource.setResamplingRatio(ratio);
+        stretchSource.setRatio(ratio);
+        resampleSource.setRatio(keyLock ? 1.0 : ratio);
     }
 }
 
+/******************************************
+* Name:
+*  setKeyLock
+* Description:
+*  setter for key lock. With key lock on, changing the playback
+*  speed changes the tempo but not the pitch.
+* Parameters:
+*  isLocked: true to keep the pitch, false to resample
+* Output:
+*  N/A
+*******************************************/
+void DJAudioPlayer::setKeyLock(bool isLocked) {
+    keyLock = isLocked;
+    // either stretch or resample by the playback speed, never both
+    stretchSource.setEnabled(keyLock);
+    resampleSource.setRatio(keyLock ? 1.0 : speed);
+}
+
+/******************************************
+* Name:
+*  setResamplerQuality
+* Description:
+*  setter for the interpolation used when resampling to
+*  the playback speed.
+* Parameters:
+*  quality: linear, cubic or sinc
+* Output:
+*  N/A
+*******************************************/
+void DJAudioPlayer::setResamplerQuality(ResamplerAudioSource::Quality quality) {
+    resampleSource.setQuality(quality);
+}
+
 /******************************************
 * Name:
 *  getDuration
@@ -305,30 +427,94 @@ double DJAudioPlayer::getPositionRelative() {
     return pos / total;
 }
 
+/******************************************
+* Name:
+*  isPlaying
+* Description:
+*  getter for the playback state of the transport source.
+*  Used by the mixer to skip players that are not playing.
+* Parameters:
+*  N/A
+* Output:
+*  true if the player is currently playing
+*******************************************/
+bool DJAudioPlayer::isPlaying() {
+    return transportSource.isPlaying();
+}
+
+/******************************************
+* Name:
+*  getUnderrunCount
+* Description:
+*  getter for the no. of audio blocks of the current track
+*  that the read-ahead buffer could not serve in time.
+* Parameters:
+*  N/A
+* Output:
+*  no. of read-ahead underruns of the current track
+*******************************************/
+int DJAudioPlayer::getUnderrunCount() {
+    return (readerSource != nullptr ? readerSource->getUnderrunCount() : 0);
+}
+
 /******************************************
 * Name:
 *  loadURL
 * Description:
 *  loads the track from the specified path by creating a
 *  reader using the format manager, which is then bind to a
-*  AudioFormatReaderSource and used as input to the transport source.
+*  ReadAheadAudioSource and used as input to the transport source.
 * Parameters:
 *  audioURL: full path of the audio track in URL format
 * Output:
 *  N/A
 *******************************************/
 void DJAudioPlayer::loadURL(URL audioURL) {
+    // open the file and attach it straight away
+    setSource(createSource(audioURL));
+}
+
+/******************************************
+* Name:
+*  createSource
+* Description:
+*  opens the track at the specified path and wraps it in a
+*  ReadAheadAudioSource, without attaching it to the transport
+*  source. Safe to call from a background thread.
+* Parameters:
+*  audioURL: full path of the audio track in URL format
+* Output:
+*  new read-ahead source, nullptr if the file could not be opened
+*******************************************/
+std::unique_ptr<ReadAheadAudioSource> DJAudioPlayer::createSource(URL audioURL) {
     // create reader using format manager
     auto* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
-    
-    // if successfulc reation, pass into reader source and add as input to transport source.
-    if (reader != nullptr) {    // good file!
-        std::unique_ptr<AudioFormatReaderSource> newSource(
-            new AudioFormatReaderSource(reader, true));
-        transportSource.setSource(newSource.get(), 0, nullptr, reader->sampleRate);
-        readerSource.reset(newSource.release());
+
+    // if successful creation, pass into read-ahead source, decoding happens
+    // on the shared read-ahead thread, the audio thread only copies.
+    if (reader == nullptr) {
+        DBG("DJAudioPlayer::createSource: unable to open " << audioURL.toString(false));
+        return nullptr;
     }
+    return std::make_unique<ReadAheadAudioSource>(reader, readAheadThread, SIZE_READ_AHEAD);
+}
 
+/******************************************
+* Name:
+*  setSource
+* Description:
+*  attaches a source created by createSource as input to the
+*  transport source, replacing the current one.
+* Parameters:
+*  newSource: source to play, ignored if nullptr
+* Output:
+*  N/A
+*******************************************/
+void DJAudioPlayer::setSource(std::unique_ptr<ReadAheadAudioSource> newSource) {
+    if (newSource != nullptr) {    // good file!
+        transportSource.setSource(newSource.get(), 0, nullptr, newSource->getSampleRate());
+        readerSource.reset(newSource.release());
+    }
 }
 
 /******************************************
@@ -365,7 +551,8 @@ void DJAudioPlayer::stop() {
 * Name:
 *  rewind
 * Description:
-*  Used to stop and rewind to start using the transport source.
+*  Used to stop and rewind to start, through setPosition so the
+*  audio buffered for stretching is dropped as well.
 * Parameters:
 *  N/A
 * Output:
@@ -373,7 +560,7 @@ void DJAudioPlayer::stop() {
 *******************************************/
 void DJAudioPlayer::rewind() {
     transportSource.stop();
-    transportSource.setPosition(0);
+    setPosition(0);
 }
 
 /******************************************
@@ -418,4 +605,9 @@ const double DJAudioPlayer::DEFAULT_SPEED = 1.0;
 
 const double DJAudioPlayer::MIN_CUTOFF_FREQUENCY = 20;
 const double DJAudioPlayer::MAX_CUTOFF_FREQUENCY = 20000;
-const double DJAudioPlayer::INTERVAL_CUTOFF_FREQUENCY=1;
\ No newline at end of file
+const double DJAudioPlayer::INTERVAL_CUTOFF_FREQUENCY=1;
+
+const double DJAudioPlayer::MIN_EQ_GAIN = -24.0;
+const double DJAudioPlayer::MAX_EQ_GAIN = 6.0;
+const double DJAudioPlayer::INTERVAL_EQ_GAIN = 0.5;
+const double DJAudioPlayer::DEFAULT_EQ_GAIN = 0.0;
\ No newline at end of file
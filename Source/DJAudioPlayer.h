@@ -14,6 +14,11 @@
 using namespace juce;
 
 #include "FrequencyDisplay.h"
+#include "SampleFifo.h"
+#include "ReadAheadAudioSource.h"
+#include "TimeStretchAudioSource.h"
+#include "ResamplerAudioSource.h"
+#include "FilterAudioSource.h"
 
 class DJAudioPlayer: public AudioSource {
 public:
@@ -23,15 +28,15 @@ public:
     *  DJAudioPlayer
     * Description:
     *  constructor of the DJAudioPlayer class. Set sampleRate
-    *  to default setting so the LPF and HPF audio sources can be  
-    *  initialized.
+    *  to default setting until the player is prepared.
     * Parameters:
     *  _formatManager: reference to global AudioFormatManager
+    *  _readAheadThread: reference to shared thread used to decode ahead
     *  _id: ID of this player
     * Output:
     *  N/A
     *******************************************/
-    DJAudioPlayer(AudioFormatManager& _formatManager, int id);
+    DJAudioPlayer(AudioFormatManager& _formatManager, TimeSliceThread& _readAheadThread, int id);
 
     /******************************************
     * Name:
@@ -52,9 +57,9 @@ public:
     *  prepareToPlay
     * Description:
     *  override of the base class prepareToPlay method. Prepares
-    *  the various linked audio sources in the player, transport, resampling,
-    *  LPF and HPF sources. Stores the passed sampleRate to use for later
-    *  changes to the bandwidth in the filters.
+    *  the various linked audio sources in the player, transport, time-stretching,
+    *  resampling and filter sources. Stores the passed sampleRate to pass on to
+    *  the frequency display.
     * Parameters:
     *  samplesPerBlockExpected: no. of samples to return on each getNextAudioBlock call
     *  sampleRate: audio sampling rate
@@ -68,7 +73,7 @@ public:
     *  getNextAudioBlock
     * Description:
     *  overide of the base class's getNextAudioBlock metod. Only need to pass the 
-    *  call to the last audio source in the processing chain, that is the HPF audio source.
+    *  call to the last audio source in the processing chain, that is the filter audio source.
     *  Also, if there's an associated frequency display, push the processing completed samples
     *  to it, so it can perform FFT on it.
     * Parameters:
@@ -83,8 +88,8 @@ public:
     *  releaseResources
     * Description:
     *  override of the base class releaseResources method. Used to clean up on termination
-    *  and thus calls the relevant methods of the transport, resampling, LPF and HPF audio
-    *  sources.
+    *  and thus calls the relevant methods of the transport, time-stretching, resampling
+    *  and filter audio sources.
     * Parameters:
     *  N/A
     * Output:
@@ -97,8 +102,8 @@ public:
     * Name:
     *  setCutoffFrequency
     * Description:
-    *  setter for the bandwidth lower and upper limits. Updates the
-    *  LPF and HPF audio sources, by creating new coefficients.
+    *  setter for the bandwidth lower and upper limits. Passes them
+    *  on to the filter audio source, which glides to them.
     * Parameters:
     *  fLow - lower bandwidth limit
     *  fHigh - higher bandwidth limit
@@ -107,11 +112,52 @@ public:
     *******************************************/
     void setCutoffFrequency(double fLow, double fHigh);
 
+    /******************************************
+    * Name:
+    *  setFilterSlope
+    * Description:
+    *  setter for the slope of the bandwidth filters.
+    * Parameters:
+    *  slope: 12, 24 or 48 dB/oct
+    * Output:
+    *  N/A
+    *******************************************/
+    void setFilterSlope(FilterAudioSource::Slope slope);
+
+    /******************************************
+    * Name:
+    *  setEqGain
+    * Description:
+    *  setter for the gain of an EQ band.
+    * Parameters:
+    *  band: low, mid or high
+    *  gainDb: gain of the band in dB (MIN_EQ_GAIN-MAX_EQ_GAIN)
+    * Output:
+    *  N/A
+    *******************************************/
+    void setEqGain(FilterAudioSource::Band band, double gainDb);
+
+    /******************************************
+    * Name:
+    *  setEqKill
+    * Description:
+    *  setter for the kill switch of an EQ band. A killed band
+    *  is silenced, its gain is kept for when it is restored.
+    * Parameters:
+    *  band: low, mid or high
+    *  isKilled: true to silence the band
+    * Output:
+    *  N/A
+    *******************************************/
+    void setEqKill(FilterAudioSource::Band band, bool isKilled);
+
     /******************************************
     * Name:
     *  setFrequencyDisplay
     * Description:
-    *  setter for setting up associated frequency display.
+    *  setter for setting up associated frequency display. The
+    *  display reads the player's output from the analysis fifo,
+    *  the audio thread never calls into the display.
     * Parameters:
     *  frequencyDisplay: pointer to frequency display to associate with.
     * Output:
@@ -162,8 +208,9 @@ public:
     * Name:
     *  setSpeed
     * Description:
-    *  setter for playback speed. Sets the playback speed by passing
-    *  the speed ratio on the resampling audio source.
+    *  setter for playback speed. With key lock on, the speed ratio
+    *  is passed on to the time-stretching audio source so the pitch
+    *  is kept, otherwise to the resampling audio source.
     * Parameters:
     *  ratio: playback speed ratio
     * Output:
@@ -171,6 +218,32 @@ public:
     *******************************************/
     void setSpeed(double ratio);
 
+    /******************************************
+    * Name:
+    *  setKeyLock
+    * Description:
+    *  setter for key lock. With key lock on, changing the playback
+    *  speed changes the tempo but not the pitch.
+    * Parameters:
+    *  isLocked: true to keep the pitch, false to resample
+    * Output:
+    *  N/A
+    *******************************************/
+    void setKeyLock(bool isLocked);
+
+    /******************************************
+    * Name:
+    *  setResamplerQuality
+    * Description:
+    *  setter for the interpolation used when resampling to
+    *  the playback speed.
+    * Parameters:
+    *  quality: linear, cubic or sinc
+    * Output:
+    *  N/A
+    *******************************************/
+    void setResamplerQuality(ResamplerAudioSource::Quality quality);
+
     /******************************************
     * Name:
     *  getDuration
@@ -208,6 +281,32 @@ public:
     *******************************************/
     double getPositionRelative();
 
+    /******************************************
+    * Name:
+    *  isPlaying
+    * Description:
+    *  getter for the playback state of the transport source.
+    *  Used by the mixer to skip players that are not playing.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  true if the player is currently playing
+    *******************************************/
+    bool isPlaying();
+
+    /******************************************
+    * Name:
+    *  getUnderrunCount
+    * Description:
+    *  getter for the no. of audio blocks of the current track
+    *  that the read-ahead buffer could not serve in time.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  no. of read-ahead underruns of the current track
+    *******************************************/
+    int getUnderrunCount();
+
     // methods
     /******************************************
     * Name:
@@ -215,7 +314,7 @@ public:
     * Description:
     *  loads the track from the specified path by creating a 
     *  reader using the format manager, which is then bind to a 
-    *  AudioFormatReaderSource and used as input to the transport source.
+    *  ReadAheadAudioSource and used as input to the transport source.
     * Parameters:
     *  audioURL: full path of the audio track in URL format
     * Output:
@@ -223,6 +322,33 @@ public:
     *******************************************/
     void loadURL(URL audioURL);
 
+    /******************************************
+    * Name:
+    *  createSource
+    * Description:
+    *  opens the track at the specified path and wraps it in a 
+    *  ReadAheadAudioSource, without attaching it to the transport 
+    *  source. Safe to call from a background thread.
+    * Parameters:
+    *  audioURL: full path of the audio track in URL format
+    * Output:
+    *  new read-ahead source, nullptr if the file could not be opened
+    *******************************************/
+    std::unique_ptr<ReadAheadAudioSource> createSource(URL audioURL);
+
+    /******************************************
+    * Name:
+    *  setSource
+    * Description:
+    *  attaches a source created by createSource as input to the
+    *  transport source, replacing the current one.
+    * Parameters:
+    *  newSource: source to play, ignored if nullptr
+    * Output:
+    *  N/A
+    *******************************************/
+    void setSource(std::unique_ptr<ReadAheadAudioSource> newSource);
+
     /******************************************
     * Name:
     *  start
@@ -251,7 +377,8 @@ public:
     * Name:
     *  rewind
     * Description:
-    *  Used to stop and rewind to start using the transport source.
+    *  Used to stop and rewind to start, through setPosition so the
+    *  audio buffered for stretching is dropped as well.
     * Parameters:
     *  N/A
     * Output:
@@ -297,20 +424,47 @@ public:
     static const double MIN_CUTOFF_FREQUENCY;   // lower limit of bandwidth range
     static const double MAX_CUTOFF_FREQUENCY;   // upper limit of bandwidth range
     static const double INTERVAL_CUTOFF_FREQUENCY;  // step/ interval for bandwidth change
+    static const double MIN_EQ_GAIN;    // lower limit of EQ band gain in dB
+    static const double MAX_EQ_GAIN;    // upper limit of EQ band gain in dB
+    static const double INTERVAL_EQ_GAIN;   // step/ interval for EQ band gain change
+    static const double DEFAULT_EQ_GAIN;    // initial EQ band gain
     static const int DEFAULT_SAMPLE_RATE = 44100;   // default sampling rate
+    static const int SIZE_READ_AHEAD = 1 << 15; // no. of samples to decode ahead of the playback position
+    static const int SIZE_ANALYSIS_FIFO = 1 << 15;  // no. of output samples buffered for analysis
 
 
 private:
+    // methods
+    /******************************************
+    * Name:
+    *  updateEqGain
+    * Description:
+    *  passes the gain of an EQ band on to the filter audio source,
+    *  silenced if the band is killed.
+    * Parameters:
+    *  band: low, mid or high
+    * Output:
+    *  N/A
+    *******************************************/
+    void updateEqGain(FilterAudioSource::Band band);
+
     // functionality members
     int id; // id of this player
     AudioFormatManager& formatManager;  // reference to global AudioFormatManager
-    std::unique_ptr<AudioFormatReaderSource> readerSource;  // reader audio source
+    TimeSliceThread& readAheadThread;   // reference to shared thread used to decode ahead
+    std::unique_ptr<ReadAheadAudioSource> readerSource;  // read-ahead reader audio source
     AudioTransportSource transportSource;   // transport audio source
-    ResamplingAudioSource resampleSource{ &transportSource, false, 2 }; // resampling audio source
-    IIRFilterAudioSource lpfSource{ &resampleSource, false };   // LPF audio source
-    IIRFilterAudioSource hpfSource{ &lpfSource, false };    // HPF audio source
-    double sampleRate;  // copy of sampling rate for setting filter coefficinets
+    TimeStretchAudioSource stretchSource{ &transportSource };   // key lock time-stretching audio source
+    ResamplerAudioSource resampleSource{ &stretchSource };   // resampling audio source
+    FilterAudioSource filterSource{ &resampleSource, MIN_CUTOFF_FREQUENCY,
+        MAX_CUTOFF_FREQUENCY };    // HPF and LPF audio source
+    double sampleRate;  // copy of sampling rate for the frequency display
     double speed; // playback speed
+    bool keyLock;   // if speed changes keep the pitch
+    double eqGains[FilterAudioSource::numBands];    // gain per EQ band in dB
+    bool eqKills[FilterAudioSource::numBands];  // kill switch per EQ band
+    SampleFifo analysisFifo{ SIZE_ANALYSIS_FIFO };  // output samples for the frequency display
+    std::atomic<bool> analysing{ false };   // if output samples are written to the analysis fifo
 
     // GUI members
     FrequencyDisplay* frequencyDisplay; // pointer to associated frequency display
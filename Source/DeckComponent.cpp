@@ -19,18 +19,20 @@
 *  Constructor for the DeckComponent class. Setup members and viewport to enable
 *  scrolling features.
 * Parameters:
-*  _formatManager: reference to global AudioFormatManager required to create new
-*   DeckPlayerComponents
-*  cache: reference to global AudioThumbnailCache required to draw waveform
+*  cache: reference to global WaveformCache required to draw waveform
 *  tracklist: reference to global TrackCollection representing all loaded tracks
-*  playerPool: reference to global PlayerPool to get DJAudioPlayer instances for use    *
+*  playerPool: reference to global PlayerPool to get DJAudioPlayer instances for use
+*  trackLoader: reference to global TrackLoader used to load tracks in the background
+*  analysisThread: reference to shared thread the decks' FFTs run on
+*  renderer: reference to global WaveformRenderer, drawing the displays on the GPU if enabled
 * Output:
 *  N/A
 *******************************************/
-DeckComponent::DeckComponent( AudioFormatManager& _formatManager, 
-    AudioThumbnailCache& _cache, TrackCollection& _tracklist, PlayerPool& _playerPool):
-    displayArea(this), tracklist(_tracklist), formatManager(_formatManager), 
-    cache(_cache), playerPool{_playerPool}
+DeckComponent::DeckComponent(WaveformCache& _cache, TrackCollection& _tracklist,
+    PlayerPool& _playerPool, TrackLoader& _trackLoader, TimeSliceThread& _analysisThread,
+    WaveformRenderer& _renderer):
+    displayArea(this), cache(_cache), tracklist(_tracklist), playerPool{_playerPool}, trackLoader(_trackLoader),
+    analysisThread(_analysisThread), renderer(_renderer)
 {
     // add internal class instance to viewport and add it to this DeckComponent
     viewport.setViewedComponent(&displayArea, false);
@@ -118,15 +120,40 @@ void DeckComponent::changeListenerCallback(ChangeBroadcaster* src) {
     displayArea.removeChildComponent(deckPlayer);
     deckPlayers.removeObject(deckPlayer, true);
 
+    // nothing left to refresh
+    if (deckPlayers.isEmpty()) {
+        stopTimer();
+    }
+
     // call resized to update display
     resized();
 }
 
+/******************************************
+* Name:
+*  timerCallback
+* Description:
+*  implementation of the virtual timerCallback method. The
+*  single refresh timer for all decks: refreshes every
+*  DeckPlayerComponent once per frame, in the same callback.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void DeckComponent::timerCallback() {
+    for (auto player : deckPlayers) {
+        player->refresh();
+    }
+}
+
 /******************************************
 * Name:
 *  loadPlayer
 * Description:
-*  Create new DeckPlayerComponent and load it.
+*  Create new DeckPlayerComponent and queue its track to be
+*  loaded in the background. The DeckPlayerComponent shows a
+*  loading state until the track is ready.
 * Parameters:
 *  id - ID of track to load.
 * Output:
@@ -154,7 +181,7 @@ void DeckComponent::loadPlayer(int id) {
         track->load(audioPlayer);
 
         // create new DeckPlayerComponent
-        auto player = new DeckPlayerComponent(track, formatManager, cache);
+        auto player = new DeckPlayerComponent(track, cache, analysisThread, renderer);
 
         // add DeckComponent as listener to new DeckPlayerComponent
         player->addChangeListener(this);
@@ -163,6 +190,20 @@ void DeckComponent::loadPlayer(int id) {
         deckPlayers.add(player);
         displayArea.addAndMakeVisible(player);
 
+        // refresh all decks from a single timer, started with the first deck
+        if (!isTimerRunning()) {
+            startTimerHz(REFRESH_FREQUENCY);
+        }
+
+        // load audio in the background, the deck player may be closed before it is done
+        Component::SafePointer<DeckPlayerComponent> safePlayer(player);
+        trackLoader.loadAsync(audioPlayer, track->getFullPath(),
+            [safePlayer](std::shared_ptr<TrackLoader::LoadedTrack> loaded) {
+                if (safePlayer != nullptr) {
+                    safePlayer->trackLoaded(*loaded);
+                }
+            });
+
         // call resized to refresh display
         resized();
     }
@@ -16,13 +16,15 @@ using namespace juce;
 #include "DeckPlayerComponent.h"
 #include "TrackCollection.h"
 #include "PlayerPool.h"
+#include "TrackLoader.h"
 
 //==============================================================================
 /*
 */
 class DeckComponent  : public Component,
     public DragAndDropTarget,
-    public ChangeListener
+    public ChangeListener,
+    public Timer
 {
 public:
     // constructors & destructors
@@ -33,16 +35,17 @@ public:
     *  Constructor for the DeckComponent class. Setup members and viewport to enable
     *  scrolling features.
     * Parameters:
-    *  _formatManager: reference to global AudioFormatManager required to create new 
-    *   DeckPlayerComponents
-    *  cache: reference to global AudioThumbnailCache required to draw waveform
+    *  cache: reference to global WaveformCache required to draw waveform
     *  tracklist: reference to global TrackCollection representing all loaded tracks
-    *  playerPool: reference to global PlayerPool to get DJAudioPlayer instances for use    * 
+    *  playerPool: reference to global PlayerPool to get DJAudioPlayer instances for use
+    *  trackLoader: reference to global TrackLoader used to load tracks in the background
+    *  analysisThread: reference to shared thread the decks' FFTs run on
+    *  renderer: reference to global WaveformRenderer, drawing the displays on the GPU if enabled
     * Output:
     *  N/A
     *******************************************/
-    DeckComponent(AudioFormatManager& _formatManager, AudioThumbnailCache& cache, 
-        TrackCollection& tracklist, PlayerPool& playerPool);
+    DeckComponent(WaveformCache& cache, TrackCollection& tracklist, PlayerPool& playerPool,
+        TrackLoader& trackLoader, TimeSliceThread& analysisThread, WaveformRenderer& renderer);
 
     // base class overides
     /******************************************
@@ -99,12 +102,29 @@ public:
     *******************************************/
     void changeListenerCallback(ChangeBroadcaster* src) override;
 
+    // Timer overrides
+    /******************************************
+    * Name:
+    *  timerCallback
+    * Description:
+    *  implementation of the virtual timerCallback method. The
+    *  single refresh timer for all decks: refreshes every
+    *  DeckPlayerComponent once per frame, in the same callback.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void timerCallback() override;
+
     // methods
     /******************************************
     * Name:
     *  loadPlayer
     * Description:
-    *  Create new DeckPlayerComponent and load it.
+    *  Create new DeckPlayerComponent and queue its track to be 
+    *  loaded in the background. The DeckPlayerComponent shows a
+    *  loading state until the track is ready.
     * Parameters:
     *  id - ID of track to load.
     * Output:
@@ -112,6 +132,9 @@ public:
     *******************************************/
     void loadPlayer(int id);
 
+    // public constants
+    static const int REFRESH_FREQUENCY = 60;    // refresh frequency of the decks, per second
+
 private:
     // internal class to support scrollbars through ViewPort
     class DeckDisplayAreaComponent : public Component {
@@ -151,10 +174,12 @@ private:
     };
 
     // functionality members
-    AudioFormatManager& formatManager;  // reference to global AudioFormatManager
-    AudioThumbnailCache& cache; // reference to global AudioThumbnailCache
+    WaveformCache& cache;   // reference to global WaveformCache
     TrackCollection& tracklist; // reference to global TrackCollection
     PlayerPool& playerPool; // reference to global PlayerPool
+    TrackLoader& trackLoader;   // reference to global TrackLoader
+    TimeSliceThread& analysisThread;    // reference to shared thread the FFTs run on
+    WaveformRenderer& renderer; // reference to global WaveformRenderer
 
     // GUI members
     DeckDisplayAreaComponent displayArea;  // instance of internal class used to display
@@ -18,27 +18,39 @@
 *  DeckPlayerComponent
 * Description:
 *  constructor for the DeckPlayerComponent. Used to initialize
-*  and setup the GUI components, start timer running.
+*  and setup the GUI components. The player starts in the loading
+*  state until trackLoaded is called.
 * Parameters:
 *  track: pointer to Track that this player will player
-*  _formatManager: reference of global AudioFormatManager
-*  _cache: reference of global AudioThumbnailCache
+*  _cache: reference of global WaveformCache
+*  _analysisThread: reference of shared thread the FFT runs on
+*  _renderer: reference of global WaveformRenderer
 * Output:
 *  N/A
 *******************************************/
 DeckPlayerComponent::DeckPlayerComponent(
     Track* _track,
-    AudioFormatManager& _formatManager,
-    AudioThumbnailCache& _cache) :
+    WaveformCache& _cache,
+    TimeSliceThread& _analysisThread,
+    WaveformRenderer& _renderer) :
     track(_track),
-    waveformDisplay(_formatManager, _cache, track),
+    loading(false),
+    lastPosition(-1),
+    frequencyDisplay(_analysisThread, _renderer),
+    waveformDisplay(_cache, track, _renderer),
     sldFilter(Slider::TwoValueHorizontal, DJAudioPlayer::MIN_CUTOFF_FREQUENCY,
         DJAudioPlayer::MAX_CUTOFF_FREQUENCY, DJAudioPlayer::INTERVAL_CUTOFF_FREQUENCY,
         DJAudioPlayer::MIN_CUTOFF_FREQUENCY, "BW", "Hz", 0),
     sldVolume(Slider::Rotary, DJAudioPlayer::MIN_GAIN, DJAudioPlayer::MAX_GAIN, 
         DJAudioPlayer::INTERVAL_GAIN, DJAudioPlayer::DEFAULT_GAIN, "Volume", "", 2),
     sldSpeed(Slider::Rotary, DJAudioPlayer::MIN_SPEED, DJAudioPlayer::MAX_SPEED, 
-        DJAudioPlayer::INTERVAL_SPEED, DJAudioPlayer::DEFAULT_SPEED, "Speed", "x", 1)
+        DJAudioPlayer::INTERVAL_SPEED, DJAudioPlayer::DEFAULT_SPEED, "Speed", "x", 1),
+    sldEqLow(Slider::Rotary, DJAudioPlayer::MIN_EQ_GAIN, DJAudioPlayer::MAX_EQ_GAIN,
+        DJAudioPlayer::INTERVAL_EQ_GAIN, DJAudioPlayer::DEFAULT_EQ_GAIN, "Low", "dB", 1),
+    sldEqMid(Slider::Rotary, DJAudioPlayer::MIN_EQ_GAIN, DJAudioPlayer::MAX_EQ_GAIN,
+        DJAudioPlayer::INTERVAL_EQ_GAIN, DJAudioPlayer::DEFAULT_EQ_GAIN, "Mid", "dB", 1),
+    sldEqHigh(Slider::Rotary, DJAudioPlayer::MIN_EQ_GAIN, DJAudioPlayer::MAX_EQ_GAIN,
+        DJAudioPlayer::INTERVAL_EQ_GAIN, DJAudioPlayer::DEFAULT_EQ_GAIN, "High", "dB", 1)
 {
     setName(_track->getFileName());
     lblTrack.setJustificationType(Justification::horizontallyCentred);
@@ -57,8 +69,6 @@ DeckPlayerComponent::DeckPlayerComponent(
     btnStop.onClick = [this] {stopButtonClicked(); };
     addAndMakeVisible(btnStop);
 
-    updateButtons(true, false, false);
-
     btnFastForward.onClick = [this] {fastForwardButtonClicked(); };
     addAndMakeVisible(btnFastForward);
 
@@ -71,6 +81,14 @@ DeckPlayerComponent::DeckPlayerComponent(
     sldFilter.onValueChange = [this] {filterSliderChanged(); };
     addAndMakeVisible(sldFilter);
 
+    // filter slope selector, ids are the no. of biquads per filter
+    cmbSlope.addItem("12 dB/oct", FilterAudioSource::slope12dB);
+    cmbSlope.addItem("24 dB/oct", FilterAudioSource::slope24dB);
+    cmbSlope.addItem("48 dB/oct", FilterAudioSource::slope48dB);
+    cmbSlope.setSelectedId(FilterAudioSource::slope12dB, dontSendNotification);
+    cmbSlope.onChange = [this] {slopeComboChanged(); };
+    addAndMakeVisible(cmbSlope);
+
     // volume slider initialization
     sldVolume.onValueChange = [this] {volumeSliderChanged(); };
     addAndMakeVisible(sldVolume);
@@ -79,13 +97,40 @@ DeckPlayerComponent::DeckPlayerComponent(
     sldSpeed.onValueChange = [this] {speedSliderChanged(); };
     addAndMakeVisible(sldSpeed);
 
+    btnKeyLock.onClick = [this] {keyLockButtonClicked(); };
+    addAndMakeVisible(btnKeyLock);
+
+    // EQ sliders and kill buttons initialization
+    sldEqLow.onValueChange = [this] {eqSliderChanged(FilterAudioSource::bandLow); };
+    addAndMakeVisible(sldEqLow);
+    sldEqMid.onValueChange = [this] {eqSliderChanged(FilterAudioSource::bandMid); };
+    addAndMakeVisible(sldEqMid);
+    sldEqHigh.onValueChange = [this] {eqSliderChanged(FilterAudioSource::bandHigh); };
+    addAndMakeVisible(sldEqHigh);
+    btnKillLow.onClick = [this] {killButtonClicked(FilterAudioSource::bandLow); };
+    addAndMakeVisible(btnKillLow);
+    btnKillMid.onClick = [this] {killButtonClicked(FilterAudioSource::bandMid); };
+    addAndMakeVisible(btnKillMid);
+    btnKillHigh.onClick = [this] {killButtonClicked(FilterAudioSource::bandHigh); };
+    addAndMakeVisible(btnKillHigh);
+
+    // resampling quality selector, ids are the quality + 1 as 0 means no selection
+    cmbQuality.addItem("Linear", ResamplerAudioSource::linear + 1);
+    cmbQuality.addItem("Cubic", ResamplerAudioSource::cubic + 1);
+    cmbQuality.addItem("Sinc", ResamplerAudioSource::sinc + 1);
+    cmbQuality.setSelectedId(ResamplerAudioSource::sinc + 1, dontSendNotification);
+    cmbQuality.onChange = [this] {qualityComboChanged(); };
+    addAndMakeVisible(cmbQuality);
+
+    // waveform peaks are built alongside the audio being loaded
     waveformDisplay.loadURL(URL{ File{track->getFullPath()} });
     addAndMakeVisible(waveformDisplay);
 
     track->setFrequencyDisplay(&frequencyDisplay);
     addAndMakeVisible(frequencyDisplay);
 
-    startTimerHz(REFRESH_FREQUENCY);
+    // audio is loaded in the background, wait for trackLoaded
+    setLoading(true);
 }
 
 /******************************************
@@ -93,14 +138,13 @@ DeckPlayerComponent::DeckPlayerComponent(
 *  ~DeckPlayerComponent
 * Description:
 *  Destructor for the DeckPlayerComponent. Used to properly cleanup.
-*  Stops the timer and removes all attached ChangeListeners
+*  Removes all attached ChangeListeners
 * Parameters:
 *  N/A
 * Output:
 *  N/A
 *******************************************/
 DeckPlayerComponent::~DeckPlayerComponent() {
-    stopTimer();
     removeAllChangeListeners();
 }
 
@@ -151,12 +195,22 @@ void DeckPlayerComponent::resized()
 
     // reserve and allocate space for frequency filter and position sliders
     auto freqSliderArea = drawableArea.removeFromBottom(HEIGHT_SLIDER);
+    cmbSlope.setBounds(freqSliderArea.removeFromRight(WIDTH_COMBO).reduced(PADDING));
     sldFilter.setBounds(freqSliderArea.reduced(PADDING));
   
-    // compute space for rotary sliders
-    auto w = rotarySlidersArea.getWidth() / 2;
-    auto rotarySliderArea = rotarySlidersArea.removeFromLeft(w);
-    sldVolume.setBounds(rotarySliderArea.reduced(PADDING));
+    // compute space for rotary sliders, EQ bands then volume and speed,
+    // each with its button or selector underneath
+    auto w = rotarySlidersArea.getWidth() / 5;
+    auto layoutColumn = [&rotarySlidersArea, w](Component& slider, Component& below) {
+        auto rotarySliderArea = rotarySlidersArea.removeFromLeft(w);
+        below.setBounds(rotarySliderArea.removeFromBottom(HEIGHT_BUTTON).reduced(PADDING));
+        slider.setBounds(rotarySliderArea.reduced(PADDING));
+    };
+    layoutColumn(sldEqLow, btnKillLow);
+    layoutColumn(sldEqMid, btnKillMid);
+    layoutColumn(sldEqHigh, btnKillHigh);
+    layoutColumn(sldVolume, cmbQuality);
+    btnKeyLock.setBounds(rotarySlidersArea.removeFromBottom(HEIGHT_BUTTON).reduced(PADDING));
     sldSpeed.setBounds(rotarySlidersArea.reduced(PADDING));
 
     frequencyDisplay.setBounds(drawableArea.removeFromTop(WIDTH_FIXED-PADDING*2-100));
@@ -165,20 +219,36 @@ void DeckPlayerComponent::resized()
 
 /******************************************
 * Name:
-*  timerCallback
+*  refresh
 * Description :
-*  implementation of the virtual timerCallback method.
-*  The method checks if track has finished playing, reset
-*  buttons and track if so and updates frequencyDisplay
-*  and waveformDisplay.
+*  called once per frame by the deck component's refresh
+*  timer. Updates the frequencyDisplay if the analyser has a
+*  new spectrum. Unless the track is paused and its position
+*  unchanged, checks if track has finished playing, resets
+*  buttons and track if so and updates the waveformDisplay.
 * Parameters :
 *  N/A
 * Output :
 *  N/A
 *******************************************/
-void DeckPlayerComponent::timerCallback() {
+void DeckPlayerComponent::refresh() {
+    // nothing to update until the track is loaded
+    if (loading) {
+        return;
+    }
+
+    // take the latest spectrum from the analyser, if there is a new one
+    frequencyDisplay.updateFFT();
+
+    // paused and not moved (e.g. by seeking), nothing else to update
+    auto position = track->getPositionRelative();
+    if (position == lastPosition && !track->isPlaying()) {
+        return;
+    }
+    lastPosition = position;
+
     // check if track has finished playing...
-    if (!track->getPositionRelative() >= 1.0) {
+    if (position >= 1.0) {
         // if so, stop the track and update buttons
         track->stop();
         updateButtons(true, false, false);
@@ -186,9 +256,6 @@ void DeckPlayerComponent::timerCallback() {
 
     // repaint the playhead (ONLY)
     waveformDisplay.repaintPlayhead();
-    // compute FFT and update frequency display
-    frequencyDisplay.updateFFT();
-
 }
 
 /******************************************
@@ -321,6 +388,37 @@ void DeckPlayerComponent::speedSliderChanged() {
     track->setSpeed(spd);
 }
 
+/******************************************
+* Name:
+*  keyLockButtonClicked
+* Description:
+*  Event handler for when the key lock button is toggled.
+*  Updates the track's key lock.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void DeckPlayerComponent::keyLockButtonClicked() {
+    track->setKeyLock(btnKeyLock.getToggleState());
+}
+
+/******************************************
+* Name:
+*  qualityComboChanged
+* Description:
+*  Event handler for when a resampling quality is picked.
+*  Updates the track's resampling quality.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void DeckPlayerComponent::qualityComboChanged() {
+    auto quality = cmbQuality.getSelectedId() - 1;
+    track->setResamplerQuality((ResamplerAudioSource::Quality)quality);
+}
+
 /******************************************
 * Name:
 *  filterSliderChanged
@@ -338,6 +436,56 @@ void DeckPlayerComponent::filterSliderChanged() {
     track->setFrequencyRange(fLow, fHigh);
 }
 
+/******************************************
+* Name:
+*  slopeComboChanged
+* Description:
+*  Event handler for when a filter slope is picked.
+*  Updates the track's filter slope.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void DeckPlayerComponent::slopeComboChanged() {
+    auto slope = cmbSlope.getSelectedId();
+    track->setFilterSlope((FilterAudioSource::Slope)slope);
+}
+
+/******************************************
+* Name:
+*  eqSliderChanged
+* Description:
+*  Event handler for when an EQ slider's value is changed.
+*  Updates the gain of the track's EQ band.
+* Parameters:
+*  band: EQ band of the slider
+* Output:
+*  N/A
+*******************************************/
+void DeckPlayerComponent::eqSliderChanged(FilterAudioSource::Band band) {
+    auto& slider = band == FilterAudioSource::bandLow ? sldEqLow :
+        band == FilterAudioSource::bandMid ? sldEqMid : sldEqHigh;
+    track->setEqGain(band, slider.getValue());
+}
+
+/******************************************
+* Name:
+*  killButtonClicked
+* Description:
+*  Event handler for when an EQ kill button is toggled.
+*  Kills or restores the track's EQ band.
+* Parameters:
+*  band: EQ band of the button
+* Output:
+*  N/A
+*******************************************/
+void DeckPlayerComponent::killButtonClicked(FilterAudioSource::Band band) {
+    auto& button = band == FilterAudioSource::bandLow ? btnKillLow :
+        band == FilterAudioSource::bandMid ? btnKillMid : btnKillHigh;
+    track->setEqKill(band, button.getToggleState());
+}
+
 /******************************************
 * Name:
 *  getTrack
@@ -370,3 +518,58 @@ void DeckPlayerComponent::updateButtons(bool enablePlay, bool enablePause, bool
     btnPause.setEnabled(enablePause);
     btnStop.setEnabled(enableStop);
 }
+
+
+/******************************************
+* Name:
+*  trackLoaded
+* Description:
+*  Called when the background load of the track is done. Attaches
+*  the loaded audio to the track and leaves the loading state.
+* Parameters:
+*  loaded: result of the background load
+* Output:
+*  N/A
+*******************************************/
+void DeckPlayerComponent::trackLoaded(TrackLoader::LoadedTrack& loaded) {
+    // file could not be opened, stay disabled and show error
+    if (loaded.source == nullptr) {
+        lblTrack.setText("Unable to load " + track->getFileName(), dontSendNotification);
+        return;
+    }
+
+    // attach loaded audio
+    track->setSource(std::move(loaded.source));
+
+    setLoading(false);
+}
+
+/******************************************
+* Name:
+*  setLoading
+* Description:
+*  Enters or leaves the loading state. While loading, the track
+*  name shows the loading progress and the transport buttons are
+*  disabled.
+* Parameters:
+*  isLoading: if the track is being loaded
+* Output:
+*  N/A
+*******************************************/
+void DeckPlayerComponent::setLoading(bool isLoading) {
+    loading = isLoading;
+
+    // show loading state in the track label
+    lblTrack.setText((loading ? "Loading " + track->getFileName() + "..." : track->getFileName()),
+        dontSendNotification);
+
+    // transport buttons only usable when loaded
+    btnFastReverse.setEnabled(!loading);
+    btnFastForward.setEnabled(!loading);
+    if (loading) {
+        updateButtons(false, false, false);
+    }
+    else {
+        updateButtons(true, false, false);
+    }
+}
\ No newline at end of file
@@ -23,6 +23,7 @@ using namespace juce;
 #include "FrequencyDisplay.h"
 #include "WaveformDisplay.h"
 #include "Track.h"
+#include "TrackLoader.h"
 
 class DeckComponent;
 
@@ -30,8 +31,7 @@ class DeckComponent;
 /*
 */
 class DeckPlayerComponent  : public  Component,
-    public ChangeBroadcaster,
-    public Timer
+    public ChangeBroadcaster
 {
 public:
     // constructors & destructors
@@ -40,24 +40,27 @@ public:
     *  DeckPlayerComponent
     * Description:
     *  constructor for the DeckPlayerComponent. Used to initialize
-    *  and setup the GUI components, start timer running.
+    *  and setup the GUI components. The player starts in the loading
+    *  state until trackLoaded is called.
     * Parameters:
     *  track: pointer to Track that this player will player
-    *  _formatManager: reference of global AudioFormatManager
-    *  _cache: reference of global AudioThumbnailCache
+    *  _cache: reference of global WaveformCache
+    *  _analysisThread: reference of shared thread the FFT runs on
+    *  _renderer: reference of global WaveformRenderer
     * Output:
     *  N/A
     *******************************************/
     DeckPlayerComponent(Track *track, 
-        AudioFormatManager& _formatManager,
-        AudioThumbnailCache& _cache);
+        WaveformCache& _cache,
+        TimeSliceThread& _analysisThread,
+        WaveformRenderer& _renderer);
 
     /******************************************
     * Name:
     *  ~DeckPlayerComponent
     * Description:
     *  Destructor for the DeckPlayerComponent. Used to properly cleanup.
-    *  Stops the timer and removes all attached ChangeListeners
+    *  Removes all attached ChangeListeners
     * Parameters:
     *  N/A
     * Output:
@@ -92,21 +95,22 @@ public:
     *******************************************/
     void resized() override;
 
-    // Timer overides
+    // methods
     /******************************************
     * Name:
-    *  timerCallback
+    *  refresh
     * Description :
-    *  implementation of the virtual timerCallback method.
-    *  The method checks if track has finished playing, reset 
-    *  buttons and track if so and updates frequencyDisplay
-    *  and waveformDisplay.
+    *  called once per frame by the deck component's refresh
+    *  timer. Updates the frequencyDisplay if the analyser has a
+    *  new spectrum. Unless the track is paused and its position
+    *  unchanged, checks if track has finished playing, resets
+    *  buttons and track if so and updates the waveformDisplay.
     * Parameters :
     *  N/A 
     * Output :
     *  N/A
     *******************************************/
-    void timerCallback() override;
+    void refresh();
 
     // event handlers
     /******************************************
@@ -217,6 +221,71 @@ public:
     *******************************************/
     void speedSliderChanged();
 
+    /******************************************
+    * Name:
+    *  keyLockButtonClicked
+    * Description:
+    *  Event handler for when the key lock button is toggled.
+    *  Updates the track's key lock.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void keyLockButtonClicked();
+
+    /******************************************
+    * Name:
+    *  qualityComboChanged
+    * Description:
+    *  Event handler for when a resampling quality is picked.
+    *  Updates the track's resampling quality.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void qualityComboChanged();
+
+    /******************************************
+    * Name:
+    *  slopeComboChanged
+    * Description:
+    *  Event handler for when a filter slope is picked.
+    *  Updates the track's filter slope.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void slopeComboChanged();
+
+    /******************************************
+    * Name:
+    *  eqSliderChanged
+    * Description:
+    *  Event handler for when an EQ slider's value is changed.
+    *  Updates the gain of the track's EQ band.
+    * Parameters:
+    *  band: EQ band of the slider
+    * Output:
+    *  N/A
+    *******************************************/
+    void eqSliderChanged(FilterAudioSource::Band band);
+
+    /******************************************
+    * Name:
+    *  killButtonClicked
+    * Description:
+    *  Event handler for when an EQ kill button is toggled.
+    *  Kills or restores the track's EQ band.
+    * Parameters:
+    *  band: EQ band of the button
+    * Output:
+    *  N/A
+    *******************************************/
+    void killButtonClicked(FilterAudioSource::Band band);
+
     /******************************************
     * Name:
     *  filterSliderChanged
@@ -258,18 +327,47 @@ public:
     *******************************************/
     void updateButtons(bool enablePlay, bool enablePause, bool enableStop);
 
+    /******************************************
+    * Name:
+    *  trackLoaded
+    * Description:
+    *  Called when the background load of the track is done. Attaches
+    *  the loaded audio to the track and leaves the loading state.
+    * Parameters:
+    *  loaded: result of the background load
+    * Output:
+    *  N/A
+    *******************************************/
+    void trackLoaded(TrackLoader::LoadedTrack& loaded);
+
+    /******************************************
+    * Name:
+    *  setLoading
+    * Description:
+    *  Enters or leaves the loading state. While loading, the track
+    *  name shows the loading progress and the transport buttons are
+    *  disabled.
+    * Parameters:
+    *  isLoading: if the track is being loaded
+    * Output:
+    *  N/A
+    *******************************************/
+    void setLoading(bool isLoading);
+
     // public constants
     static const int WIDTH_FIXED = 522; // fixed width for the deck player component
     static const int WIDTH_BUTTON = 40; // width of a button
+    static const int WIDTH_COMBO = 90;  // width of a combo box beside a slider
     static const int HEIGHT_ROTARY_SLIDER = 100;    // height of a rotary slider
     static const int HEIGHT_SLIDER = 30;    // height of a horizontal slider
     static const int HEIGHT_BUTTON = 30;    // height of a button
     static const int PADDING = 5;   // padding between component edge and sub components
-    static const int REFRESH_FREQUENCY = 60;    // refresh frequency of timer
 
 private:
     // functionality members
     Track* track;   // pointer to associated track
+    bool loading;   // flag indicating if the track is still being loaded
+    double lastPosition;    // position of the track at the last refresh (relative)
 
     // GUI members
     Label lblTrack; // label to display track name
@@ -280,8 +378,17 @@ private:
     FastFowardButton btnFastForward;    // fast forward button
     PowerButton btnPower;   // power button
     CustomSlider sldFilter; // filter slider
+    ComboBox cmbSlope;  // filter slope selector
     CustomSlider sldVolume; // volume slider
     CustomSlider sldSpeed;  // speed slider
+    CustomSlider sldEqLow;  // EQ low band slider
+    CustomSlider sldEqMid;  // EQ mid band slider
+    CustomSlider sldEqHigh; // EQ high band slider
+    ToggleButton btnKillLow{ "Kill" };  // EQ low band kill button
+    ToggleButton btnKillMid{ "Kill" };  // EQ mid band kill button
+    ToggleButton btnKillHigh{ "Kill" }; // EQ high band kill button
+    ToggleButton btnKeyLock{ "Key lock" };  // key lock button
+    ComboBox cmbQuality;    // resampling quality selector
     FrequencyDisplay frequencyDisplay;  // frequency display (FFT)
     WaveformDisplay waveformDisplay;    // waveform (time-domain) display
 
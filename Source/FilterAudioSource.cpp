@@ -0,0 +1,735 @@
+/*
+  ==============================================================================
+
+    FilterAudioSource.cpp
+    Created: 18 Oct 2026 7:52:16am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#include "FilterAudioSource.h"
+
+/******************************************
+* Name:
+*  FilterAudioSource
+* Description:
+*  constructor of the FilterAudioSource class. Applies a 3-band EQ
+*  to the input source and band-limits it with a HPF and a LPF. EQ
+*  gains and cutoff frequencies glide to their targets on the audio
+*  thread, so changing them never clicks or blocks. Both filters
+*  start at 12 dB/oct, the EQ starts flat.
+* Parameters:
+*  source: input audio source, not owned
+*  minCutoff: initial HPF cutoff frequency
+*  maxCutoff: initial LPF cutoff frequency
+* Output:
+*  N/A
+*******************************************/
+FilterAudioSource::FilterAudioSource(AudioSource* _source, double minCutoff, double maxCutoff) :
+    source(_source),
+    sampleRate(DEFAULT_SAMPLE_RATE),
+    targetLow(minCutoff),
+    targetHigh(maxCutoff),
+    numStages(slope12dB),
+    fadeNumStages(0)
+{
+    cutoffLow.setCurrentAndTargetValue(minCutoff);
+    cutoffHigh.setCurrentAndTargetValue(maxCutoff);
+    slopeFade.setCurrentAndTargetValue(1.0f);
+    updateCoefficients();
+
+    // EQ starts flat
+    for (auto b = 0; b < numBands; ++b) {
+        targetGains[b].store(1.0f);
+        bandGains[b].setCurrentAndTargetValue(1.0f);
+    }
+
+    // SIMD aligned EQ scratch memory, the crossovers start from silence
+    eqMemory.allocate((size_t)((SIZE_SMOOTHING_BLOCK + N_EQ_STATES + N_EQ_REGISTERS + 1) * SIZE_SIMD), true);
+    eqBuffer = dsp::SIMDRegister<float>::getNextSIMDAlignedPtr(eqMemory.get());
+    eqStates = eqBuffer + SIZE_SMOOTHING_BLOCK * SIZE_SIMD;
+    eqRegisters = eqStates + N_EQ_STATES * SIZE_SIMD;
+    updateEqTerms(std::tan(MathConstants<double>::pi * EQ_LOW_FREQUENCY / DEFAULT_SAMPLE_RATE),
+        std::tan(MathConstants<double>::pi * EQ_HIGH_FREQUENCY / DEFAULT_SAMPLE_RATE));
+}
+
+/******************************************
+* Name:
+*  ~FilterAudioSource
+* Description:
+*  destructor of the FilterAudioSource class.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+FilterAudioSource::~FilterAudioSource() {}
+
+/******************************************
+* Name:
+*  prepareToPlay
+* Description:
+*  override of the base class prepareToPlay method. Prepares the
+*  input source, jumps the cutoff frequencies and EQ gains to their
+*  targets, computes the EQ crossovers and clears the filter state.
+* Parameters:
+*  samplesPerBlockExpected: no. of samples to return on each getNextAudioBlock call
+*  sampleRate: audio sampling rate
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::prepareToPlay(int samplesPerBlockExpected, double _sampleRate) {
+    source->prepareToPlay(samplesPerBlockExpected, _sampleRate);
+    sampleRate = _sampleRate;
+
+    // no gliding from before the device (re)started
+    cutoffLow.reset(sampleRate, SMOOTHING_SECONDS);
+    cutoffHigh.reset(sampleRate, SMOOTHING_SECONDS);
+    cutoffLow.setCurrentAndTargetValue(targetLow.load());
+    cutoffHigh.setCurrentAndTargetValue(targetHigh.load());
+
+    // start every biquad from silence
+    for (auto i = 0; i < slope48dB; ++i) {
+        hpfStages[i] = Biquad();
+        lpfStages[i] = Biquad();
+    }
+    numStages = targetSlope.load();
+    fadeNumStages = 0;
+    slopeFade.reset(sampleRate, SLOPE_FADE_SECONDS);
+    slopeFade.setCurrentAndTargetValue(1.0f);
+    updateCoefficients();
+
+    // EQ crossovers from silence
+    updateEqTerms(std::tan(MathConstants<double>::pi * EQ_LOW_FREQUENCY / sampleRate),
+        std::tan(MathConstants<double>::pi * EQ_HIGH_FREQUENCY / sampleRate));
+    FloatVectorOperations::clear(eqStates, N_EQ_STATES * SIZE_SIMD);
+    for (auto b = 0; b < numBands; ++b) {
+        bandGains[b].reset(sampleRate, EQ_SMOOTHING_SECONDS);
+        bandGains[b].setCurrentAndTargetValue(targetGains[b].load());
+    }
+}
+
+/******************************************
+* Name:
+*  releaseResources
+* Description:
+*  override of the base class releaseResources method. Releases
+*  the input source.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::releaseResources() {
+    source->releaseResources();
+}
+
+/******************************************
+* Name:
+*  getNextAudioBlock
+* Description:
+*  override of the base class getNextAudioBlock method. Reads the
+*  input source and processes it in place, SIZE_SMOOTHING_BLOCK samples
+*  at a time, running the EQ and every biquad of both filters over both
+*  channels while the samples are in cache. While the cutoff frequencies
+*  are gliding, the coefficients are recomputed for each of these blocks.
+*  After a slope change, the previous cascades keep running and are
+*  crossfaded to the new ones, as changing the Qs of running biquads
+*  would click.
+*  Never allocates or locks.
+* Parameters:
+*  bufferToFill: a descriptor representing the read and write audio buffers.
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) {
+    source->getNextAudioBlock(bufferToFill);
+    ScopedNoDenormals noDenormals;
+
+    // pick up the latest slope once any previous change has faded in; the current
+    // cascades are faded out, biquads added to the new ones start from silence
+    auto slope = targetSlope.load();
+    auto slopeChanged = slope != numStages && !slopeFade.isSmoothing();
+    if (slopeChanged) {
+        std::copy(hpfStages, hpfStages + numStages, fadeHpfStages);
+        std::copy(lpfStages, lpfStages + numStages, fadeLpfStages);
+        fadeNumStages = numStages;
+        for (auto i = numStages; i < slope; ++i) {
+            hpfStages[i] = Biquad();
+            lpfStages[i] = Biquad();
+        }
+        numStages = slope;
+        slopeFade.setCurrentAndTargetValue(0.0f);
+        slopeFade.setTargetValue(1.0f);
+    }
+
+    // pick up the latest targets, gliding restarts from the current values
+    cutoffLow.setTargetValue(targetLow.load());
+    cutoffHigh.setTargetValue(targetHigh.load());
+    for (auto b = 0; b < numBands; ++b) {
+        bandGains[b].setTargetValue(targetGains[b].load());
+    }
+
+    auto nChannels = jmin(bufferToFill.buffer->getNumChannels(), N_CHANNELS);
+    for (auto start = 0; start < bufferToFill.numSamples; start += SIZE_SMOOTHING_BLOCK) {
+        auto n = jmin(SIZE_SMOOTHING_BLOCK, bufferToFill.numSamples - start);
+
+        // move the cutoff frequencies on and recompute the coefficients only while gliding
+        if (slopeChanged || cutoffLow.isSmoothing() || cutoffHigh.isSmoothing()) {
+            cutoffLow.skip(n);
+            cutoffHigh.skip(n);
+            updateCoefficients();
+            slopeChanged = false;
+        }
+
+        // nothing to process without channels
+        if (nChannels == 0) {
+            continue;
+        }
+        auto startSample = bufferToFill.startSample + start;
+        auto* left = bufferToFill.buffer->getWritePointer(0, startSample);
+        auto* right = nChannels == N_CHANNELS ?
+            bufferToFill.buffer->getWritePointer(1, startSample) : nullptr;
+
+        // EQ always runs, even flat it shifts the phase, so switching it off would click
+        processEq(left, right, n);
+
+        // no slope change fading, run the cascades alone
+        if (fadeNumStages == 0) {
+            processCascade(hpfStages, lpfStages, numStages, left, right, n);
+            continue;
+        }
+
+        // run the previous cascades on a copy and crossfade to the new ones
+        float fadeLeft[SIZE_SMOOTHING_BLOCK];
+        float fadeRight[SIZE_SMOOTHING_BLOCK];
+        FloatVectorOperations::copy(fadeLeft, left, n);
+        if (right != nullptr) {
+            FloatVectorOperations::copy(fadeRight, right, n);
+        }
+        processCascade(fadeHpfStages, fadeLpfStages, fadeNumStages, fadeLeft,
+            right != nullptr ? fadeRight : nullptr, n);
+        processCascade(hpfStages, lpfStages, numStages, left, right, n);
+        for (auto i = 0; i < n; ++i) {
+            auto gain = slopeFade.getNextValue();
+            left[i] = fadeLeft[i] + gain * (left[i] - fadeLeft[i]);
+            if (right != nullptr) {
+                right[i] = fadeRight[i] + gain * (right[i] - fadeRight[i]);
+            }
+        }
+        if (!slopeFade.isSmoothing()) {
+            fadeNumStages = 0;
+        }
+    }
+}
+
+/******************************************
+* Name:
+*  setCutoffFrequencies
+* Description:
+*  setter for the target cutoff frequencies. Only stores the
+*  targets, the audio thread glides to them.
+* Parameters:
+*  fLow: HPF cutoff frequency
+*  fHigh: LPF cutoff frequency
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::setCutoffFrequencies(double fLow, double fHigh) {
+    targetLow.store(fLow);
+    targetHigh.store(fHigh);
+}
+
+/******************************************
+* Name:
+*  setSlope
+* Description:
+*  setter for the slope of both filters. Picked up on the
+*  next block, the filters then crossfade from the previous
+*  slope to the new one over SLOPE_FADE_SECONDS.
+* Parameters:
+*  slope: 12, 24 or 48 dB/oct
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::setSlope(Slope slope) {
+    targetSlope.store(slope);
+}
+
+/******************************************
+* Name:
+*  setBandGain
+* Description:
+*  setter for the target gain of an EQ band. Only stores the
+*  target, the audio thread glides to it.
+* Parameters:
+*  band: low, mid or high
+*  gain: linear gain of the band, 0.0 kills it
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::setBandGain(Band band, float gain) {
+    // range check, on fail, print error to debug
+    if (band < 0 || band >= numBands) {
+        DBG("FilterAudioSource::setBandGain: invalid band " << band << newLine);
+    }
+    // otherwise set target gain, picked up on the next block
+    else {
+        targetGains[band].store(gain);
+    }
+}
+
+/******************************************
+* Name:
+*  updateCoefficients
+* Description:
+*  computes the coefficients of every active HPF and LPF biquad
+*  for the current smoothed cutoff frequencies, including those
+*  of the previous slope while it is faded out.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::updateCoefficients() {
+    setCascade(hpfStages, lpfStages, numStages);
+    if (fadeNumStages > 0) {
+        setCascade(fadeHpfStages, fadeLpfStages, fadeNumStages);
+    }
+}
+
+/******************************************
+* Name:
+*  setCascade
+* Description:
+*  computes the coefficients of the biquads of a HPF and a LPF
+*  cascade for the current smoothed cutoff frequencies. The
+*  biquads of a filter together form a Butterworth filter of
+*  twice their number in order.
+* Parameters:
+*  hpf: HPF biquads
+*  lpf: LPF biquads
+*  nStages: no. of biquads per filter
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::setCascade(Biquad* hpf, Biquad* lpf, int nStages) {
+    auto order = 2 * nStages;
+    auto fLow = cutoffLow.getCurrentValue();
+    auto fHigh = cutoffHigh.getCurrentValue();
+
+    for (auto i = 0; i < nStages; ++i) {
+        // Q of the i-th 2nd order section of a Butterworth filter
+        auto q = 1.0 / (2.0 * std::sin((2 * i + 1) * MathConstants<double>::pi / (2.0 * order)));
+        setStage(hpf[i], IIRCoefficients::makeHighPass(sampleRate, fLow, q));
+        setStage(lpf[i], IIRCoefficients::makeLowPass(sampleRate, fHigh, q));
+    }
+}
+
+/******************************************
+* Name:
+*  processCascade
+* Description:
+*  runs every biquad of a HPF and a LPF cascade over a block
+*  in place, while it is in cache.
+* Parameters:
+*  hpf: HPF biquads, state updated
+*  lpf: LPF biquads, state updated
+*  nStages: no. of biquads per filter
+*  left: left channel samples
+*  right: right channel samples, nullptr if mono
+*  numSamples: no. of samples to filter
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::processCascade(Biquad* hpf, Biquad* lpf, int nStages,
+    float* left, float* right, int numSamples) {
+    if (right != nullptr) {
+        for (auto i = 0; i < nStages; ++i) {
+            processStereo(hpf[i], left, right, numSamples);
+        }
+        for (auto i = 0; i < nStages; ++i) {
+            processStereo(lpf[i], left, right, numSamples);
+        }
+    }
+    else {
+        for (auto i = 0; i < nStages; ++i) {
+            processMono(hpf[i], left, numSamples);
+        }
+        for (auto i = 0; i < nStages; ++i) {
+            processMono(lpf[i], left, numSamples);
+        }
+    }
+}
+
+/******************************************
+* Name:
+*  setStage
+* Description:
+*  copies coefficients into a biquad, keeping its state.
+* Parameters:
+*  stage: biquad to update
+*  coefficients: normalised coefficients (b0, b1, b2, a1, a2)
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::setStage(Biquad& stage, const IIRCoefficients& coefficients) {
+    stage.b0 = coefficients.coefficients[0];
+    stage.b1 = coefficients.coefficients[1];
+    stage.b2 = coefficients.coefficients[2];
+    stage.a1 = coefficients.coefficients[3];
+    stage.a2 = coefficients.coefficients[4];
+}
+
+/******************************************
+* Name:
+*  processStereo
+* Description:
+*  runs one biquad over both channels in place, in the same loop,
+*  so the two channels' recursions run side by side.
+* Parameters:
+*  stage: biquad to run, state updated
+*  left: left channel samples
+*  right: right channel samples
+*  numSamples: no. of samples to filter
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::processStereo(Biquad& stage, float* left, float* right, int numSamples) {
+    // keep coefficients and state in locals, the transposed form copes with coefficient changes
+    auto b0 = stage.b0;
+    auto b1 = stage.b1;
+    auto b2 = stage.b2;
+    auto a1 = stage.a1;
+    auto a2 = stage.a2;
+    auto s1L = stage.s1L;
+    auto s2L = stage.s2L;
+    auto s1R = stage.s1R;
+    auto s2R = stage.s2R;
+
+    // each channel's recursion depends on its previous sample, interleaving the
+    // two independent channels keeps the pipeline busy
+    for (auto i = 0; i < numSamples; ++i) {
+        auto xL = left[i];
+        auto xR = right[i];
+        auto yL = b0 * xL + s1L;
+        auto yR = b0 * xR + s1R;
+        s1L = b1 * xL - a1 * yL + s2L;
+        s1R = b1 * xR - a1 * yR + s2R;
+        s2L = b2 * xL - a2 * yL;
+        s2R = b2 * xR - a2 * yR;
+        left[i] = yL;
+        right[i] = yR;
+    }
+
+    stage.s1L = s1L;
+    stage.s2L = s2L;
+    stage.s1R = s1R;
+    stage.s2R = s2R;
+}
+
+/******************************************
+* Name:
+*  processMono
+* Description:
+*  runs one biquad over a single channel in place, using the
+*  left channel state.
+* Parameters:
+*  stage: biquad to run, state updated
+*  data: samples to filter
+*  numSamples: no. of samples to filter
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::processMono(Biquad& stage, float* data, int numSamples) {
+    auto b0 = stage.b0;
+    auto b1 = stage.b1;
+    auto b2 = stage.b2;
+    auto a1 = stage.a1;
+    auto a2 = stage.a2;
+    auto s1 = stage.s1L;
+    auto s2 = stage.s2L;
+
+    for (auto i = 0; i < numSamples; ++i) {
+        auto x = data[i];
+        auto y = b0 * x + s1;
+        s1 = b1 * x - a1 * y + s2;
+        s2 = b2 * x - a2 * y;
+        data[i] = y;
+    }
+
+    stage.s1L = s1;
+    stage.s2L = s2;
+}
+
+/******************************************
+* Name:
+*  updateEqTerms
+* Description:
+*  computes the SVF coefficients of both EQ crossovers and the
+*  weight of each term in each EQ band. The bands are 4th order
+*  Linkwitz-Riley splits at both crossovers, the low band allpassed
+*  at the high crossover so all three stay in phase and sum to an
+*  allpass. The SVFs being bilinear, every band splits exactly into
+*  partial fractions over the terms, whose weights are solved for
+*  from the bands' responses at numTerms points.
+* Parameters:
+*  gLow: tan(pi * EQ_LOW_FREQUENCY / sampleRate)
+*  gHigh: tan(pi * EQ_HIGH_FREQUENCY / sampleRate)
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::updateEqTerms(double gLow, double gHigh) {
+    // Butterworth SVF coefficients, laid out like the input
+    auto k = MathConstants<double>::sqrt2;
+    auto a1Low = 1.0 / (1.0 + gLow * (gLow + k));
+    auto a1High = 1.0 / (1.0 + gHigh * (gHigh + k));
+    setLanes(eqRegisters, (float)a1Low, (float)a1High);
+    setLanes(eqRegisters + SIZE_SIMD, (float)(gLow * a1Low), (float)(gHigh * a1High));
+    setLanes(eqRegisters + 2 * SIZE_SIMD, (float)(gLow * gLow * a1Low), (float)(gHigh * gHigh * a1High));
+
+    // one equation per point, spread from below the low crossover to above the high one,
+    // with a column per term and then one per band
+    const int nColumns = numTerms + numBands;
+    double equations[numTerms][nColumns];
+    for (auto p = 0; p < numTerms; ++p) {
+        auto s = gLow / 4.0 * std::pow(16.0 * gHigh / gLow, (double)p / (numTerms - 1));
+        auto* row = equations[p];
+        row[termInput] = 1.0;
+        getSvfTerms(s, gLow, row + termLowLpf);
+        getSvfTerms(s, gHigh, row + termHighLpf);
+
+        // a crossover's LPF is the second LPF output, the LPF and HPF sum to the allpass
+        // 1 - 2 k BPF, which leaves the HPF
+        auto allPassLow = 1.0 - 2.0 * k * row[termLowBpf];
+        auto allPassHigh = 1.0 - 2.0 * k * row[termHighBpf];
+        row[numTerms + bandLow] = row[termLowLpf2] * allPassHigh;
+        row[numTerms + bandHigh] = (allPassLow - row[termLowLpf2]) * (allPassHigh - row[termHighLpf2]);
+
+        // the mid band is what the low and high bands leave of the allpassed input
+        row[numTerms + bandMid] = allPassLow * allPassHigh - row[numTerms + bandLow] - row[numTerms + bandHigh];
+    }
+
+    // Gauss-Jordan elimination with partial pivoting
+    for (auto col = 0; col < numTerms; ++col) {
+        auto pivot = col;
+        for (auto r = col + 1; r < numTerms; ++r) {
+            if (std::abs(equations[r][col]) > std::abs(equations[pivot][col])) {
+                pivot = r;
+            }
+        }
+        for (auto i = 0; i < nColumns; ++i) {
+            std::swap(equations[col][i], equations[pivot][i]);
+        }
+        for (auto r = 0; r < numTerms; ++r) {
+            if (r == col) {
+                continue;
+            }
+            auto factor = equations[r][col] / equations[col][col];
+            for (auto i = col; i < nColumns; ++i) {
+                equations[r][i] -= factor * equations[col][i];
+            }
+        }
+    }
+    for (auto t = 0; t < numTerms; ++t) {
+        for (auto b = 0; b < numBands; ++b) {
+            bandTerms[b][t] = (float)(equations[t][numTerms + b] / equations[t][t]);
+        }
+    }
+}
+
+/******************************************
+* Name:
+*  getSvfTerms
+* Description:
+*  evaluates the LPF and BPF outputs of a crossover's two cascaded
+*  Butterworth SVFs in the analog prototype, at a real point.
+* Parameters:
+*  s: point to evaluate at, in units of the bilinear transform
+*  g: tan(pi * crossover frequency / sampleRate)
+*  terms: LPF, BPF, second LPF and second BPF outputs, filled in
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::getSvfTerms(double s, double g, double* terms) {
+    auto u = s / g;
+    auto lowPass = 1.0 / (u * u + MathConstants<double>::sqrt2 * u + 1.0);
+    terms[0] = lowPass;
+    terms[1] = u * lowPass;
+    terms[2] = lowPass * lowPass;
+    terms[3] = u * lowPass * lowPass;
+}
+
+/******************************************
+* Name:
+*  getEqWeights
+* Description:
+*  computes the weight of each term in the output for the given
+*  band gains.
+* Parameters:
+*  gains: gain per band
+*  weights: weight per term, filled in
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::getEqWeights(const float* gains, float* weights) {
+    for (auto t = 0; t < numTerms; ++t) {
+        weights[t] = 0.0f;
+        for (auto b = 0; b < numBands; ++b) {
+            weights[t] += gains[b] * bandTerms[b][t];
+        }
+    }
+}
+
+/******************************************
+* Name:
+*  setLanes
+* Description:
+*  fills a SIMD register's lanes in the EQ layout, where lanes
+*  alternate between the left and right channels, and the first
+*  pair of each four belongs to the low crossover, the second to
+*  the high crossover.
+* Parameters:
+*  lanes: SIZE_SIMD floats to fill
+*  low: value for the low crossover lanes
+*  high: value for the high crossover lanes
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::setLanes(float* lanes, float low, float high) {
+    for (auto lane = 0; lane < SIZE_SIMD; ++lane) {
+        lanes[lane] = lane / 2 % 2 == 0 ? low : high;
+    }
+}
+
+/******************************************
+* Name:
+*  processSvf
+* Description:
+*  runs one sample through a register of 2nd order state variable
+*  filters in topology preserving form.
+* Parameters:
+*  state1: first integrator states, updated
+*  state2: second integrator states, updated
+*  input: input samples
+*  a1, a2, a3: SVF coefficients, 1 / (1 + g (g + k)), g a1 and g a2
+*  lowPass: LPF output samples, filled in
+*  bandPass: BPF output samples, filled in
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::processSvf(dsp::SIMDRegister<float>& state1, dsp::SIMDRegister<float>& state2,
+    dsp::SIMDRegister<float> input, dsp::SIMDRegister<float> a1, dsp::SIMDRegister<float> a2,
+    dsp::SIMDRegister<float> a3, dsp::SIMDRegister<float>& lowPass, dsp::SIMDRegister<float>& bandPass) {
+    auto v3 = input - state2;
+    bandPass = a1 * state1 + a2 * v3;
+    lowPass = state2 + a2 * state1 + a3 * v3;
+    state1 = bandPass + bandPass - state1;
+    state2 = lowPass + lowPass - state2;
+}
+
+/******************************************
+* Name:
+*  processEq
+* Description:
+*  applies the EQ to a block in place. Both channels at both
+*  crossovers share each SIMD register, so the whole EQ runs two
+*  SVFs and a weighted sum per sample. The weights ramp linearly
+*  across the block.
+* Parameters:
+*  left: left channel samples
+*  right: right channel samples, nullptr if mono
+*  numSamples: no. of samples to process
+* Output:
+*  N/A
+*******************************************/
+void FilterAudioSource::processEq(float* left, float* right, int numSamples) {
+    // term weights at both ends of the block
+    float gains[numBands];
+    float weights[numTerms];
+    float deltas[numTerms];
+    for (auto b = 0; b < numBands; ++b) {
+        gains[b] = bandGains[b].getCurrentValue();
+    }
+    getEqWeights(gains, weights);
+    for (auto b = 0; b < numBands; ++b) {
+        gains[b] = bandGains[b].skip(numSamples);
+    }
+    getEqWeights(gains, deltas);
+    for (auto t = 0; t < numTerms; ++t) {
+        deltas[t] = (deltas[t] - weights[t]) / numSamples;
+    }
+
+    // after the SVF coefficients, the weights and their steps per sample, the
+    // input counted once, in the low crossover lanes
+    auto* lanes = eqRegisters + 3 * SIZE_SIMD;
+    setLanes(lanes, weights[termInput], 0.0f);
+    setLanes(lanes + 5 * SIZE_SIMD, deltas[termInput], 0.0f);
+    for (int t = termLowLpf; t < termHighLpf; ++t) {
+        auto high = t - termLowLpf + termHighLpf;
+        setLanes(lanes + t * SIZE_SIMD, weights[t], weights[high]);
+        setLanes(lanes + (t + 5) * SIZE_SIMD, deltas[t], deltas[high]);
+    }
+    auto a1 = dsp::SIMDRegister<float>::fromRawArray(eqRegisters);
+    auto a2 = dsp::SIMDRegister<float>::fromRawArray(eqRegisters + SIZE_SIMD);
+    auto a3 = dsp::SIMDRegister<float>::fromRawArray(eqRegisters + 2 * SIZE_SIMD);
+    auto weightInput = dsp::SIMDRegister<float>::fromRawArray(lanes);
+    auto weightLpf = dsp::SIMDRegister<float>::fromRawArray(lanes + SIZE_SIMD);
+    auto weightBpf = dsp::SIMDRegister<float>::fromRawArray(lanes + 2 * SIZE_SIMD);
+    auto weightLpf2 = dsp::SIMDRegister<float>::fromRawArray(lanes + 3 * SIZE_SIMD);
+    auto weightBpf2 = dsp::SIMDRegister<float>::fromRawArray(lanes + 4 * SIZE_SIMD);
+    auto deltaInput = dsp::SIMDRegister<float>::fromRawArray(lanes + 5 * SIZE_SIMD);
+    auto deltaLpf = dsp::SIMDRegister<float>::fromRawArray(lanes + 6 * SIZE_SIMD);
+    auto deltaBpf = dsp::SIMDRegister<float>::fromRawArray(lanes + 7 * SIZE_SIMD);
+    auto deltaLpf2 = dsp::SIMDRegister<float>::fromRawArray(lanes + 8 * SIZE_SIMD);
+    auto deltaBpf2 = dsp::SIMDRegister<float>::fromRawArray(lanes + 9 * SIZE_SIMD);
+    auto state1 = dsp::SIMDRegister<float>::fromRawArray(eqStates);
+    auto state2 = dsp::SIMDRegister<float>::fromRawArray(eqStates + SIZE_SIMD);
+    auto state3 = dsp::SIMDRegister<float>::fromRawArray(eqStates + 2 * SIZE_SIMD);
+    auto state4 = dsp::SIMDRegister<float>::fromRawArray(eqStates + 3 * SIZE_SIMD);
+
+    // spread each sample over its channel's lanes, a mono input fills both channels
+    auto* other = right != nullptr ? right : left;
+    for (auto i = 0; i < numSamples; ++i) {
+        auto* sample = eqBuffer + i * SIZE_SIMD;
+        for (auto lane = 0; lane < SIZE_SIMD; lane += 2) {
+            sample[lane] = left[i];
+            sample[lane + 1] = other[i];
+        }
+    }
+
+    // the second SVF of each crossover runs on the first one's LPF output
+    for (auto i = 0; i < numSamples; ++i) {
+        auto input = dsp::SIMDRegister<float>::fromRawArray(eqBuffer + i * SIZE_SIMD);
+        dsp::SIMDRegister<float> lpf, bpf, lpf2, bpf2;
+        processSvf(state1, state2, input, a1, a2, a3, lpf, bpf);
+        processSvf(state3, state4, lpf, a1, a2, a3, lpf2, bpf2);
+        weightInput += deltaInput;
+        weightLpf += deltaLpf;
+        weightBpf += deltaBpf;
+        weightLpf2 += deltaLpf2;
+        weightBpf2 += deltaBpf2;
+        (weightInput * input + weightLpf * lpf + weightBpf * bpf + weightLpf2 * lpf2 +
+            weightBpf2 * bpf2).copyToRawArray(eqBuffer + i * SIZE_SIMD);
+    }
+    state1.copyToRawArray(eqStates);
+    state2.copyToRawArray(eqStates + SIZE_SIMD);
+    state3.copyToRawArray(eqStates + 2 * SIZE_SIMD);
+    state4.copyToRawArray(eqStates + 3 * SIZE_SIMD);
+
+    // each channel's output is the sum of its lanes at both crossovers
+    for (auto i = 0; i < numSamples; ++i) {
+        auto* sample = eqBuffer + i * SIZE_SIMD;
+        left[i] = sample[0] + sample[2];
+        if (right != nullptr) {
+            right[i] = sample[1] + sample[3];
+        }
+    }
+}
+
+const double FilterAudioSource::EQ_LOW_FREQUENCY = 250.0;
+const double FilterAudioSource::EQ_HIGH_FREQUENCY = 4000.0;
+const double FilterAudioSource::SMOOTHING_SECONDS = 0.05;
+const double FilterAudioSource::EQ_SMOOTHING_SECONDS = 0.02;
+const double FilterAudioSource::SLOPE_FADE_SECONDS = 0.05;
\ No newline at end of file
@@ -0,0 +1,420 @@
+/*
+  ==============================================================================
+
+    FilterAudioSource.h
+    Created: 18 Oct 2026 7:52:16am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+using namespace juce;
+
+class FilterAudioSource : public AudioSource {
+public:
+    // enum representing the filter slopes, valued as the no. of biquads per filter
+    enum Slope {
+        slope12dB = 1,  // 12 dB/oct, 2nd order Butterworth
+        slope24dB = 2,  // 24 dB/oct, 4th order Butterworth
+        slope48dB = 4   // 48 dB/oct, 8th order Butterworth
+    };
+
+    // enum representing the EQ bands
+    enum Band {
+        bandLow = 0,    // below EQ_LOW_FREQUENCY
+        bandMid,        // between EQ_LOW_FREQUENCY and EQ_HIGH_FREQUENCY
+        bandHigh,       // above EQ_HIGH_FREQUENCY
+        numBands        // no. of bands, not a band
+    };
+
+    // constructors & destructors
+    /******************************************
+    * Name:
+    *  FilterAudioSource
+    * Description:
+    *  constructor of the FilterAudioSource class. Applies a 3-band EQ
+    *  to the input source and band-limits it with a HPF and a LPF. EQ
+    *  gains and cutoff frequencies glide to their targets on the audio
+    *  thread, so changing them never clicks or blocks. Both filters
+    *  start at 12 dB/oct, the EQ starts flat.
+    * Parameters:
+    *  source: input audio source, not owned
+    *  minCutoff: initial HPF cutoff frequency
+    *  maxCutoff: initial LPF cutoff frequency
+    * Output:
+    *  N/A
+    *******************************************/
+    FilterAudioSource(AudioSource* source, double minCutoff, double maxCutoff);
+
+    /******************************************
+    * Name:
+    *  ~FilterAudioSource
+    * Description:
+    *  destructor of the FilterAudioSource class.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    ~FilterAudioSource() override;
+
+    // base class overrides
+    /******************************************
+    * Name:
+    *  prepareToPlay
+    * Description:
+    *  override of the base class prepareToPlay method. Prepares the
+    *  input source, jumps the cutoff frequencies and EQ gains to their
+    *  targets, computes the EQ crossovers and clears the filter state.
+    * Parameters:
+    *  samplesPerBlockExpected: no. of samples to return on each getNextAudioBlock call
+    *  sampleRate: audio sampling rate
+    * Output:
+    *  N/A
+    *******************************************/
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /******************************************
+    * Name:
+    *  releaseResources
+    * Description:
+    *  override of the base class releaseResources method. Releases
+    *  the input source.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void releaseResources() override;
+
+    /******************************************
+    * Name:
+    *  getNextAudioBlock
+    * Description:
+    *  override of the base class getNextAudioBlock method. Reads the
+    *  input source and processes it in place, SIZE_SMOOTHING_BLOCK samples
+    *  at a time, running the EQ and every biquad of both filters over both
+    *  channels while the samples are in cache. While the cutoff frequencies
+    *  are gliding, the coefficients are recomputed for each of these blocks.
+    *  After a slope change, the previous cascades keep running and are
+    *  crossfaded to the new ones, as changing the Qs of running biquads
+    *  would click.
+    *  Never allocates or locks.
+    * Parameters:
+    *  bufferToFill: a descriptor representing the read and write audio buffers.
+    * Output:
+    *  N/A
+    *******************************************/
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    // getters & setters
+    /******************************************
+    * Name:
+    *  setCutoffFrequencies
+    * Description:
+    *  setter for the target cutoff frequencies. Only stores the
+    *  targets, the audio thread glides to them.
+    * Parameters:
+    *  fLow: HPF cutoff frequency
+    *  fHigh: LPF cutoff frequency
+    * Output:
+    *  N/A
+    *******************************************/
+    void setCutoffFrequencies(double fLow, double fHigh);
+
+    /******************************************
+    * Name:
+    *  setSlope
+    * Description:
+    *  setter for the slope of both filters. Picked up on the
+    *  next block, the filters then crossfade from the previous
+    *  slope to the new one over SLOPE_FADE_SECONDS.
+    * Parameters:
+    *  slope: 12, 24 or 48 dB/oct
+    * Output:
+    *  N/A
+    *******************************************/
+    void setSlope(Slope slope);
+
+    /******************************************
+    * Name:
+    *  setBandGain
+    * Description:
+    *  setter for the target gain of an EQ band. Only stores the
+    *  target, the audio thread glides to it.
+    * Parameters:
+    *  band: low, mid or high
+    *  gain: linear gain of the band, 0.0 kills it
+    * Output:
+    *  N/A
+    *******************************************/
+    void setBandGain(Band band, float gain);
+
+    // public constants
+    static const double EQ_LOW_FREQUENCY;   // crossover frequency between low and mid bands
+    static const double EQ_HIGH_FREQUENCY;  // crossover frequency between mid and high bands
+
+private:
+    // one biquad shared by both channels, transposed direct form II
+    struct Biquad {
+        float b0 = 1.0f;    // normalised feed-forward coefficients
+        float b1 = 0.0f;
+        float b2 = 0.0f;
+        float a1 = 0.0f;    // normalised feedback coefficients
+        float a2 = 0.0f;
+        float s1L = 0.0f;   // left channel state
+        float s2L = 0.0f;
+        float s1R = 0.0f;   // right channel state
+        float s2R = 0.0f;
+    };
+
+    // enum representing the terms every EQ band is a weighted sum of. Each
+    // crossover runs a second SVF on the LPF output of its first one
+    enum EqTerm {
+        termInput = 0,  // input sample
+        termLowLpf,     // LPF output of the first SVF at the low crossover
+        termLowBpf,     // BPF output of the first SVF at the low crossover
+        termLowLpf2,    // LPF output of the second SVF at the low crossover
+        termLowBpf2,    // BPF output of the second SVF at the low crossover
+        termHighLpf,    // LPF output of the first SVF at the high crossover
+        termHighBpf,    // BPF output of the first SVF at the high crossover
+        termHighLpf2,   // LPF output of the second SVF at the high crossover
+        termHighBpf2,   // BPF output of the second SVF at the high crossover
+        numTerms        // no. of terms, not a term
+    };
+
+    // methods
+    /******************************************
+    * Name:
+    *  updateCoefficients
+    * Description:
+    *  computes the coefficients of every active HPF and LPF biquad
+    *  for the current smoothed cutoff frequencies, including those
+    *  of the previous slope while it is faded out.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void updateCoefficients();
+
+    /******************************************
+    * Name:
+    *  setCascade
+    * Description:
+    *  computes the coefficients of the biquads of a HPF and a LPF
+    *  cascade for the current smoothed cutoff frequencies. The
+    *  biquads of a filter together form a Butterworth filter of
+    *  twice their number in order.
+    * Parameters:
+    *  hpf: HPF biquads
+    *  lpf: LPF biquads
+    *  nStages: no. of biquads per filter
+    * Output:
+    *  N/A
+    *******************************************/
+    void setCascade(Biquad* hpf, Biquad* lpf, int nStages);
+
+    /******************************************
+    * Name:
+    *  processCascade
+    * Description:
+    *  runs every biquad of a HPF and a LPF cascade over a block
+    *  in place, while it is in cache.
+    * Parameters:
+    *  hpf: HPF biquads, state updated
+    *  lpf: LPF biquads, state updated
+    *  nStages: no. of biquads per filter
+    *  left: left channel samples
+    *  right: right channel samples, nullptr if mono
+    *  numSamples: no. of samples to filter
+    * Output:
+    *  N/A
+    *******************************************/
+    static void processCascade(Biquad* hpf, Biquad* lpf, int nStages, float* left, float* right, int numSamples);
+
+    /******************************************
+    * Name:
+    *  setStage
+    * Description:
+    *  copies coefficients into a biquad, keeping its state.
+    * Parameters:
+    *  stage: biquad to update
+    *  coefficients: normalised coefficients (b0, b1, b2, a1, a2)
+    * Output:
+    *  N/A
+    *******************************************/
+    static void setStage(Biquad& stage, const IIRCoefficients& coefficients);
+
+    /******************************************
+    * Name:
+    *  processStereo
+    * Description:
+    *  runs one biquad over both channels in place, in the same loop,
+    *  so the two channels' recursions run side by side.
+    * Parameters:
+    *  stage: biquad to run, state updated
+    *  left: left channel samples
+    *  right: right channel samples
+    *  numSamples: no. of samples to filter
+    * Output:
+    *  N/A
+    *******************************************/
+    static void processStereo(Biquad& stage, float* left, float* right, int numSamples);
+
+    /******************************************
+    * Name:
+    *  processMono
+    * Description:
+    *  runs one biquad over a single channel in place, using the
+    *  left channel state.
+    * Parameters:
+    *  stage: biquad to run, state updated
+    *  data: samples to filter
+    *  numSamples: no. of samples to filter
+    * Output:
+    *  N/A
+    *******************************************/
+    static void processMono(Biquad& stage, float* data, int numSamples);
+
+    /******************************************
+    * Name:
+    *  updateEqTerms
+    * Description:
+    *  computes the SVF coefficients of both EQ crossovers and the
+    *  weight of each term in each EQ band. The bands are 4th order
+    *  Linkwitz-Riley splits at both crossovers, the low band allpassed
+    *  at the high crossover so all three stay in phase and sum to an
+    *  allpass. The SVFs being bilinear, every band splits exactly into
+    *  partial fractions over the terms, whose weights are solved for
+    *  from the bands' responses at numTerms points.
+    * Parameters:
+    *  gLow: tan(pi * EQ_LOW_FREQUENCY / sampleRate)
+    *  gHigh: tan(pi * EQ_HIGH_FREQUENCY / sampleRate)
+    * Output:
+    *  N/A
+    *******************************************/
+    void updateEqTerms(double gLow, double gHigh);
+
+    /******************************************
+    * Name:
+    *  getSvfTerms
+    * Description:
+    *  evaluates the LPF and BPF outputs of a crossover's two cascaded
+    *  Butterworth SVFs in the analog prototype, at a real point.
+    * Parameters:
+    *  s: point to evaluate at, in units of the bilinear transform
+    *  g: tan(pi * crossover frequency / sampleRate)
+    *  terms: LPF, BPF, second LPF and second BPF outputs, filled in
+    * Output:
+    *  N/A
+    *******************************************/
+    static void getSvfTerms(double s, double g, double* terms);
+
+    /******************************************
+    * Name:
+    *  getEqWeights
+    * Description:
+    *  computes the weight of each term in the output for the given
+    *  band gains.
+    * Parameters:
+    *  gains: gain per band
+    *  weights: weight per term, filled in
+    * Output:
+    *  N/A
+    *******************************************/
+    void getEqWeights(const float* gains, float* weights);
+
+    /******************************************
+    * Name:
+    *  setLanes
+    * Description:
+    *  fills a SIMD register's lanes in the EQ layout, where lanes
+    *  alternate between the left and right channels, and the first
+    *  pair of each four belongs to the low crossover, the second to
+    *  the high crossover.
+    * Parameters:
+    *  lanes: SIZE_SIMD floats to fill
+    *  low: value for the low crossover lanes
+    *  high: value for the high crossover lanes
+    * Output:
+    *  N/A
+    *******************************************/
+    static void setLanes(float* lanes, float low, float high);
+
+    /******************************************
+    * Name:
+    *  processSvf
+    * Description:
+    *  runs one sample through a register of 2nd order state variable
+    *  filters in topology preserving form.
+    * Parameters:
+    *  state1: first integrator states, updated
+    *  state2: second integrator states, updated
+    *  input: input samples
+    *  a1, a2, a3: SVF coefficients, 1 / (1 + g (g + k)), g a1 and g a2
+    *  lowPass: LPF output samples, filled in
+    *  bandPass: BPF output samples, filled in
+    * Output:
+    *  N/A
+    *******************************************/
+    static void processSvf(dsp::SIMDRegister<float>& state1, dsp::SIMDRegister<float>& state2,
+        dsp::SIMDRegister<float> input, dsp::SIMDRegister<float> a1, dsp::SIMDRegister<float> a2,
+        dsp::SIMDRegister<float> a3, dsp::SIMDRegister<float>& lowPass, dsp::SIMDRegister<float>& bandPass);
+
+    /******************************************
+    * Name:
+    *  processEq
+    * Description:
+    *  applies the EQ to a block in place. Both channels at both
+    *  crossovers share each SIMD register, so the whole EQ runs two
+    *  SVFs and a weighted sum per sample. The weights ramp linearly
+    *  across the block.
+    * Parameters:
+    *  left: left channel samples
+    *  right: right channel samples, nullptr if mono
+    *  numSamples: no. of samples to process
+    * Output:
+    *  N/A
+    *******************************************/
+    void processEq(float* left, float* right, int numSamples);
+
+    // functionality members
+    AudioSource* source;    // input audio source
+    double sampleRate;  // sampling rate the coefficients are computed for
+    std::atomic<double> targetLow;  // target HPF cutoff frequency
+    std::atomic<double> targetHigh; // target LPF cutoff frequency
+    SmoothedValue<double, ValueSmoothingTypes::Multiplicative> cutoffLow;   // gliding HPF cutoff frequency
+    SmoothedValue<double, ValueSmoothingTypes::Multiplicative> cutoffHigh;  // gliding LPF cutoff frequency
+    std::atomic<int> targetSlope{ slope12dB };  // target no. of biquads per filter
+    int numStages;  // current no. of biquads per filter
+    Biquad hpfStages[slope48dB];    // HPF biquads, the first numStages are active
+    Biquad lpfStages[slope48dB];    // LPF biquads, the first numStages are active
+    int fadeNumStages;  // no. of biquads per filter of the previous slope, 0 if not fading
+    Biquad fadeHpfStages[slope48dB];    // HPF biquads of the previous slope, faded out after a change
+    Biquad fadeLpfStages[slope48dB];    // LPF biquads of the previous slope, faded out after a change
+    SmoothedValue<float> slopeFade;     // gain of the current slope's filters, glides to 1 after a change
+    std::atomic<float> targetGains[numBands];   // target gain per EQ band
+    SmoothedValue<float> bandGains[numBands];   // gliding gain per EQ band
+    float bandTerms[numBands][numTerms];    // weight of each term in each EQ band
+    HeapBlock<float> eqMemory;  // backing memory of the SIMD aligned arrays below
+    float* eqBuffer;    // SIZE_SIMD lanes per sample of the block being EQ'd
+    float* eqStates;    // EQ SVF states, two registers per cascaded SVF
+    float* eqRegisters; // SVF coefficients, then the term weights and their steps per sample
+
+    // private constants
+    static const int N_CHANNELS = 2;    // no. of channels filtered
+    static const int SIZE_SMOOTHING_BLOCK = 32; // no. of samples between coefficient updates while gliding
+    static const int SIZE_SIMD = (int)dsp::SIMDRegister<float>::SIMDNumElements;  // no. of floats per SIMD register
+    static const int N_EQ_STATES = 4;   // no. of registers in eqStates
+    static const int N_EQ_REGISTERS = 13;   // no. of registers in eqRegisters
+    static const int DEFAULT_SAMPLE_RATE = 44100;   // sampling rate assumed until prepared
+    static const double SMOOTHING_SECONDS;  // time to glide to a new cutoff frequency
+    static const double EQ_SMOOTHING_SECONDS;   // time to glide to a new EQ gain
+    static const double SLOPE_FADE_SECONDS;     // time to crossfade to a new slope
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FilterAudioSource)
+};
\ No newline at end of file
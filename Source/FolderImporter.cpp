@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    FolderImporter.cpp
+    Created: 18 Oct 2026 12:27:51am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#include "FolderImporter.h"
+
+/******************************************
+* Name:
+*  FolderImporter
+* Description:
+*  constructor of the FolderImporter class. Sets up
+*  the worker pool used to walk folders.
+* Parameters:
+*  tracklist: reference to global TrackCollection
+* Output:
+*  N/A
+*******************************************/
+FolderImporter::FolderImporter(TrackCollection& _tracklist) :
+    tracklist(_tracklist) {}
+
+/******************************************
+* Name:
+*  ~FolderImporter
+* Description:
+*  destructor of the FolderImporter class. Stops walking
+*  folders and drops files not added yet.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+FolderImporter::~FolderImporter() {
+    cancelled.store(true);
+    pool.removeAllJobs(true, 2000);
+    cancelPendingUpdate();
+}
+
+/******************************************
+* Name:
+*  importAsync
+* Description:
+*  walks the given folders and all their sub folders on the
+*  worker pool, each folder in a separate job. Files with a
+*  known format are added to the track list in batches on the
+*  message thread, followed by a change message of the track list.
+* Parameters:
+*  folders: folders to import
+* Output:
+*  N/A
+*******************************************/
+void FolderImporter::importAsync(const Array<File>& folders) {
+    // the format manager is not thread-safe, so the workers use a snapshot
+    auto formats = std::make_shared<const std::unordered_set<String>>(tracklist.getKnownFormats());
+
+    for (auto& folder : folders) {
+        pool.addJob([this, folder, formats] { scanFolder(folder, formats); });
+    }
+}
+
+/******************************************
+* Name:
+*  handleAsyncUpdate
+* Description:
+*  called on the message thread. Adds all files found
+*  since the last call to the track list as one batch.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void FolderImporter::handleAsyncUpdate() {
+    StringArray batch;
+    {
+        const ScopedLock sl(lock);
+        batch.swapWith(found);
+    }
+    if (batch.isEmpty()) {
+        return;
+    }
+    // folders finish in any order, keep each batch sorted at least
+    batch.sort(true);
+
+    // duplicates are skipped by the track list's path index
+    tracklist.addTracks(batch);
+
+    // notify listeners (playlist) that tracks were added
+    tracklist.sendChangeMessage();
+}
+
+/******************************************
+* Name:
+*  scanFolder
+* Description:
+*  called from the worker pool. Lists a folder, queues a job
+*  for each sub folder and collects the files of a known format.
+* Parameters:
+*  folder: folder to list
+*  formats: snapshot of the known file extensions
+* Output:
+*  N/A
+*******************************************/
+void FolderImporter::scanFolder(const File& folder,
+    std::shared_ptr<const std::unordered_set<String>> formats) {
+    StringArray files;
+    for (auto& entry : RangedDirectoryIterator(folder, false, "*", File::findFilesAndDirectories)) {
+        if (cancelled.load()) {
+            return;
+        }
+        auto file = entry.getFile();
+
+        // walk sub folders in parallel, not following links to avoid cycles
+        if (entry.isDirectory()) {
+            if (!file.isSymbolicLink()) {
+                pool.addJob([this, file, formats] { scanFolder(file, formats); });
+            }
+        }
+        else if (formats->count(file.getFileExtension()) > 0) {
+            files.add(file.getFullPathName());
+        }
+    }
+    if (files.isEmpty()) {
+        return;
+    }
+
+    // hand over to the message thread, updates arriving close together are batched
+    {
+        const ScopedLock sl(lock);
+        found.addArray(files);
+    }
+    triggerAsyncUpdate();
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    FolderImporter.h
+    Created: 18 Oct 2026 12:27:51am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+using namespace juce;
+
+#include "TrackCollection.h"
+
+class FolderImporter : private AsyncUpdater {
+public:
+    // constructors & destructors
+    /******************************************
+    * Name:
+    *  FolderImporter
+    * Description:
+    *  constructor of the FolderImporter class. Sets up
+    *  the worker pool used to walk folders.
+    * Parameters:
+    *  tracklist: reference to global TrackCollection
+    * Output:
+    *  N/A
+    *******************************************/
+    FolderImporter(TrackCollection& tracklist);
+
+    /******************************************
+    * Name:
+    *  ~FolderImporter
+    * Description:
+    *  destructor of the FolderImporter class. Stops walking
+    *  folders and drops files not added yet.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    ~FolderImporter() override;
+
+    // methods
+    /******************************************
+    * Name:
+    *  importAsync
+    * Description:
+    *  walks the given folders and all their sub folders on the
+    *  worker pool, each folder in a separate job. Files with a
+    *  known format are added to the track list in batches on the
+    *  message thread, followed by a change message of the track list.
+    * Parameters:
+    *  folders: folders to import
+    * Output:
+    *  N/A
+    *******************************************/
+    void importAsync(const Array<File>& folders);
+
+private:
+    // AsyncUpdater overrides
+    /******************************************
+    * Name:
+    *  handleAsyncUpdate
+    * Description:
+    *  called on the message thread. Adds all files found
+    *  since the last call to the track list as one batch.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void handleAsyncUpdate() override;
+
+    // methods
+    /******************************************
+    * Name:
+    *  scanFolder
+    * Description:
+    *  called from the worker pool. Lists a folder, queues a job
+    *  for each sub folder and collects the files of a known format.
+    * Parameters:
+    *  folder: folder to list
+    *  formats: snapshot of the known file extensions
+    * Output:
+    *  N/A
+    *******************************************/
+    void scanFolder(const File& folder, std::shared_ptr<const std::unordered_set<String>> formats);
+
+    // functionality members
+    TrackCollection& tracklist; // reference to global TrackCollection
+    CriticalSection lock;       // lock guarding found files
+    StringArray found;          // files found, waiting to be added to the track list
+    std::atomic<bool> cancelled{ false };   // set on destruction, stops walking folders
+    ThreadPool pool{ jmax(1, SystemStats::getNumCpus() - 1) };  // worker pool walking folders
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FolderImporter)
+};
\ No newline at end of file
@@ -17,20 +17,56 @@
 *  FrequencyDisplay
 * Description:
 *  Constructor for the FrequencyDisplay class. initialize members.
+*  When the renderer is enabled the spectrum is drawn by it on the
+*  GPU instead.
 * Parameters:
-*  N/A
+*  analysisThread: shared background thread the FFT runs on
+*  rendererToUse: reference to global WaveformRenderer
 * Output:
 *  N/A
 *******************************************/
-FrequencyDisplay::FrequencyDisplay() :
-    fft(FFT_ORDER),
-    window(SIZE_FFT, WindowingFunction<float>::hann),
+FrequencyDisplay::FrequencyDisplay(TimeSliceThread& analysisThread, WaveformRenderer& rendererToUse) :
+    analyser(analysisThread),
+    renderer(rendererToUse),
     gradient(Colour::fromRGB(3, 2, 252), 0, 0, Colour::fromRGB(254, 0, 2), 1, 1, false)
 {
     // set up more colours within the gradient to make the changes in level more obvious
     gradient.addColour(0.25, Colour::fromRGB(11, 84, 254));
     gradient.addColour(0.5, Colour::fromRGB(132, 50, 223));
     gradient.addColour(0.75, Colour::fromRGB(252, 15, 192));
+
+    // look up the colours once instead of on every repaint
+    for (auto i = 0; i < SIZE_LUT; ++i) {
+        lut[i] = gradient.getColourAtPosition((double)i / (SIZE_LUT - 1)).getPixelARGB();
+    }
+
+    scopeData = analyser.getScope();
+
+    // everything is drawn from the image, nothing behind needs painting
+    setOpaque(true);
+
+    // drawn on the GPU underneath, this component paints nothing
+    if (renderer.isEnabled()) {
+        setOpaque(false);
+        renderer.addSpectrum(this, lut, SIZE_LUT);
+    }
+}
+
+/******************************************
+* Name:
+*  ~FrequencyDisplay
+* Description:
+*  Destructor for the FrequencyDisplay class. Stops the
+*  renderer drawing it.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+FrequencyDisplay::~FrequencyDisplay() {
+    if (renderer.isEnabled()) {
+        renderer.removeView(this);
+    }
 }
 
 /******************************************
@@ -38,7 +74,7 @@ FrequencyDisplay::FrequencyDisplay() :
 *  paint
 * Description :
 *  override of base class paint method. Used to draw the frequency domain
-*  waveform.
+*  waveform, by copying the part of the spectrum image that changed.
 * Parameters :
 *  g: reference to Graphics used for drawing
 * Output :
@@ -46,106 +82,188 @@ FrequencyDisplay::FrequencyDisplay() :
 *******************************************/
 void FrequencyDisplay::paint (juce::Graphics& g)
 {
-    // get component width and height
-    auto width = getLocalBounds().getWidth();
-    auto height = getLocalBounds().getHeight();
-    // get width per slice in the scope data
-    auto w = width / SIZE_SCOPE;
-    // if width per slice is less than 1, fix to 1
-    if (w < 1) {
-        w = 1;
+    // drawn on the GPU instead
+    if (renderer.isEnabled()) {
+        return;
+    }
+
+    // paint background until the image is created
+    if (!image.isValid()) {
+        g.fillAll(Colours::black);
+        return;
     }
-    // paint background
-    g.setColour(Colours::black);
-    g.fillAll();
-
-    // process frequency data piece by piece and paint output slice by slice
-    for (int i = 1; i < SIZE_SCOPE; ++i)
-    {
-        // set colour according to level at current frequency range
-        g.setColour(gradient.getColourAtPosition(scopeData[i]));
-        auto y = (int)jmap(1-scopeData[i], 0.0f, 1.0f, 0.0f, (float)height);
-        auto h = (int)jmap(scopeData[i], 0.0f, 1.0f, 0.0f, (float)height);
-        if (y > 0 && h > 0)
-        g.fillRect(i - 1, y, w, h);
+    // only the clipped (repainted) region is copied
+    g.drawImageAt(image, 0, 0);
+}
+
+/******************************************
+* Name:
+*  resized
+* Description :
+*  override of base class resized method. Recreates the
+*  spectrum image at the new size and redraws it.
+* Parameters :
+*  N/A
+* Output :
+*  N/A
+*******************************************/
+void FrequencyDisplay::resized() {
+    auto width = getWidth();
+    auto height = getHeight();
+    if (width <= 0 || height <= 0 || renderer.isEnabled()) {
+        image = Image();
+        return;
     }
 
+    // new image with just the background, every bar needs drawing
+    image = Image(Image::ARGB, width, height, false);
+    Graphics(image).fillAll(Colours::black);
+    columns.assign((size_t)width, Column());
+    renderScope();
+    repaint();
 }
 
 /******************************************
 * Name:
-*  pushNextSample
+*  renderScope
 * Description:
-*  called by the getNextAudioBlock of each DJAudioPlayer
-*  in order to load samples into the buffer for FFT processing.
+*  draw the current spectrum into the spectrum image, writing
+*  the pixels of only the columns whose bar changed, and
+*  repaint the area covering them.
 * Parameters:
-*  sample: a single sample to load into the buffer
+*  N/A
 * Output:
 *  N/A
 *******************************************/
-void FrequencyDisplay::pushNextSample(float sample) {
-    // load one more sample into the fft data buffer and update
-    // index as necessary
-    if (fifoId == SIZE_FFT) {
-        if (!nextFFTBlockReady) {
-            zeromem(fftData, sizeof(fftData));
-            memcpy(fftData, fifo, sizeof(fifo));
-            nextFFTBlockReady = true;
+void FrequencyDisplay::renderScope() {
+    if (!image.isValid()) {
+        return;
+    }
+    auto width = image.getWidth();
+    auto height = image.getHeight();
+    // get width per slice in the scope data
+    auto w = jmax(1, width / SIZE_SCOPE);
+    auto black = Colours::black.getPixelARGB();
+    auto dirtyStart = width;
+    auto dirtyEnd = 0;
+
+    Image::BitmapData data(image, Image::BitmapData::writeOnly);
+    for (auto x = 0; x < width; ++x) {
+        // slice i is drawn from x = i - 1 and w wide, later slices on top
+        Column column;
+        auto i = jmin(x + 1, SIZE_SCOPE - 1);
+        if (x < SIZE_SCOPE - 2 + w) {
+            auto y = (int)jmap(1 - scopeData[i], 0.0f, 1.0f, 0.0f, (float)height);
+            auto h = (int)jmap(scopeData[i], 0.0f, 1.0f, 0.0f, (float)height);
+            if (y > 0 && h > 0) {
+                column.y = y;
+                column.h = jmin(h, height - y);
+                column.colour = jlimit(0, SIZE_LUT - 1, roundToInt(scopeData[i] * (SIZE_LUT - 1)));
+            }
         }
 
-        fifoId = 0;
+        // leave the column alone if it shows the same bar already
+        auto& drawn = columns[(size_t)x];
+        if (drawn.y == column.y && drawn.h == column.h && drawn.colour == column.colour) {
+            continue;
+        }
+        dirtyStart = jmin(dirtyStart, x);
+        dirtyEnd = x + 1;
+
+        // only rows covered by the old or the new bar can change, the rest stays background
+        auto first = height;
+        auto last = 0;
+        if (drawn.colour >= 0) {
+            first = drawn.y;
+            last = drawn.y + drawn.h;
+        }
+        if (column.colour >= 0) {
+            first = jmin(first, column.y);
+            last = jmax(last, column.y + column.h);
+        }
+        drawn = column;
+
+        // write the column's pixels directly
+        for (auto y = first; y < last; ++y) {
+            auto inBar = column.colour >= 0 && y >= column.y && y < column.y + column.h;
+            reinterpret_cast<PixelARGB*>(data.getPixelPointer(x, y))->set(inBar ? lut[column.colour] : black);
+        }
+    }
+
+    // only repaint the columns that changed
+    if (dirtyStart < dirtyEnd) {
+        repaint(dirtyStart, 0, dirtyEnd - dirtyStart, height);
     }
-    fifo[fifoId++] = sample;
 }
 
 /******************************************
 * Name:
-*  drawNextTrace
+*  updateFFT
 * Description:
-*  perform FFT and normalize the output levels
+*  called from deck player component timer callback to take
+*  the latest spectrum from the analyser and redraw frequency data,
+*  or pass it to the renderer
 * Parameters:
 *  N/A
 * Output:
 *  N/A
 *******************************************/
-void FrequencyDisplay::drawNextTrace() {
-    // perform FFT using windowing function
-    window.multiplyWithWindowingTable(fftData, SIZE_FFT);
-    fft.performFrequencyOnlyForwardTransform(fftData);
-
-    auto mindB = -100.0f;
-    auto maxdB = 0.0f;
-
-    // normalize all sample and take only the relevant frequency range (remove mirrored part)
-    for (auto i = 0; i < SIZE_SCOPE; ++i) {
-        auto skewedProportionX = 1.0f - std::exp(std::log(1.0f - 
-            (float)i / (float)SIZE_SCOPE) * 0.2f);
-        auto fftDataId = jlimit(0, SIZE_FFT / 2, 
-            (int)(skewedProportionX * (float)SIZE_FFT * 0.5));
-        auto level = jmap(jlimit(mindB, maxdB, Decibels::gainToDecibels(fftData[fftDataId])
-            - Decibels::gainToDecibels((float)SIZE_FFT)), mindB, maxdB, 0.0f, 1.0f);
-        scopeData[i] = level;
+void FrequencyDisplay::updateFFT() {
+    // the FFT is performed on the analysis thread, only redraw here
+    if (analyser.updateScope()) {
+        scopeData = analyser.getScope();
+        // redraw the frequency visualization where it changed, or let the GPU draw all of it
+        if (renderer.isEnabled()) {
+            renderer.setSpectrum(this, scopeData, SIZE_SCOPE);
+        }
+        else {
+            renderScope();
+        }
     }
 }
 
 /******************************************
 * Name:
-*  updateFFT
+*  setSampleFifo
 * Description:
-*  called from deck player component timer callback to
-*  perform FFT and redraw frequency data
+*  setter for the fifo the analyser reads the samples to
+*  analyse from. Samples already in the fifo are dropped.
 * Parameters:
+*  sampleFifo: fifo written by a DJAudioPlayer, nullptr to detach
+*  sampleRate: sampling rate of the samples written to the fifo
+* Output:
 *  N/A
+*******************************************/
+void FrequencyDisplay::setSampleFifo(SampleFifo* sampleFifo, double sampleRate) {
+    analyser.setSampleFifo(sampleFifo, sampleRate);
+}
+
+/******************************************
+* Name:
+*  setBinAveraging
+* Description:
+*  setter for if each displayed level averages all FFT bins
+*  in its frequency range, instead of sampling a single bin.
+* Parameters:
+*  averaging: true to average bins, false to point sample
 * Output:
 *  N/A
 *******************************************/
-void FrequencyDisplay::updateFFT() {
-    if (nextFFTBlockReady) {
-        // perform FFT and normalization
-        drawNextTrace();
-        // set flag to false to start gathering more input sample
-        nextFFTBlockReady = false;
-        // redraw the frequency visualization
-        repaint();
-    }
+void FrequencyDisplay::setBinAveraging(bool averaging) {
+    analyser.setBinAveraging(averaging);
 }
+
+/******************************************
+* Name:
+*  setAnalyserSettings
+* Description:
+*  setter for the FFT resolution, overlap, window type and
+*  peak hold/decay of the analysis.
+* Parameters:
+*  settings: new analysis settings
+* Output:
+*  N/A
+*******************************************/
+void FrequencyDisplay::setAnalyserSettings(const SpectrumAnalyser::Settings& settings) {
+    analyser.setSettings(settings);
+}
\ No newline at end of file
@@ -14,6 +14,10 @@
 using namespace juce;
 using namespace juce::dsp;
 
+#include "SampleFifo.h"
+#include "SpectrumAnalyser.h"
+#include "WaveformRenderer.h"
+
 //==============================================================================
 /*
 */
@@ -26,12 +30,28 @@ public:
     *  FrequencyDisplay
     * Description:
     *  Constructor for the FrequencyDisplay class. initialize members.
+    *  When the renderer is enabled the spectrum is drawn by it on the
+    *  GPU instead.
+    * Parameters:
+    *  analysisThread: shared background thread the FFT runs on
+    *  rendererToUse: reference to global WaveformRenderer
+    * Output:
+    *  N/A
+    *******************************************/
+    FrequencyDisplay(TimeSliceThread& analysisThread, WaveformRenderer& rendererToUse);
+
+    /******************************************
+    * Name:
+    *  ~FrequencyDisplay
+    * Description:
+    *  Destructor for the FrequencyDisplay class. Stops the
+    *  renderer drawing it.
     * Parameters:
     *  N/A
     * Output:
     *  N/A
     *******************************************/
-    FrequencyDisplay();
+    ~FrequencyDisplay() override;
 
     // base class overrides
     /******************************************
@@ -39,7 +59,7 @@ public:
     *  paint
     * Description :
     *  override of base class paint method. Used to draw the frequency domain
-    *  waveform.
+    *  waveform, by copying the part of the spectrum image that changed.
     * Parameters :
     *  g: reference to Graphics used for drawing
     * Output :
@@ -47,61 +67,110 @@ public:
     *******************************************/
     void paint (juce::Graphics& g) override;
 
+    /******************************************
+    * Name:
+    *  resized
+    * Description :
+    *  override of base class resized method. Recreates the
+    *  spectrum image at the new size and redraws it.
+    * Parameters :
+    *  N/A
+    * Output :
+    *  N/A
+    *******************************************/
+    void resized() override;
+
     // methods
     /******************************************
     * Name:
-    *  pushNextSample
+    *  updateFFT
+    * Description:
+    *  called from deck player component timer callback to take
+    *  the latest spectrum from the analyser and redraw frequency data,
+    *  or pass it to the renderer
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void updateFFT();
+
+    // getters & setters
+    /******************************************
+    * Name:
+    *  setSampleFifo
     * Description:
-    *  called by the getNextAudioBlock of each DJAudioPlayer 
-    *  in order to load samples into the buffer for FFT processing.
+    *  setter for the fifo the analyser reads the samples to
+    *  analyse from. Samples already in the fifo are dropped.
     * Parameters:
-    *  sample: a single sample to load into the buffer
+    *  sampleFifo: fifo written by a DJAudioPlayer, nullptr to detach
+    *  sampleRate: sampling rate of the samples written to the fifo
     * Output:
     *  N/A
     *******************************************/
-    void pushNextSample(float sample);
+    void setSampleFifo(SampleFifo* sampleFifo, double sampleRate);
 
     /******************************************
     * Name:
-    *  drawNextTrace
+    *  setBinAveraging
     * Description:
-    *  perform FFT and normalize the output levels
+    *  setter for if each displayed level averages all FFT bins
+    *  in its frequency range, instead of sampling a single bin.
     * Parameters:
+    *  averaging: true to average bins, false to point sample
+    * Output:
     *  N/A
+    *******************************************/
+    void setBinAveraging(bool averaging);
+
+    /******************************************
+    * Name:
+    *  setAnalyserSettings
+    * Description:
+    *  setter for the FFT resolution, overlap, window type and
+    *  peak hold/decay of the analysis.
+    * Parameters:
+    *  settings: new analysis settings
     * Output:
     *  N/A
     *******************************************/
-    void drawNextTrace();
+    void setAnalyserSettings(const SpectrumAnalyser::Settings& settings);
+
+private:
+    // a pixel column of the spectrum image
+    struct Column {
+        int y = -1;         // top of the bar
+        int h = -1;         // height of the bar
+        int colour = -1;    // index of the bar colour in the gradient look up table
+    };
 
+    // methods
     /******************************************
     * Name:
-    *  updateFFT
+    *  renderScope
     * Description:
-    *  called from deck player component timer callback to 
-    *  perform FFT and redraw frequency data
+    *  draw the current spectrum into the spectrum image, writing
+    *  the pixels of only the columns whose bar changed, and
+    *  repaint the area covering them.
     * Parameters:
     *  N/A
     * Output:
     *  N/A
     *******************************************/
-    void updateFFT();
+    void renderScope();
 
-private:
     // functionality members
-    // FFT related members
-    static const int FFT_ORDER = 11;
-    static const int SIZE_FFT = 1 << FFT_ORDER;
-    static const int SIZE_SCOPE = 512;
-    FFT fft;
-    WindowingFunction<float> window;
-    float fifo[SIZE_FFT];
-    float fftData[2 * SIZE_FFT];
-    int fifoId = 0;
-    bool nextFFTBlockReady = false;
-    float scopeData[SIZE_SCOPE];
+    static const int SIZE_SCOPE = SpectrumAnalyser::SIZE_SCOPE;
+    SpectrumAnalyser analyser;  // performs the FFT on the shared analysis thread
+    const float* scopeData;     // latest spectrum taken from the analyser
+    WaveformRenderer& renderer; // reference to global WaveformRenderer
     
     // colour gradient for drawing
     ColourGradient gradient;
+    static const int SIZE_LUT = 256;    // no. of colours looked up from the gradient
+    PixelARGB lut[SIZE_LUT];    // gradient colours, from level 0 to 1
+    Image image;    // spectrum drawn so far
+    std::vector<Column> columns;    // bar drawn in each pixel column of the image
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FrequencyDisplay)
 };
@@ -0,0 +1,290 @@
+/*
+  ==============================================================================
+
+    LibraryDatabase.cpp
+    Created: 17 Oct 2026 11:42:19pm
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#include "LibraryDatabase.h"
+
+// file extension of the string table
+const String LibraryDatabase::EXTENSION_STRINGS = ".strings";
+// appended to the file names of a damaged database kept aside
+const String LibraryDatabase::EXTENSION_BACKUP = ".bak";
+
+/******************************************
+* Name:
+*  LibraryDatabase
+* Description:
+*  constructor of the LibraryDatabase class. The library is
+*  stored as a file of fixed-size records, and a string table
+*  next to it holding the paths the records point into.
+* Parameters:
+*  databaseFile: file holding the records, the string table
+*   is stored alongside with a different extension
+* Output:
+*  N/A
+*******************************************/
+LibraryDatabase::LibraryDatabase(const File& _databaseFile) :
+    databaseFile(_databaseFile),
+    stringsFile(_databaseFile.withFileExtension(EXTENSION_STRINGS)) {}
+
+/******************************************
+* Name:
+*  exists
+* Description:
+*  checks if the database has been written before.
+* Parameters:
+*  N/A
+* Output:
+*  true if both the records and the string table exist
+*******************************************/
+bool LibraryDatabase::exists() {
+    return databaseFile.existsAsFile() && stringsFile.existsAsFile();
+}
+
+/******************************************
+* Name:
+*  isMissing
+* Description:
+*  checks if nothing of the database has been written yet,
+*  as opposed to a database that exists but is damaged.
+* Parameters:
+*  N/A
+* Output:
+*  true if neither the records nor the string table exist
+*******************************************/
+bool LibraryDatabase::isMissing() {
+    return !databaseFile.exists() && !stringsFile.exists();
+}
+
+/******************************************
+* Name:
+*  backup
+* Description:
+*  renames the records and string table that exist by
+*  appending EXTENSION_BACKUP, replacing any older backup,
+*  so a damaged database is kept instead of overwritten.
+* Parameters:
+*  N/A
+* Output:
+*  the backup of the records, or File() if a file could
+*  not be renamed
+*******************************************/
+File LibraryDatabase::backup() {
+    File recordsBackup(databaseFile.getFullPathName() + EXTENSION_BACKUP);
+    File stringsBackup(stringsFile.getFullPathName() + EXTENSION_BACKUP);
+    if ((databaseFile.exists() && !databaseFile.moveFileTo(recordsBackup)) ||
+        (stringsFile.exists() && !stringsFile.moveFileTo(stringsBackup))) {
+        DBG("LibraryDatabase::backup: unable to rename " << databaseFile.getFullPathName());
+        return File();
+    }
+    return recordsBackup;
+}
+
+/******************************************
+* Name:
+*  read
+* Description:
+*  memory maps the records and the string table and
+*  reads every entry of the library. Records pointing
+*  outside the string table are skipped.
+* Parameters:
+*  entries: vector the entries are added to
+* Output:
+*  true if read, false if the database is missing or invalid
+*******************************************/
+bool LibraryDatabase::read(std::vector<Entry>& entries) {
+    if (!exists()) {
+        return false;
+    }
+
+    // map both files instead of reading them into memory
+    MemoryMappedFile records(databaseFile, MemoryMappedFile::readOnly);
+    MemoryMappedFile strings(stringsFile, MemoryMappedFile::readOnly);
+    Header recordsHeader, stringsHeader;
+    if (!readHeader(records, MAGIC_RECORDS, recordsHeader) ||
+        !readHeader(strings, MAGIC_STRINGS, stringsHeader)) {
+        DBG("LibraryDatabase::read: invalid database " << databaseFile.getFullPathName());
+        return false;
+    }
+    // files written at different times, offsets cannot be trusted
+    if (recordsHeader.generation != stringsHeader.generation) {
+        DBG("LibraryDatabase::read: records and string table do not match");
+        return false;
+    }
+
+    // a partly appended record at the end is ignored
+    auto* data = static_cast<const char*>(records.getData()) + sizeof(Header);
+    auto nRecords = (records.getSize() - sizeof(Header)) / sizeof(Record);
+    auto* text = static_cast<const char*>(strings.getData());
+    auto textSize = (int64)strings.getSize();
+
+    entries.reserve(entries.size() + nRecords);
+    for (size_t i = 0; i < nRecords; ++i) {
+        // copy out, the mapping gives no alignment guarantee
+        Record record;
+        memcpy(&record, data + i * sizeof(Record), sizeof(Record));
+
+        if (record.pathOffset < (int64)sizeof(Header) || record.pathLength <= 0 ||
+            record.pathOffset + record.pathLength > textSize) {
+            DBG("LibraryDatabase::read: skipping invalid record " << (int)i);
+            continue;
+        }
+
+        Entry entry;
+        entry.path = String::fromUTF8(text + record.pathOffset, record.pathLength);
+        entry.probed = (record.flags & FLAG_PROBED) != 0;
+        entry.fileSize = record.fileSize;
+        entry.modificationTime = record.modificationTime;
+        entry.duration = record.duration;
+        entry.sampleRate = record.sampleRate;
+        entry.numChannels = record.numChannels;
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+/******************************************
+* Name:
+*  append
+* Description:
+*  appends entries to the end of the database without
+*  rewriting it. Creates the database if needed.
+* Parameters:
+*  entries: entries to append
+* Output:
+*  true if appended
+*******************************************/
+bool LibraryDatabase::append(const std::vector<Entry>& entries) {
+    // start with an empty database
+    if (!exists() && !write({})) {
+        return false;
+    }
+
+    // existing files are opened at their end
+    FileOutputStream records(databaseFile);
+    FileOutputStream strings(stringsFile);
+    if (records.failedToOpen() || strings.failedToOpen()) {
+        DBG("LibraryDatabase::append: unable to open " << databaseFile.getFullPathName());
+        return false;
+    }
+
+    for (auto& entry : entries) {
+        writeEntry(records, strings, entry);
+    }
+    records.flush();
+    return records.getStatus().wasOk() && strings.getStatus().wasOk();
+}
+
+/******************************************
+* Name:
+*  write
+* Description:
+*  rewrites the whole database with the given entries,
+*  dropping removed tracks and any unused strings. Written
+*  to temporary files first, which then replace the database.
+* Parameters:
+*  entries: all entries of the library
+* Output:
+*  true if written
+*******************************************/
+bool LibraryDatabase::write(const std::vector<Entry>& entries) {
+    TemporaryFile tempRecords(databaseFile);
+    TemporaryFile tempStrings(stringsFile);
+    {
+        FileOutputStream records(tempRecords.getFile());
+        FileOutputStream strings(tempStrings.getFile());
+        if (records.failedToOpen() || strings.failedToOpen()) {
+            DBG("LibraryDatabase::write: unable to create " << databaseFile.getFullPathName());
+            return false;
+        }
+
+        // new generation, so a half replaced database is detected on read
+        auto generation = (uint32)Random::getSystemRandom().nextInt();
+        writeHeader(records, MAGIC_RECORDS, generation);
+        writeHeader(strings, MAGIC_STRINGS, generation);
+
+        for (auto& entry : entries) {
+            writeEntry(records, strings, entry);
+        }
+        records.flush();
+        strings.flush();
+        if (!records.getStatus().wasOk() || !strings.getStatus().wasOk()) {
+            DBG("LibraryDatabase::write: unable to write " << databaseFile.getFullPathName());
+            return false;
+        }
+    }
+    return tempStrings.overwriteTargetFileWithTemporary() &&
+        tempRecords.overwriteTargetFileWithTemporary();
+}
+
+/******************************************
+* Name:
+*  readHeader
+* Description:
+*  reads and checks the header at the start of a mapped file.
+* Parameters:
+*  file: the mapped file
+*  magic: expected type of file
+*  header: header to fill in
+* Output:
+*  true if the header is valid
+*******************************************/
+bool LibraryDatabase::readHeader(const MemoryMappedFile& file, uint32 magic, Header& header) {
+    if (file.getData() == nullptr || file.getSize() < sizeof(Header)) {
+        return false;
+    }
+    memcpy(&header, file.getData(), sizeof(Header));
+    return header.magic == magic && header.version == VERSION && header.recordSize == sizeof(Record);
+}
+
+/******************************************
+* Name:
+*  writeHeader
+* Description:
+*  writes the header at the start of a new file.
+* Parameters:
+*  stream: stream to write to
+*  magic: type of file
+*  generation: id shared by records and string table
+* Output:
+*  N/A
+*******************************************/
+void LibraryDatabase::writeHeader(OutputStream& stream, uint32 magic, uint32 generation) {
+    Header header{ magic, VERSION, (uint32)sizeof(Record), generation };
+    stream.write(&header, sizeof(Header));
+}
+
+/******************************************
+* Name:
+*  writeEntry
+* Description:
+*  writes the path of an entry to the end of the string
+*  table and then its record to the end of the records.
+* Parameters:
+*  records: stream of the records
+*  strings: stream of the string table
+*  entry: entry to write
+* Output:
+*  N/A
+*******************************************/
+void LibraryDatabase::writeEntry(OutputStream& records, OutputStream& strings, const Entry& entry) {
+    Record record{};
+    record.pathOffset = strings.getPosition();
+    record.pathLength = (int32)entry.path.getNumBytesAsUTF8();
+    record.flags = entry.probed ? FLAG_PROBED : 0;
+    record.fileSize = entry.fileSize;
+    record.modificationTime = entry.modificationTime;
+    record.duration = entry.duration;
+    record.sampleRate = entry.sampleRate;
+    record.numChannels = entry.numChannels;
+
+    // string first, so a record never points at a string not yet written
+    strings.write(entry.path.toRawUTF8(), (size_t)record.pathLength);
+    strings.flush();
+    records.write(&record, sizeof(Record));
+}
\ No newline at end of file
@@ -0,0 +1,208 @@
+/*
+  ==============================================================================
+
+    LibraryDatabase.h
+    Created: 17 Oct 2026 11:42:19pm
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+using namespace juce;
+
+class LibraryDatabase {
+public:
+    // a track of the library as stored in the database
+    struct Entry {
+        String path;                // full path of the track
+        int64 fileSize = 0;         // size of the file when probed
+        int64 modificationTime = 0; // modification time of the file when probed, in ms
+        double duration = 0.0;      // duration in seconds
+        double sampleRate = 0.0;    // sampling rate of the file
+        int numChannels = 0;        // no. of channels of the file
+        bool probed = false;        // if the metadata above is valid
+    };
+
+    // constructors & destructors
+    /******************************************
+    * Name:
+    *  LibraryDatabase
+    * Description:
+    *  constructor of the LibraryDatabase class. The library is
+    *  stored as a file of fixed-size records, and a string table
+    *  next to it holding the paths the records point into.
+    * Parameters:
+    *  databaseFile: file holding the records, the string table
+    *   is stored alongside with a different extension
+    * Output:
+    *  N/A
+    *******************************************/
+    LibraryDatabase(const File& databaseFile);
+
+    // methods
+    /******************************************
+    * Name:
+    *  exists
+    * Description:
+    *  checks if the database has been written before.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  true if both the records and the string table exist
+    *******************************************/
+    bool exists();
+
+    /******************************************
+    * Name:
+    *  isMissing
+    * Description:
+    *  checks if nothing of the database has been written yet,
+    *  as opposed to a database that exists but is damaged.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  true if neither the records nor the string table exist
+    *******************************************/
+    bool isMissing();
+
+    /******************************************
+    * Name:
+    *  backup
+    * Description:
+    *  renames the records and string table that exist by
+    *  appending EXTENSION_BACKUP, replacing any older backup,
+    *  so a damaged database is kept instead of overwritten.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  the backup of the records, or File() if a file could
+    *  not be renamed
+    *******************************************/
+    File backup();
+
+    /******************************************
+    * Name:
+    *  read
+    * Description:
+    *  memory maps the records and the string table and
+    *  reads every entry of the library. Records pointing
+    *  outside the string table are skipped.
+    * Parameters:
+    *  entries: vector the entries are added to
+    * Output:
+    *  true if read, false if the database is missing or invalid
+    *******************************************/
+    bool read(std::vector<Entry>& entries);
+
+    /******************************************
+    * Name:
+    *  append
+    * Description:
+    *  appends entries to the end of the database without
+    *  rewriting it. Creates the database if needed.
+    * Parameters:
+    *  entries: entries to append
+    * Output:
+    *  true if appended
+    *******************************************/
+    bool append(const std::vector<Entry>& entries);
+
+    /******************************************
+    * Name:
+    *  write
+    * Description:
+    *  rewrites the whole database with the given entries,
+    *  dropping removed tracks and any unused strings. Written
+    *  to temporary files first, which then replace the database.
+    * Parameters:
+    *  entries: all entries of the library
+    * Output:
+    *  true if written
+    *******************************************/
+    bool write(const std::vector<Entry>& entries);
+
+    // public constants
+    static const String EXTENSION_STRINGS;  // file extension of the string table
+    static const String EXTENSION_BACKUP;   // appended to the file names of a damaged database kept aside
+
+private:
+    // file header of both the records and the string table
+    struct Header {
+        uint32 magic;       // identifies the type of file
+        uint32 version;     // format version
+        uint32 recordSize;  // size of a record, in bytes
+        uint32 generation;  // id shared by records and string table written together
+    };
+
+    // fixed-size record of a track, in native byte order
+    struct Record {
+        int64 pathOffset;       // offset of the path in the string table, in bytes
+        int64 fileSize;         // size of the file when probed
+        int64 modificationTime; // modification time of the file when probed, in ms
+        double duration;        // duration in seconds
+        double sampleRate;      // sampling rate of the file
+        int32 pathLength;       // length of the UTF-8 path, in bytes
+        int32 numChannels;      // no. of channels of the file
+        uint32 flags;           // FLAG_ bits
+        uint32 reserved[3];     // unused, keeps the record at 64 bytes
+    };
+    static_assert(sizeof(Record) == 64, "LibraryDatabase::Record must be 64 bytes");
+
+    // methods
+    /******************************************
+    * Name:
+    *  readHeader
+    * Description:
+    *  reads and checks the header at the start of a mapped file.
+    * Parameters:
+    *  file: the mapped file
+    *  magic: expected type of file
+    *  header: header to fill in
+    * Output:
+    *  true if the header is valid
+    *******************************************/
+    static bool readHeader(const MemoryMappedFile& file, uint32 magic, Header& header);
+
+    /******************************************
+    * Name:
+    *  writeHeader
+    * Description:
+    *  writes the header at the start of a new file.
+    * Parameters:
+    *  stream: stream to write to
+    *  magic: type of file
+    *  generation: id shared by records and string table
+    * Output:
+    *  N/A
+    *******************************************/
+    static void writeHeader(OutputStream& stream, uint32 magic, uint32 generation);
+
+    /******************************************
+    * Name:
+    *  writeEntry
+    * Description:
+    *  writes the path of an entry to the end of the string
+    *  table and then its record to the end of the records.
+    * Parameters:
+    *  records: stream of the records
+    *  strings: stream of the string table
+    *  entry: entry to write
+    * Output:
+    *  N/A
+    *******************************************/
+    static void writeEntry(OutputStream& records, OutputStream& strings, const Entry& entry);
+
+    // functionality members
+    File databaseFile;  // file holding the records
+    File stringsFile;   // file holding the string table
+
+    // private constants
+    static const uint32 MAGIC_RECORDS = 0x4244544f; // "OTDB", identifies the records
+    static const uint32 MAGIC_STRINGS = 0x5453544f; // "OTST", identifies the string table
+    static const uint32 VERSION = 1;                // current format version
+    static const uint32 FLAG_PROBED = 1;            // record holds probed metadata
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LibraryDatabase)
+};
\ No newline at end of file
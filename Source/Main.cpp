@@ -8,6 +8,8 @@
 
 #include <JuceHeader.h>
 #include "MainComponent.h"
+#include "ResamplerAudioSource.h"
+#include "TimeStretchAudioSource.h"
 
 //==============================================================================
 class OtoDecksApplication  : public juce::JUCEApplication
@@ -25,6 +27,20 @@ public:
     {
         // This method is where you should put your application's initialisation code..
 
+        // measure the resampler or the stretcher instead of starting the app
+        if (getCommandLineParameterArray().contains (ResamplerAudioSource::ARG_BENCHMARK))
+        {
+            std::cout << ResamplerAudioSource::runBenchmark() << std::endl;
+            quit();
+            return;
+        }
+        if (getCommandLineParameterArray().contains (TimeStretchAudioSource::ARG_BENCHMARK))
+        {
+            std::cout << TimeStretchAudioSource::runBenchmark() << std::endl;
+            quit();
+            return;
+        }
+
         mainWindow.reset (new MainWindow (getApplicationName()));
     }
 
@@ -7,7 +7,9 @@
 * Description:
 *  Constructor for MainComponent class. add and make visible subcomponents.
 *  initialize audio format manager. set application window size and initialize
-*  audio system. load tracklist from config file.
+*  audio system. load tracklist from config file. renders with OpenGL if the
+*  app was started with the --opengl argument, the waveforms and spectra then
+*  being drawn by shaders underneath the components.
 * Parameters:
 *  N/A
 * Output:
@@ -16,9 +18,15 @@
 MainComponent::MainComponent():
     playerPool(formatManager),
     tracklist(formatManager),
-    cmpDeck(formatManager, thumbCache, tracklist, playerPool),
+    waveformRenderer(openGLContext, JUCEApplication::getCommandLineParameterArray().contains(ARG_OPENGL)),
+    waveformCache(formatManager, ConfigManager::getFile(ConfigManager::PATH_WAVEFORMS),
+        MAX_WAVEFORMS, (int64)SIZE_WAVEFORMS_DISK << 20),
+    cmpDeck(waveformCache, tracklist, playerPool, trackLoader, analysisThread, waveformRenderer),
     cmpPlaylist(tracklist, cmpDeck)
 {
+    // start the thread the decks' frequency displays are analysed on
+    analysisThread.startThread();
+
     // add and make visible sub components
     addAndMakeVisible(cmpDeck);
     addAndMakeVisible(cmpPlaylist);
@@ -41,16 +49,29 @@ MainComponent::MainComponent():
         setAudioChannels(0, 1);
     }
 
+    // build the waveforms of all tracks in the background, ready for when they are loaded
+    tracklist.onTracksAdded = [this](const StringArray& paths) { waveformCache.pregenerate(paths); };
+
     // load track list from config file
     tracklist.load();
+
+    // optionally render through OpenGL instead of the software renderer; the
+    // waveforms, playheads and spectra are drawn by shaders from data uploaded
+    // once, and the remaining components are composited on top of them
+    if (waveformRenderer.isEnabled()) {
+        waveformRenderer.setBackgroundColour(getLookAndFeel().findColour(ResizableWindow::backgroundColourId));
+        openGLContext.setRenderer(&waveformRenderer);
+        openGLContext.setComponentPaintingEnabled(true);
+        openGLContext.attachTo(*this);
+    }
 }
 
 /******************************************
 * Name:
 *  ~MainComponent
 * Description:
-*  Destructor for MainComponent. shutdown audio system and save
-*  tracklist to config file.
+*  Destructor for MainComponent. stop OpenGL rendering, shutdown audio
+*  system and save tracklist to config file.
 * Parameters:
 *  N/A
 * Output:
@@ -58,6 +79,9 @@ MainComponent::MainComponent():
 *******************************************/
 MainComponent::~MainComponent()
 {
+    // stop rendering before the subcomponents are destroyed
+    openGLContext.detach();
+
     // shutdown audio system
     shutdownAudio();
 
@@ -71,8 +95,8 @@ MainComponent::~MainComponent()
 *  prepareToPlay
 * Description:
 *  override for base class prepareToPlay. Initializes the audio system by
-*  preparing the mixer source and adding all the available DJAudioPlayers as
-*  input to the mixer source.
+*  preparing the mixer source, which in turn prepares all the DJAudioPlayers
+*  in the pool.
 * Parameters:
 *  samplesPerBlockExpected: no. of samples each getNextAudioBlock will process
 *  sampleRate: audio sampling rate
@@ -81,14 +105,8 @@ MainComponent::~MainComponent()
 *******************************************/
 void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
-    // prepare mixersource
+    // prepare mixer source and all DJAudioPlayer instances in the pool
     mixerSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-
-    // add available DJAudioPlayer instances as input to mixer source
-    for (auto i = 0; i < playerPool.size(); ++i) {
-        playerPool.getPlayer(i)->prepareToPlay(samplesPerBlockExpected, sampleRate);
-        mixerSource.addInputSource(playerPool.getPlayer(i), false);
-    }
 }
 
 /******************************************
@@ -97,7 +115,7 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
   * Description:
   *  override of base class getNextAudioBlock. start the audio processing chain
   *  going by requesting for sample from the mixer source which in turn will request
-  *  sample from each connected DJAudioPlayer.
+  *  sample from each active DJAudioPlayer.
   * Parameters:
   *  bufferToFill: file descriptor containing information for the read and write audio
   *   buffers.
@@ -115,8 +133,8 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
 *  releaseResources
 * Description:
 *  override of base class releaseResources, perform audio system cleanup.
-*  Remove all input source from mixer source and call its clean up method.
-*  Call cleanup of each available DJAudioPlayer instance.
+*  Call clean up method of the mixer source, which cleans up each
+*  DJAudioPlayer instance.
 * Parameters:
 *  N/A
 * Output:
@@ -124,14 +142,8 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
 *******************************************/
 void MainComponent::releaseResources()
 {
-    // remove all inputs from and cleanup mixer source
-    mixerSource.removeAllInputs();
+    // clean up mixer source and all DJAudioPlayers
     mixerSource.releaseResources();
-
-    // clean up all DJAudioPlayers
-    for (auto i = 0; i < playerPool.size(); ++i) {
-        playerPool.getPlayer(i)->releaseResources();
-    }
 }
 
 //==============================================================================
@@ -139,7 +151,8 @@ void MainComponent::releaseResources()
 * Name:
 *  paint
 * Description:
-*  override of base class paint method. Paints background.
+*  override of base class paint method. Paints background, unless
+*  rendering with OpenGL where the renderer clears to it.
 * Parameters:
 *  g: reference to Graphics used for drawing
 * Output:
@@ -147,6 +160,11 @@ void MainComponent::releaseResources()
 *******************************************/
 void MainComponent::paint (juce::Graphics& g)
 {
+    // the renderer has cleared to the background underneath
+    if (waveformRenderer.isEnabled()) {
+        return;
+    }
+
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
 }
 
@@ -169,3 +187,5 @@ void MainComponent::resized()
     cmpDeck.setBounds(usableArea);
     cmpPlaylist.setBounds(playlistArea);
 }
+
+const String MainComponent::ARG_OPENGL = "--opengl";
\ No newline at end of file
@@ -7,6 +7,11 @@ using namespace juce;
 #include "DeckComponent.h"
 #include "TrackCollection.h"
 #include "PlayerPool.h"
+#include "ActiveMixerSource.h"
+#include "TrackLoader.h"
+#include "WaveformCache.h"
+#include "ConfigManager.h"
+#include "WaveformRenderer.h"
 
 class MainComponent : public juce::AudioAppComponent,
     public DragAndDropContainer
@@ -20,7 +25,9 @@ public:
     * Description:
     *  Constructor for MainComponent class. add and make visible subcomponents.
     *  initialize audio format manager. set application window size and initialize
-    *  audio system. load tracklist from config file.
+    *  audio system. load tracklist from config file. renders with OpenGL if the
+    *  app was started with the --opengl argument, the waveforms and spectra then
+    *  being drawn by shaders underneath the components.
     * Parameters:
     *  N/A
     * Output:
@@ -32,8 +39,8 @@ public:
     * Name:
     *  ~MainComponent
     * Description:
-    *  Destructor for MainComponent. shutdown audio system and save
-    *  tracklist to config file.
+    *  Destructor for MainComponent. stop OpenGL rendering, shutdown audio
+    *  system and save tracklist to config file.
     * Parameters:
     *  N/A
     * Output:
@@ -47,8 +54,8 @@ public:
     *  prepareToPlay
     * Description:
     *  override for base class prepareToPlay. Initializes the audio system by
-    *  preparing the mixer source and adding all the available DJAudioPlayers as 
-    *  input to the mixer source.
+    *  preparing the mixer source, which in turn prepares all the DJAudioPlayers
+    *  in the pool.
     * Parameters:
     *  samplesPerBlockExpected: no. of samples each getNextAudioBlock will process
     *  sampleRate: audio sampling rate
@@ -63,7 +70,7 @@ public:
     * Description:
     *  override of base class getNextAudioBlock. start the audio processing chain
     *  going by requesting for sample from the mixer source which in turn will request
-    *  sample from each connected DJAudioPlayer.
+    *  sample from each active DJAudioPlayer.
     * Parameters:
     *  bufferToFill: file descriptor containing information for the read and write audio 
     *   buffers.
@@ -77,8 +84,8 @@ public:
     *  releaseResources
     * Description:
     *  override of base class releaseResources, perform audio system cleanup.
-    *  Remove all input source from mixer source and call its clean up method.
-    *  Call cleanup of each available DJAudioPlayer instance.
+    *  Call clean up method of the mixer source, which cleans up each
+    *  DJAudioPlayer instance.
     * Parameters:
     *  N/A
     * Output:
@@ -90,7 +97,8 @@ public:
     * Name:
     *  paint
     * Description:
-    *  override of base class paint method. Paints background.
+    *  override of base class paint method. Paints background, unless
+    *  rendering with OpenGL where the renderer clears to it.
     * Parameters:
     *  g: reference to Graphics used for drawing
     * Output:
@@ -116,18 +124,26 @@ public:
     static const int HEIGHT_APP = 1124; // app window height
     static const int HEIGHT_PLAYLIST = 256; // playlist height
     static const int PADDING = 5;   // padding between window edge and subcomponents
+    static const String ARG_OPENGL; // command line argument enabling OpenGL rendering
+    static const int MAX_WAVEFORMS = 16;    // no. of tracks to keep waveform peaks of in memory
+    static const int SIZE_WAVEFORMS_DISK = 512; // max. size of the waveform peaks kept on disk, in MB
 
 private:
     //==============================================================================
         
     // functionality components
-    MixerAudioSource mixerSource; // mixer source
+    AudioFormatManager formatManager;   // audio format manager to load resources with, declared
+                                        // first as the components below use it from worker threads
     PlayerPool playerPool;  // pool of DJAudioPlayer isntances
+    ActiveMixerSource mixerSource{ playerPool }; // mixer source, only mixes active players
     TrackCollection tracklist;  // track list 
+    TrackLoader trackLoader;    // loads tracks for the decks in the background
+    TimeSliceThread analysisThread{ "OtoDecks analysis" };  // shared thread performing the decks' FFTs
 
     // GUI components
-    AudioFormatManager formatManager;   // audio format manager to load resources with
-    AudioThumbnailCache thumbCache{ 100 };  // thumbnail cache for waveform display
+    OpenGLContext openGLContext;    // renders the whole window on the GPU, if enabled
+    WaveformRenderer waveformRenderer;  // draws the decks' waveforms and spectra on the GPU, if enabled
+    WaveformCache waveformCache;    // waveform peaks for waveform display
     PlaylistComponent cmpPlaylist;  // playlist component
     DeckComponent cmpDeck;  // deck component
     TooltipWindow tooltipWindow; // require an instance of this to make Tooltips work int he app.
@@ -24,9 +24,29 @@
 PlayerPool::PlayerPool(AudioFormatManager &formatManager) {
     // create new dynamically allocated players and add them to the pointer array
     for (auto i = 0; i < N; ++i) {
-        players.add(new DJAudioPlayer(formatManager, i));
+        players.add(new DJAudioPlayer(formatManager, readAheadThread, i));
         availablePlayers.push(i);
     }
+
+    // start decoding ahead for the players
+    readAheadThread.startThread();
+}
+
+/******************************************
+* Name:
+*  ~PlayerPool
+* Description:
+*  destructor of the PlayerPool class. Deletes all players
+*  before stopping the shared read-ahead thread they decode on.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+PlayerPool::~PlayerPool() {
+    // players remove their sources from the thread when deleted
+    players.clear();
+    readAheadThread.stopThread(1000);
 }
 
 /******************************************
@@ -62,9 +82,28 @@ DJAudioPlayer* PlayerPool::getAvailablePlayer() {
     // dequeue a id and return the associated player
     auto id = availablePlayers.front();
     availablePlayers.pop();
+
+    // mark player as active so the mixer starts rendering it
+    activePlayers.fetch_or(1u << id);
     return players[id];
 }
 
+/******************************************
+* Name:
+*  getActivePlayers
+* Description:
+*  getter for the set of players currently taken from the pool,
+*  as a bit mask indexed by player id. Safe to call from the
+*  audio thread.
+* Parameters:
+*  N/A
+* Output:
+*  bit mask of active player ids
+*******************************************/
+uint32 PlayerPool::getActivePlayers() {
+    return activePlayers.load();
+}
+
 /******************************************
 * Name:
 *  size
@@ -91,6 +130,9 @@ int PlayerPool::size() {
 *  N/A
 *******************************************/
 void PlayerPool::releasePlayer(int id) {
+    // mark player as inactive so the mixer stops rendering it
+    activePlayers.fetch_and(~(1u << id));
+
     // enqueue a returned player's id to make it available
     availablePlayers.push(id);
 }
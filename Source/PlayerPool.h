@@ -30,6 +30,19 @@ public:
     *******************************************/
     PlayerPool(AudioFormatManager &formatManager);
 
+    /******************************************
+    * Name:
+    *  ~PlayerPool
+    * Description:
+    *  destructor of the PlayerPool class. Deletes all players
+    *  before stopping the shared read-ahead thread they decode on.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    ~PlayerPool();
+
     // getters & setters
     /******************************************
     * Name:
@@ -56,6 +69,20 @@ public:
     *******************************************/
     DJAudioPlayer* getAvailablePlayer();
 
+    /******************************************
+    * Name:
+    *  getActivePlayers
+    * Description:
+    *  getter for the set of players currently taken from the pool,
+    *  as a bit mask indexed by player id. Safe to call from the
+    *  audio thread.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  bit mask of active player ids
+    *******************************************/
+    uint32 getActivePlayers();
+
     // methods
     /******************************************
     * Name:
@@ -84,9 +111,14 @@ public:
 
     // public constants
     static const int N = 16;    // total number of players in the pool
+    static_assert(N <= 32, "active players are tracked in a 32-bit mask");
 
 private:
     // functionality members
+    TimeSliceThread readAheadThread{ "OtoDecks read-ahead" };   // shared thread that decodes
+                                                                // ahead for all players
     OwnedArray<DJAudioPlayer> players;  // pointer array to all players
     std::queue<int> availablePlayers;   // queue used to control the pool
+    std::atomic<uint32> activePlayers{ 0 };  // bit mask of players taken from the pool,
+                                            // read by the audio thread
 };
\ No newline at end of file
@@ -26,7 +26,7 @@
 *  N/A
 *******************************************/
 PlaylistComponent::PlaylistComponent(TrackCollection& _tracklist, DeckComponent& _deck):
-    tracklist(_tracklist), deck(_deck)
+    tracklist(_tracklist), importer(_tracklist), deck(_deck)
 {
     // setup, add and display sub components
     lblTitle.setText("Playlist", dontSendNotification);
@@ -51,6 +51,24 @@ PlaylistComponent::PlaylistComponent(TrackCollection& _tracklist, DeckComponent&
     btnRemove.setTooltip("Clear search term");
     btnRemove.onClick = [this] {removeButtonClicked(); };
     addAndMakeVisible(btnRemove);
+
+    // redraw when track metadata has been probed or tracks imported
+    tracklist.addChangeListener(this);
+}
+
+/******************************************
+* Name:
+*  ~PlaylistComponent
+* Description:
+*  Destructor for the PlaylistComponent. Removes self as
+*  change listener from the track list.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+PlaylistComponent::~PlaylistComponent() {
+    tracklist.removeChangeListener(this);
 }
 
 /******************************************
@@ -236,6 +254,7 @@ bool PlaylistComponent::isInterestedInFileDrag(const StringArray& files) {
 * Description:
 *  Handler to act on the files that are dropped on the component, adding
 *  them to track list if they are audio files that can be loaded.
+*  Dropped folders are imported recursively in the background.
 * Parameters:
 *  files: array of full path of files dropped on the component
 *  x: Not Used.
@@ -244,14 +263,81 @@ bool PlaylistComponent::isInterestedInFileDrag(const StringArray& files) {
 *  N/A
 *******************************************/
 void PlaylistComponent::filesDropped(const StringArray& files, int x, int y) {
+    // folders are walked in the background, files are added straight away
+    Array<File> folders;
+    StringArray tracks;
+    for (auto f : files) {
+        if (File(f).isDirectory()) {
+            folders.add(File(f));
+        }
+        else {
+            tracks.add(f);
+        }
+    }
+    importer.importAsync(folders);
+
     // add tracks to track list
-    tracklist.addTracks(files);
+    tracklist.addTracks(tracks);
 
     // update table list component and redraw
     tableComponent.updateContent();
     tableComponent.repaint();
 }
 
+/******************************************
+* Name:
+*  changeListenerCallback
+* Description:
+*  Implementation of virtual method of ChangeListener. Called when
+*  the track list has probed the metadata of some tracks or imported
+*  tracks from a folder, updates and redraws the table.
+* Parameters:
+*  src: Not Used.
+* Output:
+*  N/A
+*******************************************/
+void PlaylistComponent::changeListenerCallback(ChangeBroadcaster* src) {
+    // pick up added tracks, only visible rows are repainted
+    tableComponent.updateContent();
+    tableComponent.repaint();
+}
+
+/******************************************
+* Name:
+*  timerCallback
+* Description:
+*  implementation of the virtual timerCallback method. Called
+*  once typing in the search box has paused, starts searching
+*  the track list in the background.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void PlaylistComponent::timerCallback() {
+    stopTimer();
+
+    // get lowercase of search term
+    auto keyword = txtSearch.getText().toLowerCase();
+
+    // select tracks based on search term, the table is only updated with the latest result
+    SafePointer<PlaylistComponent> safeThis(this);
+    tracklist.selectTracksAsync(keyword, [safeThis](std::shared_ptr<TrackCollection::SearchResult> result) {
+        // playlist closed meanwhile
+        if (safeThis == nullptr) {
+            return;
+        }
+        // tracks changed while searching, search again
+        if (!safeThis->tracklist.setSelectedTracks(*result)) {
+            safeThis->startTimer(DELAY_SEARCH);
+            return;
+        }
+        // update table list component and redraw based on search result
+        safeThis->tableComponent.updateContent();
+        safeThis->tableComponent.repaint();
+    });
+}
+
 /******************************************
 * Name:
 *  getDragSourceDescription
@@ -306,7 +392,8 @@ void PlaylistComponent::addButtonClicked() {
 *  N/A
 *******************************************/
 void PlaylistComponent::removeButtonClicked() {
-    // clear previous search result
+    // cancel pending search and clear previous search result
+    stopTimer();
     tracklist.clearSelectedTracks();
 
     // reset search box
@@ -322,8 +409,8 @@ void PlaylistComponent::removeButtonClicked() {
 *  searchTextChanged
 * Description:
 *  event handler for when the search text editor's text has changed.
-*  performs case-insenstive text with the track list to display only
-*  tracks that match the search term.
+*  restarts the search delay, so the search is only performed once
+*  typing pauses. Clearing the search box shows all tracks at once.
 * Parameters:
 *  N/A
 * Output:
@@ -331,13 +418,15 @@ void PlaylistComponent::removeButtonClicked() {
 *******************************************/
 
 void PlaylistComponent::searchTextChanged() {
-    // get lowercase of search term
-    auto keyword = txtSearch.getText().toLowerCase();
-
-    // select tracks based on search term
-    tracklist.selectTracks(keyword);
+    // empty search term, show all tracks straight away
+    if (txtSearch.getText().isEmpty()) {
+        stopTimer();
+        tracklist.clearSelectedTracks();
+        tableComponent.updateContent();
+        tableComponent.repaint();
+        return;
+    }
 
-    // update table list component and redraw based on search result
-    tableComponent.updateContent();
-    tableComponent.repaint();
+    // (re)start the delay, search once typing pauses
+    startTimer(DELAY_SEARCH);
 }
\ No newline at end of file
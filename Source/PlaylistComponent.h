@@ -17,13 +17,16 @@ using namespace juce;
 
 #include "AddButton.h"
 #include "TrackCollection.h"
+#include "FolderImporter.h"
 #include "DeckComponent.h"
 #include "RemoveButton.h"
 
 //==============================================================================
 class PlaylistComponent  : public Component,
     public TableListBoxModel,
-    public FileDragAndDropTarget
+    public FileDragAndDropTarget,
+    public ChangeListener,
+    public Timer
 {
 public:
     // constructors & destructors
@@ -41,6 +44,19 @@ public:
     *******************************************/
     PlaylistComponent(TrackCollection& tracklist, DeckComponent& deck);
 
+    /******************************************
+    * Name:
+    *  ~PlaylistComponent
+    * Description:
+    *  Destructor for the PlaylistComponent. Removes self as
+    *  change listener from the track list.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    ~PlaylistComponent() override;
+
     // base class overrides
     /******************************************
     * Name:
@@ -164,6 +180,7 @@ public:
     * Description:
     *  Handler to act on the files that are dropped on the component, adding
     *  them to track list if they are audio files that can be loaded.
+    *  Dropped folders are imported recursively in the background.
     * Parameters:
     *  files: array of full path of files dropped on the component
     *  x: Not Used.
@@ -173,6 +190,36 @@ public:
     *******************************************/
     void filesDropped(const StringArray& files, int x, int y) override;
 
+    // ChangeListener overrides
+    /******************************************
+    * Name:
+    *  changeListenerCallback
+    * Description:
+    *  Implementation of virtual method of ChangeListener. Called when
+    *  the track list has probed the metadata of some tracks or imported
+    *  tracks from a folder, updates and redraws the table.
+    * Parameters:
+    *  src: Not Used.
+    * Output:
+    *  N/A
+    *******************************************/
+    void changeListenerCallback(ChangeBroadcaster* src) override;
+
+    // Timer overrides
+    /******************************************
+    * Name:
+    *  timerCallback
+    * Description:
+    *  implementation of the virtual timerCallback method. Called
+    *  once typing in the search box has paused, starts searching
+    *  the track list in the background.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void timerCallback() override;
+
     // DragAndDropContainer subclass handler
     /******************************************
     * Name:
@@ -218,8 +265,8 @@ public:
     *  searchTextChanged
     * Description:
     *  event handler for when the search text editor's text has changed.
-    *  performs case-insenstive text with the track list to display only
-    *  tracks that match the search term.
+    *  restarts the search delay, so the search is only performed once
+    *  typing pauses. Clearing the search box shows all tracks at once.
     * Parameters:
     *  N/A
     * Output:
@@ -237,10 +284,12 @@ public:
     static const int ID_FILENAME = 1;   // column id for filename output
     static const int ID_DURATION = 2;   // column id for duration output
     static const int ID_OPERATIONS = 3; // column id for operations
+    static const int DELAY_SEARCH = 150;    // delay in ms after typing before searching
 
 private:
     // functionality members
     TrackCollection& tracklist; // reference to global TrackCollection
+    FolderImporter importer;    // imports dropped folders in the background
 
     // GUI members
     Label lblTitle; // label used to display playlist title
@@ -0,0 +1,341 @@
+/*
+  ==============================================================================
+
+    ReadAheadAudioSource.cpp
+    Created: 17 Oct 2026 9:48:03pm
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#include "ReadAheadAudioSource.h"
+
+/******************************************
+* Name:
+*  ReadAheadAudioSource
+* Description:
+*  constructor of the ReadAheadAudioSource class. Takes ownership
+*  of the reader and allocates the ring buffer that the background
+*  thread decodes into ahead of the playback position.
+* Parameters:
+*  reader: reader of the audio file, deleted with this source
+*  thread: shared background thread used to decode ahead
+*  bufferSize: no. of samples to keep decoded ahead
+* Output:
+*  N/A
+*******************************************/
+ReadAheadAudioSource::ReadAheadAudioSource(AudioFormatReader* _reader, TimeSliceThread& _thread,
+    int bufferSize) :
+    reader(_reader),
+    thread(_thread),
+    isPrepared(false)
+{
+    // allocate ring buffer, at least one chunk long
+    ring.setSize(N_CHANNELS, jmax(bufferSize, SIZE_CHUNK));
+    ring.clear();
+}
+
+/******************************************
+* Name:
+*  ~ReadAheadAudioSource
+* Description:
+*  destructor of the ReadAheadAudioSource class, stops decoding
+*  by removing self from the background thread.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+ReadAheadAudioSource::~ReadAheadAudioSource() {
+    // blocks until the background thread is done with this source
+    thread.removeTimeSliceClient(this);
+}
+
+/******************************************
+* Name:
+*  prepareToPlay
+* Description:
+*  override of the base class prepareToPlay method. Grows the ring
+*  buffer if the block size requires it and starts decoding on the
+*  background thread.
+* Parameters:
+*  samplesPerBlockExpected: no. of samples to return on each getNextAudioBlock call
+*  sampleRate: audio sampling rate
+* Output:
+*  N/A
+*******************************************/
+void ReadAheadAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    // ring buffer must hold at least two blocks
+    auto sizeNeeded = jmax(samplesPerBlockExpected * 2, ring.getNumSamples());
+
+    // nothing to do if already decoding into a large enough buffer
+    if (isPrepared && sizeNeeded == ring.getNumSamples()) {
+        return;
+    }
+
+    // stop decoding while the buffer is resized and restart from the playback position
+    thread.removeTimeSliceClient(this);
+    ring.setSize(N_CHANNELS, sizeNeeded);
+    validStart.store(nextPlayPos.load());
+    validEnd.store(nextPlayPos.load());
+    thread.addTimeSliceClient(this);
+    isPrepared = true;
+}
+
+/******************************************
+* Name:
+*  releaseResources
+* Description:
+*  override of the base class releaseResources method. Stops
+*  decoding on the background thread.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void ReadAheadAudioSource::releaseResources() {
+    thread.removeTimeSliceClient(this);
+    isPrepared = false;
+}
+
+/******************************************
+* Name:
+*  getNextAudioBlock
+* Description:
+*  override of the base class getNextAudioBlock method. Only copies
+*  already decoded samples out of the ring buffer; never decodes or
+*  locks. Any part of the block that is not decoded yet is output as
+*  silence and counted as an underrun.
+* Parameters:
+*  bufferToFill: a descriptor representing the read and write audio buffers.
+* Output:
+*  N/A
+*******************************************/
+void ReadAheadAudioSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) {
+    auto pos = nextPlayPos.load();
+    auto n = bufferToFill.numSamples;
+    auto start = validStart.load();
+    auto end = validEnd.load();
+    auto size = ring.getNumSamples();
+    auto nChannels = jmin(bufferToFill.buffer->getNumChannels(), N_CHANNELS);
+
+    // no. of samples of this block already decoded
+    auto ready = 0;
+    if (pos >= start && pos < end) {
+        ready = (int)jmin((int64)n, end - pos);
+    }
+
+    // copy decoded samples, in two parts if they wrap around the end of the ring
+    if (ready > 0) {
+        auto offset = (int)(((pos % size) + size) % size);
+        auto n1 = jmin(ready, size - offset);
+        for (auto ch = 0; ch < nChannels; ++ch) {
+            bufferToFill.buffer->copyFrom(ch, bufferToFill.startSample, ring, ch, offset, n1);
+            if (n1 < ready) {
+                bufferToFill.buffer->copyFrom(ch, bufferToFill.startSample + n1, ring, ch, 0,
+                    ready - n1);
+            }
+        }
+    }
+
+    // fill the rest with silence, counting an underrun if it is not past the end of file
+    if (ready < n) {
+        bufferToFill.buffer->clear(bufferToFill.startSample + ready, n - ready);
+        if (jmin(pos + n, getTotalLength()) > pos + ready) {
+            underruns.fetch_add(1);
+        }
+    }
+
+    // clear any channels not held in the ring
+    for (auto ch = nChannels; ch < bufferToFill.buffer->getNumChannels(); ++ch) {
+        bufferToFill.buffer->clear(ch, bufferToFill.startSample, n);
+    }
+
+    // advance playback position, unless a seek happened meanwhile
+    nextPlayPos.compare_exchange_strong(pos, pos + n);
+}
+
+/******************************************
+* Name:
+*  setNextReadPosition
+* Description:
+*  override of the base class setNextReadPosition method. Moves the
+*  playback position and wakes up the background thread so it can
+*  refill the ring buffer from the new position.
+* Parameters:
+*  newPosition: new playback position in samples
+* Output:
+*  N/A
+*******************************************/
+void ReadAheadAudioSource::setNextReadPosition(int64 newPosition) {
+    nextPlayPos.store(newPosition);
+    thread.moveToFrontOfQueue(this);
+}
+
+/******************************************
+* Name:
+*  getNextReadPosition
+* Description:
+*  override of the base class getNextReadPosition method.
+* Parameters:
+*  N/A
+* Output:
+*  current playback position in samples
+*******************************************/
+int64 ReadAheadAudioSource::getNextReadPosition() const {
+    return nextPlayPos.load();
+}
+
+/******************************************
+* Name:
+*  getTotalLength
+* Description:
+*  override of the base class getTotalLength method.
+* Parameters:
+*  N/A
+* Output:
+*  total length of the audio file in samples
+*******************************************/
+int64 ReadAheadAudioSource::getTotalLength() const {
+    return reader->lengthInSamples;
+}
+
+/******************************************
+* Name:
+*  isLooping
+* Description:
+*  override of the base class isLooping method. Looping
+*  is not supported.
+* Parameters:
+*  N/A
+* Output:
+*  always false
+*******************************************/
+bool ReadAheadAudioSource::isLooping() const {
+    return false;
+}
+
+/******************************************
+* Name:
+*  prime
+* Description:
+*  starts decoding on the background thread and waits until the
+*  given no. of samples from the playback position are decoded, so
+*  playback can start without underruns. Must not be called from the
+*  audio or message thread.
+* Parameters:
+*  numSamples: no. of samples to decode before returning
+*  shouldCancel: polled while waiting, stops the wait when it returns true
+* Output:
+*  true if primed, false if the wait timed out or was cancelled
+*******************************************/
+bool ReadAheadAudioSource::prime(int numSamples, std::function<bool()> shouldCancel) {
+    // start decoding, keeping the current buffer size
+    prepareToPlay(0, getSampleRate());
+
+    // cannot decode more than the ring holds or past the end of file
+    auto pos = nextPlayPos.load();
+    auto target = jmin((int64)jmin(numSamples, ring.getNumSamples()), getTotalLength() - pos);
+
+    // wait for the background thread to decode the target no. of samples
+    auto startTime = Time::getMillisecondCounter();
+    while (validEnd.load() - pos < target) {
+        if (Time::getMillisecondCounter() - startTime > (uint32)TIMEOUT_PRIME) {
+            DBG("ReadAheadAudioSource::prime: timed out");
+            return false;
+        }
+        if (shouldCancel && shouldCancel()) {
+            return false;
+        }
+        thread.moveToFrontOfQueue(this);
+        Thread::sleep(2);
+    }
+    return true;
+}
+
+/******************************************
+* Name:
+*  getSampleRate
+* Description:
+*  getter for the sampling rate of the audio file.
+* Parameters:
+*  N/A
+* Output:
+*  sampling rate of the audio file
+*******************************************/
+double ReadAheadAudioSource::getSampleRate() {
+    return reader->sampleRate;
+}
+
+/******************************************
+* Name:
+*  getUnderrunCount
+* Description:
+*  getter for the number of blocks that could not be
+*  fully served from the ring buffer.
+* Parameters:
+*  N/A
+* Output:
+*  no. of underruns since the source was created
+*******************************************/
+int ReadAheadAudioSource::getUnderrunCount() {
+    return underruns.load();
+}
+
+/******************************************
+* Name:
+*  useTimeSlice
+* Description:
+*  called by the background thread. Frees the part of the ring buffer
+*  that has been played, restarts from the playback position after a
+*  seek, and decodes more samples into the free space.
+* Parameters:
+*  N/A
+* Output:
+*  no. of milliseconds until the thread should call again
+*******************************************/
+int ReadAheadAudioSource::useTimeSlice() {
+    auto size = ring.getNumSamples();
+    auto total = getTotalLength();
+    auto pos = nextPlayPos.load();
+    auto start = validStart.load();
+    auto end = validEnd.load();
+
+    // playback position moved outside the decoded range (seek), start over from it
+    if (pos < start || pos > end) {
+        validEnd.store(pos);
+        validStart.store(pos);
+        start = pos;
+        end = pos;
+    }
+    // otherwise free the samples that have already been played
+    else if (pos > start) {
+        validStart.store(pos);
+        start = pos;
+    }
+
+    // decode chunk by chunk into the free space of the ring
+    auto decoded = false;
+    for (auto i = 0; i < 8; ++i) {
+        auto n = (int)jmin((int64)SIZE_CHUNK, start + size - end, total - end);
+        if (n <= 0) {
+            break;
+        }
+
+        // write in two parts if the chunk wraps around the end of the ring
+        auto offset = (int)(((end % size) + size) % size);
+        auto n1 = jmin(n, size - offset);
+        reader->read(&ring, offset, n1, end, true, true);
+        if (n1 < n) {
+            reader->read(&ring, 0, n - n1, end + n1, true, true);
+        }
+
+        // publish decoded samples to the audio thread
+        end += n;
+        validEnd.store(end);
+        decoded = true;
+    }
+
+    // come back soon if there is more to decode, otherwise poll for playback progress
+    return decoded ? 1 : 10;
+}
\ No newline at end of file
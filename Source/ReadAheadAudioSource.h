@@ -0,0 +1,222 @@
+/*
+  ==============================================================================
+
+    ReadAheadAudioSource.h
+    Created: 17 Oct 2026 9:48:03pm
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+using namespace juce;
+
+class ReadAheadAudioSource : public PositionableAudioSource,
+    private TimeSliceClient
+{
+public:
+    // constructors & destructors
+    /******************************************
+    * Name:
+    *  ReadAheadAudioSource
+    * Description:
+    *  constructor of the ReadAheadAudioSource class. Takes ownership
+    *  of the reader and allocates the ring buffer that the background
+    *  thread decodes into ahead of the playback position.
+    * Parameters:
+    *  reader: reader of the audio file, deleted with this source
+    *  thread: shared background thread used to decode ahead
+    *  bufferSize: no. of samples to keep decoded ahead
+    * Output:
+    *  N/A
+    *******************************************/
+    ReadAheadAudioSource(AudioFormatReader* reader, TimeSliceThread& thread, int bufferSize);
+
+    /******************************************
+    * Name:
+    *  ~ReadAheadAudioSource
+    * Description:
+    *  destructor of the ReadAheadAudioSource class, stops decoding
+    *  by removing self from the background thread.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    ~ReadAheadAudioSource() override;
+
+    // base class overrides
+    /******************************************
+    * Name:
+    *  prepareToPlay
+    * Description:
+    *  override of the base class prepareToPlay method. Grows the ring
+    *  buffer if the block size requires it and starts decoding on the
+    *  background thread.
+    * Parameters:
+    *  samplesPerBlockExpected: no. of samples to return on each getNextAudioBlock call
+    *  sampleRate: audio sampling rate
+    * Output:
+    *  N/A
+    *******************************************/
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /******************************************
+    * Name:
+    *  releaseResources
+    * Description:
+    *  override of the base class releaseResources method. Stops
+    *  decoding on the background thread.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void releaseResources() override;
+
+    /******************************************
+    * Name:
+    *  getNextAudioBlock
+    * Description:
+    *  override of the base class getNextAudioBlock method. Only copies
+    *  already decoded samples out of the ring buffer; never decodes or
+    *  locks. Any part of the block that is not decoded yet is output as
+    *  silence and counted as an underrun.
+    * Parameters:
+    *  bufferToFill: a descriptor representing the read and write audio buffers.
+    * Output:
+    *  N/A
+    *******************************************/
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    /******************************************
+    * Name:
+    *  setNextReadPosition
+    * Description:
+    *  override of the base class setNextReadPosition method. Moves the
+    *  playback position and wakes up the background thread so it can
+    *  refill the ring buffer from the new position.
+    * Parameters:
+    *  newPosition: new playback position in samples
+    * Output:
+    *  N/A
+    *******************************************/
+    void setNextReadPosition(int64 newPosition) override;
+
+    /******************************************
+    * Name:
+    *  getNextReadPosition
+    * Description:
+    *  override of the base class getNextReadPosition method.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  current playback position in samples
+    *******************************************/
+    int64 getNextReadPosition() const override;
+
+    /******************************************
+    * Name:
+    *  getTotalLength
+    * Description:
+    *  override of the base class getTotalLength method.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  total length of the audio file in samples
+    *******************************************/
+    int64 getTotalLength() const override;
+
+    /******************************************
+    * Name:
+    *  isLooping
+    * Description:
+    *  override of the base class isLooping method. Looping
+    *  is not supported.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  always false
+    *******************************************/
+    bool isLooping() const override;
+
+    // methods
+    /******************************************
+    * Name:
+    *  prime
+    * Description:
+    *  starts decoding on the background thread and waits until the
+    *  given no. of samples from the playback position are decoded, so
+    *  playback can start without underruns. Must not be called from the
+    *  audio or message thread.
+    * Parameters:
+    *  numSamples: no. of samples to decode before returning
+    *  shouldCancel: polled while waiting, stops the wait when it returns true
+    * Output:
+    *  true if primed, false if the wait timed out or was cancelled
+    *******************************************/
+    bool prime(int numSamples, std::function<bool()> shouldCancel = nullptr);
+
+    // getters & setters
+    /******************************************
+    * Name:
+    *  getSampleRate
+    * Description:
+    *  getter for the sampling rate of the audio file.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  sampling rate of the audio file
+    *******************************************/
+    double getSampleRate();
+
+    /******************************************
+    * Name:
+    *  getUnderrunCount
+    * Description:
+    *  getter for the number of blocks that could not be
+    *  fully served from the ring buffer.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  no. of underruns since the source was created
+    *******************************************/
+    int getUnderrunCount();
+
+    // public constants
+    static const int TIMEOUT_PRIME = 5000;  // max. time in ms to wait for priming
+
+private:
+    // TimeSliceClient overrides
+    /******************************************
+    * Name:
+    *  useTimeSlice
+    * Description:
+    *  called by the background thread. Frees the part of the ring buffer
+    *  that has been played, restarts from the playback position after a
+    *  seek, and decodes more samples into the free space.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  no. of milliseconds until the thread should call again
+    *******************************************/
+    int useTimeSlice() override;
+
+    // functionality members
+    std::unique_ptr<AudioFormatReader> reader;  // reader of the audio file
+    TimeSliceThread& thread;    // shared background thread that decodes ahead
+    AudioBuffer<float> ring;    // ring buffer of decoded samples
+    std::atomic<int64> nextPlayPos{ 0 };    // playback position
+    std::atomic<int64> validStart{ 0 };     // first decoded sample held in the ring
+    std::atomic<int64> validEnd{ 0 };       // one past the last decoded sample held in the ring
+    std::atomic<int> underruns{ 0 };        // no. of underruns
+    bool isPrepared;    // if the source is registered with the background thread
+
+    // private constants
+    static const int SIZE_CHUNK = 2048; // no. of samples decoded at a time
+    static const int N_CHANNELS = 2;    // no. of channels held in the ring buffer
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReadAheadAudioSource)
+};
\ No newline at end of file
@@ -0,0 +1,442 @@
+/*
+  ==============================================================================
+
+    ResamplerAudioSource.cpp
+    Created: 18 Oct 2026 7:05:31am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#include "ResamplerAudioSource.h"
+
+/******************************************
+* Name:
+*  ResamplerAudioSource
+* Description:
+*  constructor of the ResamplerAudioSource class. Plays the input
+*  source back at a different rate, interpolating with the selected
+*  quality. Precomputes the windowed sinc table.
+* Parameters:
+*  source: input audio source, not owned
+* Output:
+*  N/A
+*******************************************/
+ResamplerAudioSource::ResamplerAudioSource(AudioSource* _source) :
+    source(_source),
+    numInput(0),
+    readPos(0.0)
+{
+    // one side of a Blackman windowed sinc, plus a zero entry so the last
+    // entry can be interpolated
+    auto size = N_ZEROS * N_PHASES;
+    sincTable.allocate(size + 1, true);
+    sincTable[0] = 1.0f;
+    for (auto i = 1; i < size; ++i) {
+        auto x = MathConstants<double>::pi * i / N_PHASES;
+        auto u = MathConstants<double>::pi * i / size;
+        auto window = 0.42 + 0.5 * std::cos(u) + 0.08 * std::cos(2.0 * u);
+        sincTable[i] = (float)(std::sin(x) / x * window);
+    }
+}
+
+/******************************************
+* Name:
+*  ~ResamplerAudioSource
+* Description:
+*  destructor of the ResamplerAudioSource class.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+ResamplerAudioSource::~ResamplerAudioSource() {}
+
+/******************************************
+* Name:
+*  prepareToPlay
+* Description:
+*  override of the base class prepareToPlay method. Prepares the
+*  input source and allocates the input buffers for the largest
+*  supported ratio.
+* Parameters:
+*  samplesPerBlockExpected: no. of samples to return on each getNextAudioBlock call
+*  sampleRate: audio sampling rate
+* Output:
+*  N/A
+*******************************************/
+void ResamplerAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    source->prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    // a chunk reads at most its length times the ratio, plus the margin
+    // after its last sample, the margin before its first is kept from before
+    auto sizeRead = (int)std::ceil(SIZE_CHUNK * MAX_RATIO) + SIZE_MARGIN + 2;
+    readBuffer.setSize(N_CHANNELS, sizeRead);
+    input.setSize(N_CHANNELS, sizeRead + SIZE_MARGIN);
+
+    clearState();
+}
+
+/******************************************
+* Name:
+*  releaseResources
+* Description:
+*  override of the base class releaseResources method. Releases
+*  the input source and the input buffers.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void ResamplerAudioSource::releaseResources() {
+    source->releaseResources();
+
+    readBuffer.setSize(N_CHANNELS, 0);
+    input.setSize(N_CHANNELS, 0);
+}
+
+/******************************************
+* Name:
+*  getNextAudioBlock
+* Description:
+*  override of the base class getNextAudioBlock method. Works
+*  through the block in chunks, reading just enough input for each
+*  chunk and interpolating it with the selected quality. The ratio
+*  and quality are fixed for the whole block. At a ratio of 1.0 the
+*  input is copied untouched instead, whatever the quality.
+* Parameters:
+*  bufferToFill: a descriptor representing the read and write audio buffers.
+* Output:
+*  N/A
+*******************************************/
+void ResamplerAudioSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) {
+    auto blockRatio = ratio.load();
+    auto blockQuality = quality.load();
+    auto nChannels = jmin(bufferToFill.buffer->getNumChannels(), N_CHANNELS);
+
+    // at 1.0x on whole samples interpolating only reproduces the input, and the
+    // sinc would still low-pass it, so copy instead; a read position left between
+    // samples by an earlier ratio is rounded once, a jump of at most half a sample
+    auto copying = blockRatio == 1.0;
+    if (copying) {
+        readPos = std::round(readPos);
+    }
+
+    auto done = 0;
+    while (done < bufferToFill.numSamples) {
+        auto n = jmin(SIZE_CHUNK, bufferToFill.numSamples - done);
+        auto start = bufferToFill.startSample + done;
+
+        // read the input up to the margin after the chunk's last output sample
+        auto needed = (int)(readPos + (n - 1) * blockRatio) + SIZE_MARGIN + 1;
+        if (needed > numInput) {
+            readInput(needed - numInput);
+        }
+
+        if (copying) {
+            for (auto ch = 0; ch < nChannels; ++ch) {
+                bufferToFill.buffer->copyFrom(ch, start, input, ch, (int)readPos, n);
+            }
+        }
+        else {
+            switch (blockQuality) {
+            case linear:
+                resampleLinear(*bufferToFill.buffer, start, n, nChannels, blockRatio);
+                break;
+            case cubic:
+                resampleCubic(*bufferToFill.buffer, start, n, nChannels, blockRatio);
+                break;
+            default:
+                resampleSinc(*bufferToFill.buffer, start, n, nChannels, blockRatio);
+                break;
+            }
+        }
+        readPos += n * blockRatio;
+        done += n;
+
+        // drop input before the margin of the next output sample
+        auto drop = (int)readPos - SIZE_MARGIN;
+        if (drop > 0) {
+            numInput -= drop;
+            for (auto ch = 0; ch < N_CHANNELS; ++ch) {
+                std::memmove(input.getWritePointer(ch), input.getReadPointer(ch, drop),
+                    (size_t)numInput * sizeof(float));
+            }
+            readPos -= drop;
+        }
+    }
+
+    // clear any channels not resampled
+    for (auto ch = nChannels; ch < bufferToFill.buffer->getNumChannels(); ++ch) {
+        bufferToFill.buffer->clear(ch, bufferToFill.startSample, bufferToFill.numSamples);
+    }
+}
+
+/******************************************
+* Name:
+*  runBenchmark
+* Description:
+*  measures the cost of each quality at a few ratios by resampling
+*  a test tone, without an audio device.
+* Parameters:
+*  N/A
+* Output:
+*  report with one line per quality and ratio, in ns per output sample
+*******************************************/
+String ResamplerAudioSource::runBenchmark() {
+    const Quality qualities[] = { linear, cubic, sinc };
+    const String names[] = { "linear", "cubic", "sinc" };
+    const double ratios[] = { 0.5, 1.0, 2.0, 10.0 };
+
+    ToneGeneratorAudioSource tone;
+    AudioBuffer<float> buffer(N_CHANNELS, SIZE_BENCHMARK_BLOCK);
+    String report;
+
+    for (auto q : qualities) {
+        for (auto r : ratios) {
+            ResamplerAudioSource resampler(&tone);
+            resampler.prepareToPlay(SIZE_BENCHMARK_BLOCK, BENCHMARK_SAMPLE_RATE);
+            resampler.setQuality(q);
+            resampler.setRatio(r);
+
+            // time resampling the same no. of stereo output samples for every run
+            auto start = Time::getHighResolutionTicks();
+            for (auto done = 0; done < SIZE_BENCHMARK; done += SIZE_BENCHMARK_BLOCK) {
+                AudioSourceChannelInfo info(&buffer, 0, SIZE_BENCHMARK_BLOCK);
+                resampler.getNextAudioBlock(info);
+            }
+            auto seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+            resampler.releaseResources();
+
+            report << names[q] << " x" << String(r, 1) << ": "
+                << String(seconds * 1.0e9 / SIZE_BENCHMARK, 2) << " ns/sample" << newLine;
+        }
+    }
+    return report;
+}
+
+/******************************************
+* Name:
+*  setRatio
+* Description:
+*  setter for the resampling ratio, the no. of input samples
+*  played per output sample. Picked up on the next block.
+* Parameters:
+*  ratio: resampling ratio (MIN_RATIO-MAX_RATIO)
+* Output:
+*  N/A
+*******************************************/
+void ResamplerAudioSource::setRatio(double _ratio) {
+    // range check, on fail, print error to debug
+    if (_ratio < MIN_RATIO || _ratio > MAX_RATIO) {
+        DBG("ResamplerAudioSource::setRatio: ratio should be between " << MIN_RATIO <<
+            " and " << MAX_RATIO << newLine);
+    }
+    // otherwise set resampling ratio
+    else {
+        ratio.store(_ratio);
+    }
+}
+
+/******************************************
+* Name:
+*  setQuality
+* Description:
+*  setter for the interpolation used to resample. Picked up
+*  on the next block.
+* Parameters:
+*  quality: linear, cubic or sinc
+* Output:
+*  N/A
+*******************************************/
+void ResamplerAudioSource::setQuality(Quality _quality) {
+    quality.store(_quality);
+}
+
+/******************************************
+* Name:
+*  getQuality
+* Description:
+*  getter for the interpolation used to resample.
+* Parameters:
+*  N/A
+* Output:
+*  linear, cubic or sinc
+*******************************************/
+ResamplerAudioSource::Quality ResamplerAudioSource::getQuality() {
+    return (Quality)quality.load();
+}
+
+/******************************************
+* Name:
+*  clearState
+* Description:
+*  empties the input buffers, leaving SIZE_MARGIN samples of
+*  silence before the first input sample.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void ResamplerAudioSource::clearState() {
+    input.clear();
+    numInput = SIZE_MARGIN;
+    readPos = SIZE_MARGIN;
+}
+
+/******************************************
+* Name:
+*  readInput
+* Description:
+*  reads samples from the input source and appends them to
+*  the input buffers.
+* Parameters:
+*  numSamples: no. of samples to read
+* Output:
+*  N/A
+*******************************************/
+void ResamplerAudioSource::readInput(int numSamples) {
+    jassert(numInput + numSamples <= input.getNumSamples());
+
+    AudioSourceChannelInfo info(&readBuffer, 0, numSamples);
+    source->getNextAudioBlock(info);
+    for (auto ch = 0; ch < N_CHANNELS; ++ch) {
+        input.copyFrom(ch, numInput, readBuffer, ch, 0, numSamples);
+    }
+    numInput += numSamples;
+}
+
+/******************************************
+* Name:
+*  resampleLinear
+* Description:
+*  interpolates output samples from the input buffers between the
+*  two nearest input samples.
+* Parameters:
+*  dest: output buffer
+*  startSample: first output sample to write
+*  numSamples: no. of output samples to write
+*  numChannels: no. of channels to write
+*  blockRatio: no. of input samples per output sample
+* Output:
+*  N/A
+*******************************************/
+void ResamplerAudioSource::resampleLinear(AudioBuffer<float>& dest, int startSample,
+    int numSamples, int numChannels, double blockRatio) {
+    for (auto ch = 0; ch < numChannels; ++ch) {
+        auto* in = input.getReadPointer(ch);
+        auto* out = dest.getWritePointer(ch, startSample);
+        auto pos = readPos;
+        for (auto i = 0; i < numSamples; ++i) {
+            auto i0 = (int)pos;
+            auto f = (float)(pos - i0);
+            out[i] = in[i0] + f * (in[i0 + 1] - in[i0]);
+            pos += blockRatio;
+        }
+    }
+}
+
+/******************************************
+* Name:
+*  resampleCubic
+* Description:
+*  interpolates output samples from the input buffers with a
+*  cubic Hermite spline through the four nearest input samples.
+* Parameters:
+*  dest: output buffer
+*  startSample: first output sample to write
+*  numSamples: no. of output samples to write
+*  numChannels: no. of channels to write
+*  blockRatio: no. of input samples per output sample
+* Output:
+*  N/A
+*******************************************/
+void ResamplerAudioSource::resampleCubic(AudioBuffer<float>& dest, int startSample,
+    int numSamples, int numChannels, double blockRatio) {
+    for (auto ch = 0; ch < numChannels; ++ch) {
+        auto* in = input.getReadPointer(ch);
+        auto* out = dest.getWritePointer(ch, startSample);
+        auto pos = readPos;
+        for (auto i = 0; i < numSamples; ++i) {
+            auto i0 = (int)pos;
+            auto f = (float)(pos - i0);
+            auto xm1 = in[i0 - 1];
+            auto x0 = in[i0];
+            auto x1 = in[i0 + 1];
+            auto x2 = in[i0 + 2];
+
+            // Catmull-Rom coefficients, evaluated with Horner's scheme
+            auto c1 = 0.5f * (x1 - xm1);
+            auto c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+            auto c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+            out[i] = ((c3 * f + c2) * f + c1) * f + x0;
+            pos += blockRatio;
+        }
+    }
+}
+
+/******************************************
+* Name:
+*  resampleSinc
+* Description:
+*  interpolates output samples from the input buffers with the
+*  windowed sinc table. Above a ratio of 1.0 the sinc is stretched
+*  so its cutoff is below the output Nyquist frequency, which
+*  widens the kernel by the ratio.
+* Parameters:
+*  dest: output buffer
+*  startSample: first output sample to write
+*  numSamples: no. of output samples to write
+*  numChannels: no. of channels to write
+*  blockRatio: no. of input samples per output sample
+* Output:
+*  N/A
+*******************************************/
+void ResamplerAudioSource::resampleSinc(AudioBuffer<float>& dest, int startSample,
+    int numSamples, int numChannels, double blockRatio) {
+    // cutoff relative to the input Nyquist frequency, and table entries per input sample
+    auto cutoff = (float)(ROLLOFF * jmin(1.0, 1.0 / blockRatio));
+    auto step = cutoff * N_PHASES;
+    auto end = (float)(N_ZEROS * N_PHASES);
+    auto* table = sincTable.get();
+    auto* inL = input.getReadPointer(0);
+    auto* inR = input.getReadPointer(1);
+
+    auto pos = readPos;
+    for (auto i = 0; i < numSamples; ++i) {
+        auto i0 = (int)pos;
+        auto f = (float)(pos - i0);
+        auto sumL = 0.0f;
+        auto sumR = 0.0f;
+
+        // both channels share the taps, so each table lookup is used twice
+        // left wing: input samples at and before the read position
+        auto k = i0;
+        for (auto t = f * step; t < end; t += step, --k) {
+            auto idx = (int)t;
+            auto h = table[idx] + (t - idx) * (table[idx + 1] - table[idx]);
+            sumL += h * inL[k];
+            sumR += h * inR[k];
+        }
+        // right wing: input samples after the read position
+        k = i0 + 1;
+        for (auto t = (1.0f - f) * step; t < end; t += step, ++k) {
+            auto idx = (int)t;
+            auto h = table[idx] + (t - idx) * (table[idx + 1] - table[idx]);
+            sumL += h * inL[k];
+            sumR += h * inR[k];
+        }
+
+        // scale by the cutoff to keep unity gain when the sinc is stretched
+        const float sums[N_CHANNELS] = { sumL * cutoff, sumR * cutoff };
+        for (auto ch = 0; ch < numChannels; ++ch) {
+            dest.setSample(ch, startSample + i, sums[ch]);
+        }
+        pos += blockRatio;
+    }
+}
+
+const double ResamplerAudioSource::MIN_RATIO = 0.1;
+const double ResamplerAudioSource::MAX_RATIO = 10.0;
+const String ResamplerAudioSource::ARG_BENCHMARK = "--benchmark-resampler";
+const double ResamplerAudioSource::ROLLOFF = 0.9;
\ No newline at end of file
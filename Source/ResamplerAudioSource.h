@@ -0,0 +1,261 @@
+/*
+  ==============================================================================
+
+    ResamplerAudioSource.h
+    Created: 18 Oct 2026 7:05:31am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+using namespace juce;
+
+class ResamplerAudioSource : public AudioSource {
+public:
+    // enum representing the interpolation used to resample
+    enum Quality {
+        linear = 0, // 2-point linear, cheapest, aliases at high ratios
+        cubic,      // 4-point cubic Hermite
+        sinc        // band-limited windowed sinc, cutoff follows the ratio
+    };
+
+    // constructors & destructors
+    /******************************************
+    * Name:
+    *  ResamplerAudioSource
+    * Description:
+    *  constructor of the ResamplerAudioSource class. Plays the input
+    *  source back at a different rate, interpolating with the selected
+    *  quality. Precomputes the windowed sinc table.
+    * Parameters:
+    *  source: input audio source, not owned
+    * Output:
+    *  N/A
+    *******************************************/
+    ResamplerAudioSource(AudioSource* source);
+
+    /******************************************
+    * Name:
+    *  ~ResamplerAudioSource
+    * Description:
+    *  destructor of the ResamplerAudioSource class.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    ~ResamplerAudioSource() override;
+
+    // base class overrides
+    /******************************************
+    * Name:
+    *  prepareToPlay
+    * Description:
+    *  override of the base class prepareToPlay method. Prepares the
+    *  input source and allocates the input buffers for the largest
+    *  supported ratio.
+    * Parameters:
+    *  samplesPerBlockExpected: no. of samples to return on each getNextAudioBlock call
+    *  sampleRate: audio sampling rate
+    * Output:
+    *  N/A
+    *******************************************/
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /******************************************
+    * Name:
+    *  releaseResources
+    * Description:
+    *  override of the base class releaseResources method. Releases
+    *  the input source and the input buffers.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void releaseResources() override;
+
+    /******************************************
+    * Name:
+    *  getNextAudioBlock
+    * Description:
+    *  override of the base class getNextAudioBlock method. Works
+    *  through the block in chunks, reading just enough input for each
+    *  chunk and interpolating it with the selected quality. The ratio
+    *  and quality are fixed for the whole block. At a ratio of 1.0 the
+    *  input is copied untouched instead, whatever the quality.
+    * Parameters:
+    *  bufferToFill: a descriptor representing the read and write audio buffers.
+    * Output:
+    *  N/A
+    *******************************************/
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    // methods
+    /******************************************
+    * Name:
+    *  runBenchmark
+    * Description:
+    *  measures the cost of each quality at a few ratios by resampling
+    *  a test tone, without an audio device.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  report with one line per quality and ratio, in ns per output sample
+    *******************************************/
+    static String runBenchmark();
+
+    // getters & setters
+    /******************************************
+    * Name:
+    *  setRatio
+    * Description:
+    *  setter for the resampling ratio, the no. of input samples
+    *  played per output sample. Picked up on the next block.
+    * Parameters:
+    *  ratio: resampling ratio (MIN_RATIO-MAX_RATIO)
+    * Output:
+    *  N/A
+    *******************************************/
+    void setRatio(double ratio);
+
+    /******************************************
+    * Name:
+    *  setQuality
+    * Description:
+    *  setter for the interpolation used to resample. Picked up
+    *  on the next block.
+    * Parameters:
+    *  quality: linear, cubic or sinc
+    * Output:
+    *  N/A
+    *******************************************/
+    void setQuality(Quality quality);
+
+    /******************************************
+    * Name:
+    *  getQuality
+    * Description:
+    *  getter for the interpolation used to resample.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  linear, cubic or sinc
+    *******************************************/
+    Quality getQuality();
+
+    // public constants
+    static const double MIN_RATIO;  // lower limit of resampling ratio
+    static const double MAX_RATIO;  // upper limit of resampling ratio
+    static const String ARG_BENCHMARK;  // command line argument to run the benchmark
+
+private:
+    // methods
+    /******************************************
+    * Name:
+    *  clearState
+    * Description:
+    *  empties the input buffers, leaving SIZE_MARGIN samples of
+    *  silence before the first input sample.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void clearState();
+
+    /******************************************
+    * Name:
+    *  readInput
+    * Description:
+    *  reads samples from the input source and appends them to
+    *  the input buffers.
+    * Parameters:
+    *  numSamples: no. of samples to read
+    * Output:
+    *  N/A
+    *******************************************/
+    void readInput(int numSamples);
+
+    /******************************************
+    * Name:
+    *  resampleLinear
+    * Description:
+    *  interpolates output samples from the input buffers between the
+    *  two nearest input samples.
+    * Parameters:
+    *  dest: output buffer
+    *  startSample: first output sample to write
+    *  numSamples: no. of output samples to write
+    *  numChannels: no. of channels to write
+    *  blockRatio: no. of input samples per output sample
+    * Output:
+    *  N/A
+    *******************************************/
+    void resampleLinear(AudioBuffer<float>& dest, int startSample, int numSamples,
+        int numChannels, double blockRatio);
+
+    /******************************************
+    * Name:
+    *  resampleCubic
+    * Description:
+    *  interpolates output samples from the input buffers with a
+    *  cubic Hermite spline through the four nearest input samples.
+    * Parameters:
+    *  dest: output buffer
+    *  startSample: first output sample to write
+    *  numSamples: no. of output samples to write
+    *  numChannels: no. of channels to write
+    *  blockRatio: no. of input samples per output sample
+    * Output:
+    *  N/A
+    *******************************************/
+    void resampleCubic(AudioBuffer<float>& dest, int startSample, int numSamples,
+        int numChannels, double blockRatio);
+
+    /******************************************
+    * Name:
+    *  resampleSinc
+    * Description:
+    *  interpolates output samples from the input buffers with the
+    *  windowed sinc table. Above a ratio of 1.0 the sinc is stretched
+    *  so its cutoff is below the output Nyquist frequency, which
+    *  widens the kernel by the ratio.
+    * Parameters:
+    *  dest: output buffer
+    *  startSample: first output sample to write
+    *  numSamples: no. of output samples to write
+    *  numChannels: no. of channels to write
+    *  blockRatio: no. of input samples per output sample
+    * Output:
+    *  N/A
+    *******************************************/
+    void resampleSinc(AudioBuffer<float>& dest, int startSample, int numSamples,
+        int numChannels, double blockRatio);
+
+    // functionality members
+    AudioSource* source;    // input audio source
+    AudioBuffer<float> input;   // input samples around the read position
+    int numInput;   // no. of samples held in the input buffer
+    double readPos; // position of the next output sample in the input buffer
+    AudioBuffer<float> readBuffer;  // scratch buffer the input source is read into
+    HeapBlock<float> sincTable; // one side of the windowed sinc, N_PHASES entries per zero crossing
+    std::atomic<double> ratio{ 1.0 };   // resampling ratio
+    std::atomic<int> quality{ sinc };   // interpolation used to resample
+
+    // private constants
+    static const int N_CHANNELS = 2;    // no. of channels resampled
+    static const int SIZE_CHUNK = 256;  // max. no. of output samples computed at a time
+    static const int SIZE_MARGIN = 96;  // no. of input samples kept either side of the read position
+    static const int N_ZEROS = 8;   // no. of sinc zero crossings either side of the centre
+    static const int N_PHASES = 256;    // no. of sinc table entries per zero crossing
+    static const int SIZE_BENCHMARK = 1 << 20;  // no. of output samples resampled per benchmark run
+    static const int SIZE_BENCHMARK_BLOCK = 128;    // block size used by the benchmark
+    static const int BENCHMARK_SAMPLE_RATE = 48000; // sampling rate used by the benchmark
+    static const double ROLLOFF;    // sinc cutoff relative to the Nyquist frequency
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ResamplerAudioSource)
+};
\ No newline at end of file
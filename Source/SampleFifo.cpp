@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    SampleFifo.cpp
+    Created: 18 Oct 2026 1:52:16am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#include "SampleFifo.h"
+
+/******************************************
+* Name:
+*  SampleFifo
+* Description:
+*  constructor of the SampleFifo class. A lock-free ring
+*  buffer of samples for exactly one writing thread and one
+*  reading thread, allocated up front.
+* Parameters:
+*  capacity: max. no. of samples held
+* Output:
+*  N/A
+*******************************************/
+SampleFifo::SampleFifo(int capacity) :
+    fifo(capacity + 1),     // one slot always stays empty to tell full from empty
+    buffer((size_t)capacity + 1, true) {}
+
+/******************************************
+* Name:
+*  push
+* Description:
+*  called by the writing thread (audio thread) to copy a
+*  block of samples into the buffer. Never blocks or allocates;
+*  samples that do not fit are dropped.
+* Parameters:
+*  samples: samples to write
+*  numSamples: no. of samples to write
+* Output:
+*  no. of samples written
+*******************************************/
+int SampleFifo::push(const float* samples, int numSamples) {
+    // copy in at most two parts, around the end of the buffer
+    const auto scope = fifo.write(numSamples);
+    if (scope.blockSize1 > 0) {
+        FloatVectorOperations::copy(buffer + scope.startIndex1, samples, scope.blockSize1);
+    }
+    if (scope.blockSize2 > 0) {
+        FloatVectorOperations::copy(buffer + scope.startIndex2, samples + scope.blockSize1,
+            scope.blockSize2);
+    }
+    return scope.blockSize1 + scope.blockSize2;
+}
+
+/******************************************
+* Name:
+*  pop
+* Description:
+*  called by the reading thread to copy samples out of
+*  the buffer, oldest first.
+* Parameters:
+*  dest: buffer to copy the samples to
+*  numSamples: max. no. of samples to read
+* Output:
+*  no. of samples read
+*******************************************/
+int SampleFifo::pop(float* dest, int numSamples) {
+    // copy out in at most two parts, around the end of the buffer
+    const auto scope = fifo.read(numSamples);
+    if (scope.blockSize1 > 0) {
+        FloatVectorOperations::copy(dest, buffer + scope.startIndex1, scope.blockSize1);
+    }
+    if (scope.blockSize2 > 0) {
+        FloatVectorOperations::copy(dest + scope.blockSize1, buffer + scope.startIndex2,
+            scope.blockSize2);
+    }
+    return scope.blockSize1 + scope.blockSize2;
+}
+
+/******************************************
+* Name:
+*  discard
+* Description:
+*  called by the reading thread to drop all samples
+*  written so far.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void SampleFifo::discard() {
+    // moving the read position is safe while the writer is running, resetting is not
+    fifo.finishedRead(fifo.getNumReady());
+}
+
+/******************************************
+* Name:
+*  getNumReady
+* Description:
+*  getter for the no. of samples waiting to be read.
+* Parameters:
+*  N/A
+* Output:
+*  no. of samples that can be read
+*******************************************/
+int SampleFifo::getNumReady() {
+    return fifo.getNumReady();
+}
\ No newline at end of file
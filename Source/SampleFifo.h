@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    SampleFifo.h
+    Created: 18 Oct 2026 1:52:16am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+using namespace juce;
+
+class SampleFifo {
+public:
+    // constructors & destructors
+    /******************************************
+    * Name:
+    *  SampleFifo
+    * Description:
+    *  constructor of the SampleFifo class. A lock-free ring
+    *  buffer of samples for exactly one writing thread and one
+    *  reading thread, allocated up front.
+    * Parameters:
+    *  capacity: max. no. of samples held
+    * Output:
+    *  N/A
+    *******************************************/
+    SampleFifo(int capacity);
+
+    // methods
+    /******************************************
+    * Name:
+    *  push
+    * Description:
+    *  called by the writing thread (audio thread) to copy a
+    *  block of samples into the buffer. Never blocks or allocates;
+    *  samples that do not fit are dropped.
+    * Parameters:
+    *  samples: samples to write
+    *  numSamples: no. of samples to write
+    * Output:
+    *  no. of samples written
+    *******************************************/
+    int push(const float* samples, int numSamples);
+
+    /******************************************
+    * Name:
+    *  pop
+    * Description:
+    *  called by the reading thread to copy samples out of
+    *  the buffer, oldest first.
+    * Parameters:
+    *  dest: buffer to copy the samples to
+    *  numSamples: max. no. of samples to read
+    * Output:
+    *  no. of samples read
+    *******************************************/
+    int pop(float* dest, int numSamples);
+
+    /******************************************
+    * Name:
+    *  discard
+    * Description:
+    *  called by the reading thread to drop all samples
+    *  written so far.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void discard();
+
+    // getters & setters
+    /******************************************
+    * Name:
+    *  getNumReady
+    * Description:
+    *  getter for the no. of samples waiting to be read.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  no. of samples that can be read
+    *******************************************/
+    int getNumReady();
+
+private:
+    // functionality members
+    AbstractFifo fifo;      // lock-free read and write positions
+    HeapBlock<float> buffer;    // sample storage
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleFifo)
+};
\ No newline at end of file
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    SearchIndex.cpp
+    Created: 18 Oct 2026 1:05:38am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#include "SearchIndex.h"
+
+/******************************************
+* Name:
+*  SearchIndex
+* Description:
+*  constructor of the SearchIndex class. Lowercases every
+*  name once and stores them back to back in a single UTF-8
+*  buffer, so a search is a scan over contiguous memory. The
+*  index is not modified after construction, so it can be
+*  searched from any thread.
+* Parameters:
+*  names: names to index, searched by their position in the array
+* Output:
+*  N/A
+*******************************************/
+SearchIndex::SearchIndex(const StringArray& names) {
+    offsets.reserve((size_t)names.size() + 1);
+    for (auto& name : names) {
+        offsets.push_back(text.size());
+        // separator, so a keyword never matches across two names
+        text += name.toLowerCase().toStdString();
+        text += '\0';
+    }
+    offsets.push_back(text.size());
+}
+
+/******************************************
+* Name:
+*  search
+* Description:
+*  find all names containing the keyword, ignoring case.
+* Parameters:
+*  keyword: keyword to search for
+* Output:
+*  positions of the matching names, in ascending order
+*******************************************/
+std::vector<int> SearchIndex::search(const String& keyword) const {
+    std::vector<int> matches;
+    auto key = keyword.toLowerCase().toStdString();
+
+    // an empty keyword matches every name
+    if (key.empty()) {
+        matches.resize((size_t)size());
+        std::iota(matches.begin(), matches.end(), 0);
+        return matches;
+    }
+
+    // scan the whole buffer at once instead of name by name
+    auto pos = text.find(key);
+    while (pos != std::string::npos) {
+        // look up the name the match is in
+        auto id = (int)(std::upper_bound(offsets.begin(), offsets.end(), pos) - offsets.begin()) - 1;
+        matches.push_back(id);
+
+        // continue from the next name, so each name is reported once
+        pos = text.find(key, offsets[(size_t)id + 1]);
+    }
+    return matches;
+}
+
+/******************************************
+* Name:
+*  narrow
+* Description:
+*  find the names containing the keyword among the given
+*  candidates only, ignoring case. Used when the keyword extends
+*  a previous keyword, so only its matches need checking.
+* Parameters:
+*  keyword: keyword to search for
+*  candidates: positions of the names to check, in ascending order
+* Output:
+*  positions of the matching names, in ascending order
+*******************************************/
+std::vector<int> SearchIndex::narrow(const String& keyword, const std::vector<int>& candidates) const {
+    std::vector<int> matches;
+    auto key = keyword.toLowerCase().toStdString();
+
+    for (auto id : candidates) {
+        if (id < 0 || id >= size()) {
+            continue;
+        }
+        // only search within the candidate's name, excluding its separator
+        auto first = text.begin() + (std::ptrdiff_t)offsets[(size_t)id];
+        auto last = text.begin() + (std::ptrdiff_t)offsets[(size_t)id + 1] - 1;
+        if (std::search(first, last, key.begin(), key.end()) != last || key.empty()) {
+            matches.push_back(id);
+        }
+    }
+    return matches;
+}
+
+/******************************************
+* Name:
+*  size
+* Description:
+*  Returns the number of names in the index.
+* Parameters:
+*  N/A
+* Output:
+*  no. of names
+*******************************************/
+int SearchIndex::size() const {
+    return (int)offsets.size() - 1;
+}
\ No newline at end of file
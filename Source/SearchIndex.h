@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    SearchIndex.h
+    Created: 18 Oct 2026 1:05:38am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+using namespace juce;
+
+class SearchIndex {
+public:
+    // constructors & destructors
+    /******************************************
+    * Name:
+    *  SearchIndex
+    * Description:
+    *  constructor of the SearchIndex class. Lowercases every
+    *  name once and stores them back to back in a single UTF-8
+    *  buffer, so a search is a scan over contiguous memory. The
+    *  index is not modified after construction, so it can be
+    *  searched from any thread.
+    * Parameters:
+    *  names: names to index, searched by their position in the array
+    * Output:
+    *  N/A
+    *******************************************/
+    SearchIndex(const StringArray& names);
+
+    // methods
+    /******************************************
+    * Name:
+    *  search
+    * Description:
+    *  find all names containing the keyword, ignoring case.
+    * Parameters:
+    *  keyword: keyword to search for
+    * Output:
+    *  positions of the matching names, in ascending order
+    *******************************************/
+    std::vector<int> search(const String& keyword) const;
+
+    /******************************************
+    * Name:
+    *  narrow
+    * Description:
+    *  find the names containing the keyword among the given
+    *  candidates only, ignoring case. Used when the keyword extends
+    *  a previous keyword, so only its matches need checking.
+    * Parameters:
+    *  keyword: keyword to search for
+    *  candidates: positions of the names to check, in ascending order
+    * Output:
+    *  positions of the matching names, in ascending order
+    *******************************************/
+    std::vector<int> narrow(const String& keyword, const std::vector<int>& candidates) const;
+
+    /******************************************
+    * Name:
+    *  size
+    * Description:
+    *  Returns the number of names in the index.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  no. of names
+    *******************************************/
+    int size() const;
+
+private:
+    // functionality members
+    std::string text;   // lowercased UTF-8 names, each followed by a '\0'
+    std::vector<size_t> offsets;    // start of each name in text, followed by the end of text
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SearchIndex)
+};
\ No newline at end of file
@@ -0,0 +1,398 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyser.cpp
+    Created: 18 Oct 2026 2:34:50am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalyser.h"
+
+/******************************************
+* Name:
+*  SpectrumAnalyser
+* Description:
+*  constructor of the SpectrumAnalyser class. Sets up the
+*  FFT with the default settings and the buffers the spectrum
+*  is published through.
+* Parameters:
+*  thread: shared background thread the analysis runs on
+* Output:
+*  N/A
+*******************************************/
+SpectrumAnalyser::SpectrumAnalyser(TimeSliceThread& _thread) :
+    thread(_thread),
+    sampleFifo(nullptr),
+    sampleRate(DEFAULT_SAMPLE_RATE)
+{
+    zeromem(scopes, sizeof(scopes));
+    prepare();
+}
+
+/******************************************
+* Name:
+*  ~SpectrumAnalyser
+* Description:
+*  destructor of the SpectrumAnalyser class, stops analysing
+*  by removing self from the background thread.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+SpectrumAnalyser::~SpectrumAnalyser() {
+    // blocks until the background thread is done with this analyser
+    thread.removeTimeSliceClient(this);
+}
+
+/******************************************
+* Name:
+*  updateScope
+* Description:
+*  called from the message thread to take the latest
+*  spectrum published by the background thread, if any.
+* Parameters:
+*  N/A
+* Output:
+*  true if a new spectrum was taken
+*******************************************/
+bool SpectrumAnalyser::updateScope() {
+    if ((middleScope.load() & FLAG_FRESH) == 0) {
+        return false;
+    }
+    // swap the spectrum just read for the latest one
+    readScope = middleScope.exchange(readScope) & ~FLAG_FRESH;
+    return true;
+}
+
+/******************************************
+* Name:
+*  getScope
+* Description:
+*  getter for the spectrum last taken by updateScope. Only
+*  valid on the message thread until the next updateScope.
+* Parameters:
+*  N/A
+* Output:
+*  SIZE_SCOPE normalized levels, from low to high frequency
+*******************************************/
+const float* SpectrumAnalyser::getScope() {
+    return scopes[readScope];
+}
+
+/******************************************
+* Name:
+*  setSampleFifo
+* Description:
+*  setter for the fifo the samples to analyse are read from.
+*  Samples already in the fifo are dropped. Analysis only runs
+*  on the background thread while a fifo is set.
+* Parameters:
+*  sampleFifo: fifo written by a DJAudioPlayer, nullptr to stop
+*  sampleRate: sampling rate of the samples written to the fifo
+* Output:
+*  N/A
+*******************************************/
+void SpectrumAnalyser::setSampleFifo(SampleFifo* _sampleFifo, double _sampleRate) {
+    // stop reading from the previous fifo before switching
+    thread.removeTimeSliceClient(this);
+    sampleFifo = _sampleFifo;
+    sampleRate = _sampleRate;
+    if (sampleFifo == nullptr) {
+        return;
+    }
+
+    // start from the current output, not what was buffered for a previous display
+    sampleFifo->discard();
+    prepare();
+    thread.addTimeSliceClient(this);
+}
+
+/******************************************
+* Name:
+*  setBinAveraging
+* Description:
+*  setter for how the FFT bins are reduced to the spectrum.
+*  When averaging, each level is the mean of all FFT bins
+*  falling into its frequency range, otherwise only the
+*  lowest bin of the range is used.
+* Parameters:
+*  averaging: true to average bins, false to point sample
+* Output:
+*  N/A
+*******************************************/
+void SpectrumAnalyser::setBinAveraging(bool averaging) {
+    binAveraging.store(averaging);
+}
+
+/******************************************
+* Name:
+*  setSettings
+* Description:
+*  setter for the resolution, overlap, window and smoothing
+*  of the analysis. Values out of range are limited to the
+*  allowed range. Analysis restarts with the new settings.
+* Parameters:
+*  settings: new analysis settings
+* Output:
+*  N/A
+*******************************************/
+void SpectrumAnalyser::setSettings(const Settings& newSettings) {
+    // range check, on fail, print error to debug and limit to the range
+    auto checked = newSettings;
+    if (checked.order < MIN_ORDER || checked.order > MAX_ORDER) {
+        DBG("SpectrumAnalyser::setSettings: order should be between " << MIN_ORDER <<
+            " and " << MAX_ORDER << newLine);
+        checked.order = jlimit(MIN_ORDER, MAX_ORDER, checked.order);
+    }
+    if (checked.overlap < 0.0f || checked.overlap > MAX_OVERLAP) {
+        DBG("SpectrumAnalyser::setSettings: overlap should be between 0 and " << MAX_OVERLAP << newLine);
+        checked.overlap = jlimit(0.0f, MAX_OVERLAP, checked.overlap);
+    }
+    checked.holdTime = jmax(0.0f, checked.holdTime);
+    checked.decay = jmax(0.0f, checked.decay);
+
+    // reconfigure while the background thread is not using this analyser
+    thread.removeTimeSliceClient(this);
+    settings = checked;
+    prepare();
+    if (sampleFifo != nullptr) {
+        thread.addTimeSliceClient(this);
+    }
+}
+
+/******************************************
+* Name:
+*  getSettings
+* Description:
+*  getter for the current analysis settings.
+* Parameters:
+*  N/A
+* Output:
+*  current analysis settings
+*******************************************/
+SpectrumAnalyser::Settings SpectrumAnalyser::getSettings() {
+    return settings;
+}
+
+/******************************************
+* Name:
+*  useTimeSlice
+* Description:
+*  called by the background thread. Reads new samples from
+*  the fifo into the sample history and, once a hop's worth of
+*  new samples is gathered, analyses the latest frame and
+*  publishes the spectrum.
+* Parameters:
+*  N/A
+* Output:
+*  no. of milliseconds until the thread should call again
+*******************************************/
+int SpectrumAnalyser::useTimeSlice() {
+    // read everything the audio thread has written since the last call
+    int n;
+    while ((n = sampleFifo->pop(drained, SIZE_DRAIN)) > 0) {
+        pushSamples(drained, n);
+    }
+
+    // only the latest frame is analysed, so small hops never queue up work
+    if (historyFilled == sizeFft && samplesSinceFrame >= hopSize) {
+        // perform FFT, normalization and smoothing
+        drawNextTrace();
+        samplesSinceFrame = 0;
+        // publish the spectrum and continue with the one the message thread is done with
+        writeScope = middleScope.exchange(writeScope | FLAG_FRESH) & ~FLAG_FRESH;
+    }
+    return INTERVAL_ANALYSIS;
+}
+
+/******************************************
+* Name:
+*  pushSamples
+* Description:
+*  append samples read from the fifo to the sample history,
+*  overwriting the oldest ones.
+* Parameters:
+*  samples: samples to append
+*  numSamples: no. of samples to append
+* Output:
+*  N/A
+*******************************************/
+void SpectrumAnalyser::pushSamples(const float* samples, int numSamples) {
+    // only the latest sizeFft samples can be part of a frame
+    if (numSamples > sizeFft) {
+        samplesSinceFrame += numSamples - sizeFft;
+        samples += numSamples - sizeFft;
+        numSamples = sizeFft;
+    }
+
+    // copy in at most two parts, around the end of the history
+    auto n1 = jmin(numSamples, sizeFft - historyPos);
+    FloatVectorOperations::copy(history.data() + historyPos, samples, n1);
+    FloatVectorOperations::copy(history.data(), samples + n1, numSamples - n1);
+
+    historyPos = (historyPos + numSamples) % sizeFft;
+    historyFilled = jmin(sizeFft, historyFilled + numSamples);
+    samplesSinceFrame += numSamples;
+}
+
+/******************************************
+* Name:
+*  drawNextTrace
+* Description:
+*  perform FFT on the latest frame of the sample history and
+*  normalize and smooth the output levels into the spectrum
+*  being written
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void SpectrumAnalyser::drawNextTrace() {
+    // unroll the history into the frame, oldest sample first
+    auto n1 = sizeFft - historyPos;
+    FloatVectorOperations::copy(fftData.data(), history.data() + historyPos, n1);
+    FloatVectorOperations::copy(fftData.data() + n1, history.data(), historyPos);
+    FloatVectorOperations::clear(fftData.data() + sizeFft, sizeFft);
+
+    // perform FFT using windowing function
+    window->multiplyWithWindowingTable(fftData.data(), (size_t)sizeFft);
+    fft->performFrequencyOnlyForwardTransform(fftData.data());
+
+    auto* scopeData = scopes[writeScope];
+    auto averaging = binAveraging.load();
+
+    // reduce the FFT bins to one magnitude per level (mirrored part is not used)
+    for (auto i = 0; i < SIZE_SCOPE; ++i) {
+        auto start = bins[i];
+        auto end = jmax(start + 1, bins[i + 1]);
+        if (averaging && end - start > 1) {
+            auto sum = 0.0f;
+            for (auto j = start; j < end; ++j) {
+                sum += fftData[(size_t)j];
+            }
+            scopeData[i] = sum / (float)(end - start);
+        }
+        else {
+            scopeData[i] = fftData[(size_t)start];
+        }
+    }
+
+    // normalize to 0..1 between MIN_DB and MAX_DB on the whole spectrum at once:
+    // level = (20 * log10(2) * log2(gain / sizeFft) - MIN_DB) / (MAX_DB - MIN_DB)
+    // (Decibels::decibelsToGain would return 0 for MIN_DB, so compute the gains directly)
+    auto rangedB = MAX_DB - MIN_DB;
+    FloatVectorOperations::multiply(scopeData, 1.0f / (float)sizeFft, SIZE_SCOPE);
+    FloatVectorOperations::clip(scopeData, scopeData, std::pow(10.0f, MIN_DB / 20.0f),
+        std::pow(10.0f, MAX_DB / 20.0f), SIZE_SCOPE);
+    approximateLog2(scopeData, SIZE_SCOPE);
+    FloatVectorOperations::multiply(scopeData, 20.0f * std::log10(2.0f) / rangedB, SIZE_SCOPE);
+    FloatVectorOperations::add(scopeData, -MIN_DB / rangedB, SIZE_SCOPE);
+
+    // peak hold and decay, levels rise at once and fall back slowly
+    if (settings.decay > 0.0f) {
+        auto elapsed = (float)(samplesSinceFrame / sampleRate);
+        auto fall = settings.decay * elapsed / rangedB;
+        for (auto i = 0; i < SIZE_SCOPE; ++i) {
+            if (scopeData[i] >= peaks[i]) {
+                peaks[i] = scopeData[i];
+                holds[i] = settings.holdTime;
+            }
+            else if (holds[i] > 0.0f) {
+                holds[i] -= elapsed;
+            }
+            else {
+                peaks[i] = jmax(scopeData[i], peaks[i] - fall);
+            }
+            scopeData[i] = peaks[i];
+        }
+    }
+}
+
+/******************************************
+* Name:
+*  prepare
+* Description:
+*  set up the FFT, window, sample history and bin mapping
+*  for the current settings. Must not be called while the
+*  background thread is using this analyser.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void SpectrumAnalyser::prepare() {
+    sizeFft = 1 << settings.order;
+    hopSize = jmax(1, roundToInt((float)sizeFft * (1.0f - settings.overlap)));
+    fft = std::make_unique<FFT>(settings.order);
+    window = std::make_unique<WindowingFunction<float>>((size_t)sizeFft, settings.windowType);
+
+    // start with an empty history
+    history.assign((size_t)sizeFft, 0.0f);
+    fftData.assign((size_t)sizeFft * 2, 0.0f);
+    historyPos = 0;
+    historyFilled = 0;
+    samplesSinceFrame = 0;
+    zeromem(peaks, sizeof(peaks));
+    zeromem(holds, sizeof(holds));
+
+    prepareBins();
+}
+
+/******************************************
+* Name:
+*  prepareBins
+* Description:
+*  compute the range of FFT bins each level of the spectrum
+*  covers, skewed so low frequencies get more of the spectrum.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void SpectrumAnalyser::prepareBins() {
+    for (auto i = 0; i <= SIZE_SCOPE; ++i) {
+        auto skewedProportionX = 1.0f - std::exp(std::log(1.0f -
+            (float)i / (float)SIZE_SCOPE) * 0.2f);
+        bins[i] = jlimit(0, sizeFft / 2,
+            (int)(skewedProportionX * (float)sizeFft * 0.5));
+    }
+}
+
+/******************************************
+* Name:
+*  approximateLog2
+* Description:
+*  replace positive normal values by their base 2 logarithm,
+*  taken from the exponent bits plus a polynomial fit on the
+*  mantissa (error below 1.2e-4, about 0.001 dB). Branch free
+*  and unit stride so the loop is vectorised, with no libm call.
+* Parameters:
+*  values: values to convert in place
+*  numValues: no. of values
+* Output:
+*  N/A
+*******************************************/
+void SpectrumAnalyser::approximateLog2(float* values, int numValues) {
+    for (auto i = 0; i < numValues; ++i) {
+        uint32 bits;
+        std::memcpy(&bits, values + i, sizeof(bits));
+        // value = 2^exponent * (1 + t), t in [0, 1)
+        auto exponent = (float)((int)(bits >> 23) - 127);
+        bits = (bits & 0x007fffffu) | 0x3f800000u;
+        float mantissa;
+        std::memcpy(&mantissa, &bits, sizeof(mantissa));
+        auto t = mantissa - 1.0f;
+        values[i] = exponent + t * (1.43863764f + t * (-0.677740511f
+            + t * (0.321874195f + t * -0.0828574318f)));
+    }
+}
+
+// upper limit of frame overlap
+const float SpectrumAnalyser::MAX_OVERLAP = 0.75f;
+// level shown as empty
+const float SpectrumAnalyser::MIN_DB = -100.0f;
+// level shown as full
+const float SpectrumAnalyser::MAX_DB = 0.0f;
\ No newline at end of file
@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyser.h
+    Created: 18 Oct 2026 2:34:50am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+using namespace juce;
+using namespace juce::dsp;
+
+#include "SampleFifo.h"
+
+class SpectrumAnalyser : private TimeSliceClient {
+public:
+    // analysis settings
+    struct Settings {
+        int order = 11;         // FFT size is 2^order, MIN_ORDER to MAX_ORDER
+        float overlap = 0.5f;   // fraction of a frame shared with the next, 0 to MAX_OVERLAP
+        WindowingFunction<float>::WindowingMethod windowType = WindowingFunction<float>::hann;
+        float holdTime = 0.1f;  // seconds a peak level is held
+        float decay = 48.0f;    // dB per second a peak level falls once held, 0 for no smoothing
+    };
+
+    // constructors & destructors
+    /******************************************
+    * Name:
+    *  SpectrumAnalyser
+    * Description:
+    *  constructor of the SpectrumAnalyser class. Sets up the
+    *  FFT with the default settings and the buffers the spectrum
+    *  is published through.
+    * Parameters:
+    *  thread: shared background thread the analysis runs on
+    * Output:
+    *  N/A
+    *******************************************/
+    SpectrumAnalyser(TimeSliceThread& thread);
+
+    /******************************************
+    * Name:
+    *  ~SpectrumAnalyser
+    * Description:
+    *  destructor of the SpectrumAnalyser class, stops analysing
+    *  by removing self from the background thread.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    ~SpectrumAnalyser() override;
+
+    // methods
+    /******************************************
+    * Name:
+    *  updateScope
+    * Description:
+    *  called from the message thread to take the latest
+    *  spectrum published by the background thread, if any.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  true if a new spectrum was taken
+    *******************************************/
+    bool updateScope();
+
+    // getters & setters
+    /******************************************
+    * Name:
+    *  getScope
+    * Description:
+    *  getter for the spectrum last taken by updateScope. Only
+    *  valid on the message thread until the next updateScope.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  SIZE_SCOPE normalized levels, from low to high frequency
+    *******************************************/
+    const float* getScope();
+
+    /******************************************
+    * Name:
+    *  setSampleFifo
+    * Description:
+    *  setter for the fifo the samples to analyse are read from.
+    *  Samples already in the fifo are dropped. Analysis only runs
+    *  on the background thread while a fifo is set.
+    * Parameters:
+    *  sampleFifo: fifo written by a DJAudioPlayer, nullptr to stop
+    *  sampleRate: sampling rate of the samples written to the fifo
+    * Output:
+    *  N/A
+    *******************************************/
+    void setSampleFifo(SampleFifo* sampleFifo, double sampleRate);
+
+    /******************************************
+    * Name:
+    *  setBinAveraging
+    * Description:
+    *  setter for how the FFT bins are reduced to the spectrum.
+    *  When averaging, each level is the mean of all FFT bins
+    *  falling into its frequency range, otherwise only the
+    *  lowest bin of the range is used.
+    * Parameters:
+    *  averaging: true to average bins, false to point sample
+    * Output:
+    *  N/A
+    *******************************************/
+    void setBinAveraging(bool averaging);
+
+    /******************************************
+    * Name:
+    *  setSettings
+    * Description:
+    *  setter for the resolution, overlap, window and smoothing
+    *  of the analysis. Values out of range are limited to the
+    *  allowed range. Analysis restarts with the new settings.
+    * Parameters:
+    *  settings: new analysis settings
+    * Output:
+    *  N/A
+    *******************************************/
+    void setSettings(const Settings& settings);
+
+    /******************************************
+    * Name:
+    *  getSettings
+    * Description:
+    *  getter for the current analysis settings.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  current analysis settings
+    *******************************************/
+    Settings getSettings();
+
+    // public constants
+    static const int SIZE_SCOPE = 512;  // no. of levels in a spectrum
+    static const int MIN_ORDER = 9;     // lower limit of FFT order
+    static const int MAX_ORDER = 14;    // upper limit of FFT order
+    static const float MAX_OVERLAP;     // upper limit of frame overlap
+
+private:
+    // TimeSliceClient overrides
+    /******************************************
+    * Name:
+    *  useTimeSlice
+    * Description:
+    *  called by the background thread. Reads new samples from
+    *  the fifo into the sample history and, once a hop's worth of
+    *  new samples is gathered, analyses the latest frame and
+    *  publishes the spectrum.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  no. of milliseconds until the thread should call again
+    *******************************************/
+    int useTimeSlice() override;
+
+    // methods
+    /******************************************
+    * Name:
+    *  pushSamples
+    * Description:
+    *  append samples read from the fifo to the sample history,
+    *  overwriting the oldest ones.
+    * Parameters:
+    *  samples: samples to append
+    *  numSamples: no. of samples to append
+    * Output:
+    *  N/A
+    *******************************************/
+    void pushSamples(const float* samples, int numSamples);
+
+    /******************************************
+    * Name:
+    *  drawNextTrace
+    * Description:
+    *  perform FFT on the latest frame of the sample history and
+    *  normalize and smooth the output levels into the spectrum
+    *  being written
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void drawNextTrace();
+
+    /******************************************
+    * Name:
+    *  prepare
+    * Description:
+    *  set up the FFT, window, sample history and bin mapping
+    *  for the current settings. Must not be called while the
+    *  background thread is using this analyser.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void prepare();
+
+    /******************************************
+    * Name:
+    *  prepareBins
+    * Description:
+    *  compute the range of FFT bins each level of the spectrum
+    *  covers, skewed so low frequencies get more of the spectrum.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void prepareBins();
+
+    /******************************************
+    * Name:
+    *  approximateLog2
+    * Description:
+    *  replace positive normal values by their base 2 logarithm,
+    *  taken from the exponent bits plus a polynomial fit on the
+    *  mantissa (error below 1.2e-4, about 0.001 dB). Branch free
+    *  and unit stride so the loop is vectorised, with no libm call.
+    * Parameters:
+    *  values: values to convert in place
+    *  numValues: no. of values
+    * Output:
+    *  N/A
+    *******************************************/
+    static void approximateLog2(float* values, int numValues);
+
+    // functionality members
+    TimeSliceThread& thread;    // shared background thread the analysis runs on
+    SampleFifo* sampleFifo;     // fifo written by the associated DJAudioPlayer
+    double sampleRate;          // sampling rate of the samples in the fifo
+    Settings settings;          // current analysis settings
+    // FFT related members
+    static const int SIZE_DRAIN = 4096; // max. no. of samples read from the fifo at a time
+    int sizeFft;    // no. of samples in a frame
+    int hopSize;    // no. of new samples between frames
+    std::unique_ptr<FFT> fft;
+    std::unique_ptr<WindowingFunction<float>> window;
+    std::vector<float> history;     // latest sizeFft samples, circular
+    std::vector<float> fftData;     // frame being transformed, 2 * sizeFft
+    int historyPos;         // next write position in the history
+    int historyFilled;      // no. of valid samples in the history
+    int samplesSinceFrame;  // no. of samples pushed since the last frame
+    float drained[SIZE_DRAIN];  // samples read from the fifo at a time
+    int bins[SIZE_SCOPE + 1];   // first FFT bin of each level, followed by the last bin
+    std::atomic<bool> binAveraging{ false };    // if levels average their bins instead of point sampling
+    float peaks[SIZE_SCOPE];    // smoothed levels
+    float holds[SIZE_SCOPE];    // seconds each peak level is held for
+    // spectra, triple buffered so neither thread waits for or overwrites the other
+    float scopes[3][SIZE_SCOPE];
+    int writeScope = 0;     // spectrum written by the background thread
+    int readScope = 2;      // spectrum read by the message thread
+    std::atomic<int> middleScope{ 1 };  // latest spectrum, FLAG_FRESH if not yet taken
+
+    // private constants
+    static const float MIN_DB;  // level shown as empty
+    static const float MAX_DB;  // level shown as full
+    static const int DEFAULT_SAMPLE_RATE = 44100;   // sampling rate assumed until a fifo is set
+    static const int FLAG_FRESH = 4;    // set on middleScope when a new spectrum is published
+    static const int INTERVAL_ANALYSIS = 10;    // ms between reads of the fifo
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyser)
+};
\ No newline at end of file
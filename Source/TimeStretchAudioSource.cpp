@@ -0,0 +1,618 @@
+/*
+  ==============================================================================
+
+    TimeStretchAudioSource.cpp
+    Created: 18 Oct 2026 6:12:48am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#include "TimeStretchAudioSource.h"
+
+/******************************************
+* Name:
+*  TimeStretchAudioSource
+* Description:
+*  constructor of the TimeStretchAudioSource class. Changes the
+*  tempo of the input source without changing its pitch, using
+*  WSOLA (waveform similarity overlap-add). Starts disabled, in
+*  which case the input is passed through untouched.
+* Parameters:
+*  source: input audio source, not owned
+* Output:
+*  N/A
+*******************************************/
+TimeStretchAudioSource::TimeStretchAudioSource(AudioSource* _source) :
+    source(_source),
+    numInput(0),
+    numSkip(0),
+    analysisPos(0.0),
+    outputPos(SIZE_HOP),
+    hasTarget(false),
+    wasEnabled(false)
+{}
+
+/******************************************
+* Name:
+*  ~TimeStretchAudioSource
+* Description:
+*  destructor of the TimeStretchAudioSource class.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+TimeStretchAudioSource::~TimeStretchAudioSource() {}
+
+/******************************************
+* Name:
+*  prepareToPlay
+* Description:
+*  override of the base class prepareToPlay method. Prepares the
+*  input source and allocates every buffer used by the audio thread.
+* Parameters:
+*  samplesPerBlockExpected: no. of samples to return on each getNextAudioBlock call
+*  sampleRate: audio sampling rate
+* Output:
+*  N/A
+*******************************************/
+void TimeStretchAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    source->prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    // the input never holds more than the search range around a frame plus one read,
+    // larger ratios skip input instead of buffering it
+    auto sizeInput = 2 * SIZE_SEARCH + SIZE_FRAME + SIZE_PULL + 1;
+    input.setSize(N_CHANNELS, sizeInput);
+    inputMono.allocate(sizeInput, true);
+    overlap.setSize(N_CHANNELS, SIZE_FRAME);
+    output.setSize(N_CHANNELS, SIZE_HOP);
+    pullBuffer.setSize(N_CHANNELS, SIZE_PULL);
+    allocateSearch(coarseSearch, SIZE_OVERLAP / STEP_COARSE, 2 * SIZE_SEARCH / STEP_COARSE + 1);
+    allocateSearch(fineSearch, SIZE_OVERLAP, 2 * STEP_COARSE - 1);
+
+    // periodic Hann window, overlapping windows at half a frame sum to one
+    window.allocate(SIZE_FRAME, false);
+    for (auto i = 0; i < SIZE_FRAME; ++i) {
+        window[i] = 0.5f - 0.5f * std::cos(MathConstants<float>::twoPi * i / SIZE_FRAME);
+    }
+
+    clearState();
+}
+
+/******************************************
+* Name:
+*  releaseResources
+* Description:
+*  override of the base class releaseResources method. Releases
+*  the input source and the stretching buffers.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void TimeStretchAudioSource::releaseResources() {
+    source->releaseResources();
+
+    input.setSize(N_CHANNELS, 0);
+    inputMono.free();
+    overlap.setSize(N_CHANNELS, 0);
+    output.setSize(N_CHANNELS, 0);
+    pullBuffer.setSize(N_CHANNELS, 0);
+    coarseSearch.memory.free();
+    fineSearch.memory.free();
+    window.free();
+}
+
+/******************************************
+* Name:
+*  getNextAudioBlock
+* Description:
+*  override of the base class getNextAudioBlock method. When
+*  disabled, reads straight from the input source. Otherwise
+*  serves the block from stretched output, stretching one more
+*  hop whenever the output runs out. Never allocates or locks.
+* Parameters:
+*  bufferToFill: a descriptor representing the read and write audio buffers.
+* Output:
+*  N/A
+*******************************************/
+void TimeStretchAudioSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) {
+    // input source was moved, drop what was buffered from the old position
+    if (resetPending.exchange(false)) {
+        clearState();
+    }
+
+    // pass through while disabled
+    if (!enabled.load()) {
+        wasEnabled = false;
+        source->getNextAudioBlock(bufferToFill);
+        return;
+    }
+
+    // start over from the current input position when just enabled
+    if (!wasEnabled) {
+        clearState();
+        wasEnabled = true;
+    }
+
+    // serve the block hop by hop, keeping the ratio fixed for the whole block
+    auto hopRatio = ratio.load();
+    auto nChannels = jmin(bufferToFill.buffer->getNumChannels(), N_CHANNELS);
+    auto done = 0;
+    while (done < bufferToFill.numSamples) {
+        if (outputPos >= SIZE_HOP) {
+            processHop(hopRatio);
+        }
+
+        auto n = jmin(bufferToFill.numSamples - done, SIZE_HOP - outputPos);
+        for (auto ch = 0; ch < nChannels; ++ch) {
+            bufferToFill.buffer->copyFrom(ch, bufferToFill.startSample + done, output, ch,
+                outputPos, n);
+        }
+        outputPos += n;
+        done += n;
+    }
+
+    // clear any channels not stretched
+    for (auto ch = nChannels; ch < bufferToFill.buffer->getNumChannels(); ++ch) {
+        bufferToFill.buffer->clear(ch, bufferToFill.startSample, bufferToFill.numSamples);
+    }
+}
+
+/******************************************
+* Name:
+*  reset
+* Description:
+*  drops any input and output buffered for stretching, e.g. after
+*  the input source has been moved to a new position. Takes
+*  effect on the audio thread at the start of the next block.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void TimeStretchAudioSource::reset() {
+    resetPending.store(true);
+}
+
+/******************************************
+* Name:
+*  runBenchmark
+* Description:
+*  measures the cost of stretching a test tone at a few ratios,
+*  without an audio device, and how much of a block's time four
+*  key locked decks would take, on average and in the worst block.
+* Parameters:
+*  N/A
+* Output:
+*  report with one line per ratio, in ns per output sample and us
+*  for the slowest block
+*******************************************/
+String TimeStretchAudioSource::runBenchmark() {
+    const double ratios[] = { 0.5, 0.8, 1.0, 1.25, 2.0 };
+
+    ToneGeneratorAudioSource tone;
+    AudioBuffer<float> buffer(N_CHANNELS, SIZE_BENCHMARK_BLOCK);
+    String report;
+    auto worstSeconds = 0.0;
+    auto worstBlockSeconds = 0.0;
+
+    for (auto r : ratios) {
+        // time stretching the same no. of stereo output samples for every run, block by
+        // block, as the search only runs once per hop and makes some blocks much slower.
+        // Each block keeps its fastest time over a few runs, so a preempted block does
+        // not pass for the search
+        const int nBlocks = SIZE_BENCHMARK / SIZE_BENCHMARK_BLOCK;
+        std::vector<double> fastest((size_t)nBlocks, std::numeric_limits<double>::max());
+        for (auto run = 0; run < N_BENCHMARK_RUNS; ++run) {
+            TimeStretchAudioSource stretcher(&tone);
+            stretcher.prepareToPlay(SIZE_BENCHMARK_BLOCK, BENCHMARK_SAMPLE_RATE);
+            stretcher.setEnabled(true);
+            stretcher.setRatio(r);
+            for (auto block = 0; block < nBlocks; ++block) {
+                AudioSourceChannelInfo info(&buffer, 0, SIZE_BENCHMARK_BLOCK);
+                auto start = Time::getHighResolutionTicks();
+                stretcher.getNextAudioBlock(info);
+                auto blockSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+                fastest[(size_t)block] = jmin(fastest[(size_t)block], blockSeconds);
+            }
+            stretcher.releaseResources();
+        }
+        auto seconds = 0.0;
+        auto blockWorst = 0.0;
+        for (auto blockSeconds : fastest) {
+            seconds += blockSeconds;
+            blockWorst = jmax(blockWorst, blockSeconds);
+        }
+        worstSeconds = jmax(worstSeconds, seconds);
+        worstBlockSeconds = jmax(worstBlockSeconds, blockWorst);
+
+        report << "x" << String(r, 2) << ": "
+            << String(seconds * 1.0e9 / SIZE_BENCHMARK, 2) << " ns/sample, worst block "
+            << String(blockWorst * 1.0e6, 1) << " us" << newLine;
+    }
+
+    // share of the real time of a block taken by the slowest ratio on every deck, on
+    // average and when every deck hits its slowest block in the same buffer
+    auto blockSeconds = (double)SIZE_BENCHMARK_BLOCK / BENCHMARK_SAMPLE_RATE;
+    auto deckSeconds = worstSeconds * SIZE_BENCHMARK_BLOCK / SIZE_BENCHMARK;
+    report << N_BENCHMARK_DECKS << " decks: mean " << String(deckSeconds * N_BENCHMARK_DECKS * 1.0e6, 1)
+        << " us per " << SIZE_BENCHMARK_BLOCK << "-sample block, "
+        << String(100.0 * deckSeconds * N_BENCHMARK_DECKS / blockSeconds, 1) << "% of real time" << newLine;
+    report << N_BENCHMARK_DECKS << " decks: worst " << String(worstBlockSeconds * N_BENCHMARK_DECKS * 1.0e6, 1)
+        << " us per " << SIZE_BENCHMARK_BLOCK << "-sample block, "
+        << String(100.0 * worstBlockSeconds * N_BENCHMARK_DECKS / blockSeconds, 1) << "% of real time" << newLine;
+    return report;
+}
+
+/******************************************
+* Name:
+*  setRatio
+* Description:
+*  setter for the stretch ratio, the no. of input samples
+*  played per output sample. Above 1.0 is faster, below is slower.
+* Parameters:
+*  ratio: stretch ratio (MIN_RATIO-MAX_RATIO)
+* Output:
+*  N/A
+*******************************************/
+void TimeStretchAudioSource::setRatio(double _ratio) {
+    // range check, on fail, print error to debug
+    if (_ratio < MIN_RATIO || _ratio > MAX_RATIO) {
+        DBG("TimeStretchAudioSource::setRatio: ratio should be between " << MIN_RATIO <<
+            " and " << MAX_RATIO << newLine);
+    }
+    // otherwise set stretch ratio, picked up on the next block
+    else {
+        ratio.store(_ratio);
+    }
+}
+
+/******************************************
+* Name:
+*  setEnabled
+* Description:
+*  setter for whether the input is stretched or passed through.
+* Parameters:
+*  shouldBeEnabled: true to stretch, false to pass through
+* Output:
+*  N/A
+*******************************************/
+void TimeStretchAudioSource::setEnabled(bool shouldBeEnabled) {
+    enabled.store(shouldBeEnabled);
+}
+
+/******************************************
+* Name:
+*  isEnabled
+* Description:
+*  getter for whether the input is stretched or passed through.
+* Parameters:
+*  N/A
+* Output:
+*  true if stretching, false if passing through
+*******************************************/
+bool TimeStretchAudioSource::isEnabled() {
+    return enabled.load();
+}
+
+/******************************************
+* Name:
+*  clearState
+* Description:
+*  empties the input and output buffers, so stretching starts
+*  over from the next input sample. Audio thread only.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void TimeStretchAudioSource::clearState() {
+    // start with a search range of silence before the first input sample,
+    // so the first frame can be taken right at the start of the input
+    input.clear();
+    FloatVectorOperations::clear(inputMono.get(), input.getNumSamples());
+    numInput = SIZE_SEARCH;
+    numSkip = 0;
+    analysisPos = SIZE_SEARCH;
+
+    // no output ready and nothing to search against yet
+    overlap.clear();
+    outputPos = SIZE_HOP;
+    hasTarget = false;
+}
+
+/******************************************
+* Name:
+*  pullInput
+* Description:
+*  reads the next chunk of the input source and appends it to
+*  the input buffer, along with its mono mixdown.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void TimeStretchAudioSource::pullInput() {
+    AudioSourceChannelInfo info(&pullBuffer, 0, SIZE_PULL);
+    source->getNextAudioBlock(info);
+
+    // skip samples that were dropped before they were read
+    auto skip = jmin(numSkip, SIZE_PULL);
+    auto n = SIZE_PULL - skip;
+    numSkip -= skip;
+    if (n == 0) {
+        return;
+    }
+
+    jassert(numInput + n <= input.getNumSamples());
+    for (auto ch = 0; ch < N_CHANNELS; ++ch) {
+        input.copyFrom(ch, numInput, pullBuffer, ch, skip, n);
+    }
+    auto* mono = inputMono.get() + numInput;
+    FloatVectorOperations::copyWithMultiply(mono, pullBuffer.getReadPointer(0, skip), 0.5f, n);
+    FloatVectorOperations::addWithMultiply(mono, pullBuffer.getReadPointer(1, skip), 0.5f, n);
+    numInput += n;
+}
+
+/******************************************
+* Name:
+*  dropInput
+* Description:
+*  removes samples from the start of the input buffers. Samples
+*  not read from the input source yet are skipped when they are.
+* Parameters:
+*  numSamples: no. of samples to remove
+* Output:
+*  N/A
+*******************************************/
+void TimeStretchAudioSource::dropInput(int numSamples) {
+    auto n = jmin(numSamples, numInput);
+    numSkip += numSamples - n;
+    numInput -= n;
+
+    // move the rest to the front, source and destination may overlap
+    if (numInput > 0) {
+        for (auto ch = 0; ch < N_CHANNELS; ++ch) {
+            std::memmove(input.getWritePointer(ch), input.getReadPointer(ch, n),
+                (size_t)numInput * sizeof(float));
+        }
+        std::memmove(inputMono.get(), inputMono.get() + n, (size_t)numInput * sizeof(float));
+    }
+}
+
+/******************************************
+* Name:
+*  processHop
+* Description:
+*  stretches one hop: picks the input frame near the nominal
+*  analysis position that best continues the previous frame,
+*  overlap-adds it to the output and moves the analysis position
+*  on by the hop scaled by the ratio.
+* Parameters:
+*  hopRatio: stretch ratio to use for this hop
+* Output:
+*  N/A
+*******************************************/
+void TimeStretchAudioSource::processHop(double hopRatio) {
+    // make sure every frame in the search range has been read
+    auto nominal = roundToInt(analysisPos);
+    while (numInput < nominal + SIZE_SEARCH + SIZE_FRAME) {
+        pullInput();
+    }
+
+    // add the best matching frame, windowed, to the output
+    auto pos = hasTarget ? findBestPosition(nominal) : nominal;
+    for (auto ch = 0; ch < N_CHANNELS; ++ch) {
+        FloatVectorOperations::addWithMultiply(overlap.getWritePointer(ch),
+            input.getReadPointer(ch, pos), window.get(), SIZE_FRAME);
+    }
+
+    // the input that follows this frame is what the next frame should look like
+    setSearchTarget(coarseSearch, inputMono.get() + pos + SIZE_HOP, STEP_COARSE);
+    setSearchTarget(fineSearch, inputMono.get() + pos + SIZE_HOP, 1);
+    hasTarget = true;
+
+    // the first hop of the frame is complete, shift the rest down for the next frame
+    for (auto ch = 0; ch < N_CHANNELS; ++ch) {
+        output.copyFrom(ch, 0, overlap, ch, 0, SIZE_HOP);
+        overlap.copyFrom(ch, 0, overlap, ch, SIZE_HOP, SIZE_OVERLAP);
+        overlap.clear(ch, SIZE_OVERLAP, SIZE_FRAME - SIZE_OVERLAP);
+    }
+    outputPos = 0;
+
+    // move on through the input, dropping what the next search cannot reach
+    analysisPos += SIZE_HOP * hopRatio;
+    auto drop = (int)analysisPos - SIZE_SEARCH;
+    if (drop > 0) {
+        dropInput(drop);
+        analysisPos -= drop;
+    }
+}
+
+/******************************************
+* Name:
+*  findBestPosition
+* Description:
+*  searches the input around the nominal position for the frame
+*  most similar to the natural continuation of the previous frame.
+*  Searches coarsely first, on every STEP_COARSE position and
+*  sample, then refines around the best coarse match.
+* Parameters:
+*  nominal: nominal start of the frame in the input buffer
+* Output:
+*  start of the chosen frame in the input buffer
+*******************************************/
+int TimeStretchAudioSource::findBestPosition(int nominal) {
+    auto first = nominal - SIZE_SEARCH;
+    auto last = nominal + SIZE_SEARCH;
+
+    // coarse search over the whole range
+    setSearchInput(coarseSearch, inputMono.get() + first, coarseSearch.maxPositions, STEP_COARSE);
+    auto best = SIZE_SEARCH / STEP_COARSE;
+    auto bestSimilarity = getSimilarity(coarseSearch, best);
+    for (auto i = 0; i < coarseSearch.numPositions; ++i) {
+        auto similarity = getSimilarity(coarseSearch, i);
+        if (similarity > bestSimilarity) {
+            bestSimilarity = similarity;
+            best = i;
+        }
+    }
+
+    // fine search between the neighbouring coarse positions
+    auto coarse = first + best * STEP_COARSE;
+    auto fineFirst = jmax(first, coarse - STEP_COARSE + 1);
+    auto fineLast = jmin(last, coarse + STEP_COARSE - 1);
+    setSearchInput(fineSearch, inputMono.get() + fineFirst, fineLast - fineFirst + 1, 1);
+    best = coarse - fineFirst;
+    bestSimilarity = getSimilarity(fineSearch, best);
+    for (auto i = 0; i < fineSearch.numPositions; ++i) {
+        auto similarity = getSimilarity(fineSearch, i);
+        if (similarity > bestSimilarity) {
+            bestSimilarity = similarity;
+            best = i;
+        }
+    }
+
+    return fineFirst + best;
+}
+
+/******************************************
+* Name:
+*  allocateSearch
+* Description:
+*  allocates the aligned scratch memory of a search pass.
+* Parameters:
+*  search: search pass to allocate
+*  sizeTarget: no. of samples in the target
+*  maxPositions: max. no. of positions searched
+* Output:
+*  N/A
+*******************************************/
+void TimeStretchAudioSource::allocateSearch(Search& search, int sizeTarget, int maxPositions) {
+    search.sizeTarget = sizeTarget;
+    search.maxPositions = maxPositions;
+    search.numPositions = 0;
+
+    // each copy holds the target delayed by up to SIZE_SIMD - 1 samples, and a frame
+    // starting up to that many samples early still ends within the input window
+    search.sizeCopy = (sizeTarget + 2 * SIZE_SIMD - 2) / SIZE_SIMD * SIZE_SIMD;
+    auto sizeInput = (maxPositions + search.sizeCopy + SIZE_SIMD - 1) / SIZE_SIMD * SIZE_SIMD;
+    search.memory.allocate((size_t)(SIZE_SIMD * search.sizeCopy + sizeInput + maxPositions +
+        SIZE_SIMD), true);
+    search.targets = dsp::SIMDRegister<float>::getNextSIMDAlignedPtr(search.memory.get());
+    search.input = search.targets + SIZE_SIMD * search.sizeCopy;
+    search.energies = search.input + sizeInput;
+}
+
+/******************************************
+* Name:
+*  setSearchTarget
+* Description:
+*  copies every step-th sample of a target into each delayed
+*  target copy of a search pass. Called once per hop.
+* Parameters:
+*  search: search pass to set
+*  target: start of the target, search.sizeTarget * step samples
+*  step: stride the target is decimated with
+* Output:
+*  N/A
+*******************************************/
+void TimeStretchAudioSource::setSearchTarget(Search& search, const float* target, int step) {
+    // decimate into the undelayed copy
+    auto* undelayed = search.targets;
+    for (auto i = 0; i < search.sizeTarget; ++i) {
+        undelayed[i] = target[i * step];
+    }
+    FloatVectorOperations::clear(undelayed + search.sizeTarget, search.sizeCopy - search.sizeTarget);
+
+    // the delayed copies start with zeros instead
+    for (auto delay = 1; delay < SIZE_SIMD; ++delay) {
+        auto* copy = search.targets + delay * search.sizeCopy;
+        FloatVectorOperations::clear(copy, delay);
+        FloatVectorOperations::copy(copy + delay, undelayed, search.sizeTarget);
+        FloatVectorOperations::clear(copy + delay + search.sizeTarget,
+            search.sizeCopy - delay - search.sizeTarget);
+    }
+}
+
+/******************************************
+* Name:
+*  setSearchInput
+* Description:
+*  copies every step-th sample of the input window to search
+*  into a search pass and sums up its energy at each position.
+*  Called once per hop.
+* Parameters:
+*  search: search pass to set
+*  input: start of the first frame searched
+*  numPositions: no. of positions searched, up to the max. allocated
+*  step: stride the input is decimated with
+* Output:
+*  N/A
+*******************************************/
+void TimeStretchAudioSource::setSearchInput(Search& search, const float* input, int numPositions,
+    int step) {
+    jassert(numPositions <= search.maxPositions);
+    search.numPositions = numPositions;
+    auto sizeInput = numPositions + search.sizeTarget - 1;
+    for (auto i = 0; i < sizeInput; ++i) {
+        search.input[i] = input[i * step];
+    }
+
+    // energy of each frame as a running sum, adding the sample entering the frame
+    // and removing the one leaving it
+    auto* x = search.input;
+    auto energy = 0.0;
+    for (auto i = 0; i < search.sizeTarget; ++i) {
+        energy += (double)x[i] * x[i];
+    }
+    search.energies[0] = (float)energy;
+    for (auto i = 1; i < numPositions; ++i) {
+        auto entering = x[i + search.sizeTarget - 1];
+        energy += (double)entering * entering - (double)x[i - 1] * x[i - 1];
+        search.energies[i] = (float)jmax(0.0, energy);
+    }
+}
+
+/******************************************
+* Name:
+*  getSimilarity
+* Description:
+*  normalised cross-correlation between the target and the
+*  input frame at a position of a search pass. Uses the target
+*  copy delayed so the frame starts on a SIMD boundary, so every
+*  load is aligned and unit stride.
+* Parameters:
+*  search: search pass
+*  position: position of the frame in the search pass
+* Output:
+*  similarity, higher is more similar
+*******************************************/
+float TimeStretchAudioSource::getSimilarity(const Search& search, int position) {
+    auto delay = position % SIZE_SIMD;
+    auto* target = search.targets + delay * search.sizeCopy;
+    auto* frame = search.input + position - delay;
+
+    // two independent sums, so the loop does not wait on one accumulator
+    auto corrA = dsp::SIMDRegister<float>::expand(0.0f);
+    auto corrB = dsp::SIMDRegister<float>::expand(0.0f);
+    auto i = 0;
+    for (; i + 2 * SIZE_SIMD <= search.sizeCopy; i += 2 * SIZE_SIMD) {
+        corrA += dsp::SIMDRegister<float>::fromRawArray(target + i) *
+            dsp::SIMDRegister<float>::fromRawArray(frame + i);
+        corrB += dsp::SIMDRegister<float>::fromRawArray(target + i + SIZE_SIMD) *
+            dsp::SIMDRegister<float>::fromRawArray(frame + i + SIZE_SIMD);
+    }
+    if (i < search.sizeCopy) {
+        corrA += dsp::SIMDRegister<float>::fromRawArray(target + i) *
+            dsp::SIMDRegister<float>::fromRawArray(frame + i);
+    }
+
+    return (corrA + corrB).sum() / std::sqrt(search.energies[position] + 1.0e-9f);
+}
+
+const double TimeStretchAudioSource::MIN_RATIO = 0.25;
+const double TimeStretchAudioSource::MAX_RATIO = 10.0;
+const String TimeStretchAudioSource::ARG_BENCHMARK = "--benchmark-stretcher";
\ No newline at end of file
@@ -0,0 +1,345 @@
+/*
+  ==============================================================================
+
+    TimeStretchAudioSource.h
+    Created: 18 Oct 2026 6:12:48am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+using namespace juce;
+
+class TimeStretchAudioSource : public AudioSource {
+public:
+    // constructors & destructors
+    /******************************************
+    * Name:
+    *  TimeStretchAudioSource
+    * Description:
+    *  constructor of the TimeStretchAudioSource class. Changes the
+    *  tempo of the input source without changing its pitch, using
+    *  WSOLA (waveform similarity overlap-add). Starts disabled, in
+    *  which case the input is passed through untouched.
+    * Parameters:
+    *  source: input audio source, not owned
+    * Output:
+    *  N/A
+    *******************************************/
+    TimeStretchAudioSource(AudioSource* source);
+
+    /******************************************
+    * Name:
+    *  ~TimeStretchAudioSource
+    * Description:
+    *  destructor of the TimeStretchAudioSource class.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    ~TimeStretchAudioSource() override;
+
+    // base class overrides
+    /******************************************
+    * Name:
+    *  prepareToPlay
+    * Description:
+    *  override of the base class prepareToPlay method. Prepares the
+    *  input source and allocates every buffer used by the audio thread.
+    * Parameters:
+    *  samplesPerBlockExpected: no. of samples to return on each getNextAudioBlock call
+    *  sampleRate: audio sampling rate
+    * Output:
+    *  N/A
+    *******************************************/
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /******************************************
+    * Name:
+    *  releaseResources
+    * Description:
+    *  override of the base class releaseResources method. Releases
+    *  the input source and the stretching buffers.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void releaseResources() override;
+
+    /******************************************
+    * Name:
+    *  getNextAudioBlock
+    * Description:
+    *  override of the base class getNextAudioBlock method. When
+    *  disabled, reads straight from the input source. Otherwise
+    *  serves the block from stretched output, stretching one more
+    *  hop whenever the output runs out. Never allocates or locks.
+    * Parameters:
+    *  bufferToFill: a descriptor representing the read and write audio buffers.
+    * Output:
+    *  N/A
+    *******************************************/
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    // methods
+    /******************************************
+    * Name:
+    *  reset
+    * Description:
+    *  drops any input and output buffered for stretching, e.g. after
+    *  the input source has been moved to a new position. Takes
+    *  effect on the audio thread at the start of the next block.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void reset();
+
+    /******************************************
+    * Name:
+    *  runBenchmark
+    * Description:
+    *  measures the cost of stretching a test tone at a few ratios,
+    *  without an audio device, and how much of a block's time four
+    *  key locked decks would take, on average and in the worst block.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  report with one line per ratio, in ns per output sample and us
+    *  for the slowest block
+    *******************************************/
+    static String runBenchmark();
+
+    // getters & setters
+    /******************************************
+    * Name:
+    *  setRatio
+    * Description:
+    *  setter for the stretch ratio, the no. of input samples
+    *  played per output sample. Above 1.0 is faster, below is slower.
+    * Parameters:
+    *  ratio: stretch ratio (MIN_RATIO-MAX_RATIO)
+    * Output:
+    *  N/A
+    *******************************************/
+    void setRatio(double ratio);
+
+    /******************************************
+    * Name:
+    *  setEnabled
+    * Description:
+    *  setter for whether the input is stretched or passed through.
+    * Parameters:
+    *  shouldBeEnabled: true to stretch, false to pass through
+    * Output:
+    *  N/A
+    *******************************************/
+    void setEnabled(bool shouldBeEnabled);
+
+    /******************************************
+    * Name:
+    *  isEnabled
+    * Description:
+    *  getter for whether the input is stretched or passed through.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  true if stretching, false if passing through
+    *******************************************/
+    bool isEnabled();
+
+    // public constants
+    static const double MIN_RATIO;  // lower limit of stretch ratio
+    static const double MAX_RATIO;  // upper limit of stretch ratio
+    static const String ARG_BENCHMARK;  // command line argument to run the benchmark
+
+private:
+    // one pass of the search for the best matching frame. The target and input are
+    // decimated into SIMD aligned scratch memory, so comparing a frame is a unit
+    // stride run of aligned vector loads
+    struct Search {
+        HeapBlock<float> memory;    // backing memory of the arrays below
+        float* targets;     // SIZE_SIMD copies of the target, delayed by 0 to SIZE_SIMD - 1 samples
+        float* input;       // input window searched
+        float* energies;    // energy of the input frame at each position
+        int sizeTarget;     // no. of samples in the target
+        int sizeCopy;       // no. of samples per delayed target copy, a multiple of SIZE_SIMD
+        int maxPositions;   // max. no. of positions searched
+        int numPositions;   // no. of positions searched in the current hop
+    };
+
+    // methods
+    /******************************************
+    * Name:
+    *  clearState
+    * Description:
+    *  empties the input and output buffers, so stretching starts
+    *  over from the next input sample. Audio thread only.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void clearState();
+
+    /******************************************
+    * Name:
+    *  pullInput
+    * Description:
+    *  reads the next chunk of the input source and appends it to
+    *  the input buffer, along with its mono mixdown.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void pullInput();
+
+    /******************************************
+    * Name:
+    *  dropInput
+    * Description:
+    *  removes samples from the start of the input buffers. Samples
+    *  not read from the input source yet are skipped when they are.
+    * Parameters:
+    *  numSamples: no. of samples to remove
+    * Output:
+    *  N/A
+    *******************************************/
+    void dropInput(int numSamples);
+
+    /******************************************
+    * Name:
+    *  processHop
+    * Description:
+    *  stretches one hop: picks the input frame near the nominal
+    *  analysis position that best continues the previous frame,
+    *  overlap-adds it to the output and moves the analysis position
+    *  on by the hop scaled by the ratio.
+    * Parameters:
+    *  hopRatio: stretch ratio to use for this hop
+    * Output:
+    *  N/A
+    *******************************************/
+    void processHop(double hopRatio);
+
+    /******************************************
+    * Name:
+    *  findBestPosition
+    * Description:
+    *  searches the input around the nominal position for the frame
+    *  most similar to the natural continuation of the previous frame.
+    *  Searches coarsely first, on every STEP_COARSE position and
+    *  sample, then refines around the best coarse match.
+    * Parameters:
+    *  nominal: nominal start of the frame in the input buffer
+    * Output:
+    *  start of the chosen frame in the input buffer
+    *******************************************/
+    int findBestPosition(int nominal);
+
+    /******************************************
+    * Name:
+    *  allocateSearch
+    * Description:
+    *  allocates the aligned scratch memory of a search pass.
+    * Parameters:
+    *  search: search pass to allocate
+    *  sizeTarget: no. of samples in the target
+    *  maxPositions: max. no. of positions searched
+    * Output:
+    *  N/A
+    *******************************************/
+    static void allocateSearch(Search& search, int sizeTarget, int maxPositions);
+
+    /******************************************
+    * Name:
+    *  setSearchTarget
+    * Description:
+    *  copies every step-th sample of a target into each delayed
+    *  target copy of a search pass. Called once per hop.
+    * Parameters:
+    *  search: search pass to set
+    *  target: start of the target, search.sizeTarget * step samples
+    *  step: stride the target is decimated with
+    * Output:
+    *  N/A
+    *******************************************/
+    static void setSearchTarget(Search& search, const float* target, int step);
+
+    /******************************************
+    * Name:
+    *  setSearchInput
+    * Description:
+    *  copies every step-th sample of the input window to search
+    *  into a search pass and sums up its energy at each position.
+    *  Called once per hop.
+    * Parameters:
+    *  search: search pass to set
+    *  input: start of the first frame searched
+    *  numPositions: no. of positions searched, up to the max. allocated
+    *  step: stride the input is decimated with
+    * Output:
+    *  N/A
+    *******************************************/
+    static void setSearchInput(Search& search, const float* input, int numPositions, int step);
+
+    /******************************************
+    * Name:
+    *  getSimilarity
+    * Description:
+    *  normalised cross-correlation between the target and the
+    *  input frame at a position of a search pass. Uses the target
+    *  copy delayed so the frame starts on a SIMD boundary, so every
+    *  load is aligned and unit stride.
+    * Parameters:
+    *  search: search pass
+    *  position: position of the frame in the search pass
+    * Output:
+    *  similarity, higher is more similar
+    *******************************************/
+    static float getSimilarity(const Search& search, int position);
+
+    // functionality members
+    AudioSource* source;    // input audio source
+    AudioBuffer<float> input;   // input waiting to be stretched
+    HeapBlock<float> inputMono; // mono mixdown of the input, used for the search
+    int numInput;   // no. of samples held in the input buffers
+    int numSkip;    // no. of samples still to skip when reading the input source
+    double analysisPos; // nominal start of the next frame in the input buffers
+    AudioBuffer<float> overlap; // output frame being overlap-added
+    AudioBuffer<float> output;  // finished output of the last hop
+    int outputPos;  // next sample to serve from the output buffer
+    AudioBuffer<float> pullBuffer;  // scratch buffer the input source is read into
+    HeapBlock<float> window;    // Hann window applied to each frame
+    Search coarseSearch;    // every STEP_COARSE-th position over the whole search range
+    Search fineSearch;      // every position around the best coarse match
+    bool hasTarget; // if a previous frame exists to search against
+    bool wasEnabled;    // if stretching was enabled on the last block
+    std::atomic<double> ratio{ 1.0 };   // stretch ratio
+    std::atomic<bool> enabled{ false }; // if stretching is enabled
+    std::atomic<bool> resetPending{ false };    // if buffers should be dropped on the next block
+
+    // private constants
+    static const int N_CHANNELS = 2;    // no. of channels stretched
+    static const int SIZE_FRAME = 2048; // no. of samples in each overlap-added frame
+    static const int SIZE_HOP = SIZE_FRAME / 2; // no. of output samples per frame
+    static const int SIZE_OVERLAP = SIZE_FRAME - SIZE_HOP;  // no. of samples compared in the search
+    static const int SIZE_SEARCH = 512; // max. distance of a frame from its nominal position
+    static const int STEP_COARSE = 4;   // stride of the coarse search
+    static const int SIZE_PULL = 512;   // no. of samples read from the input source at a time
+    static const int SIZE_SIMD = (int)dsp::SIMDRegister<float>::SIMDNumElements;  // no. of floats per SIMD register
+    static const int SIZE_BENCHMARK = 1 << 20;  // no. of output samples stretched per benchmark run
+    static const int SIZE_BENCHMARK_BLOCK = 128;    // block size used by the benchmark
+    static const int BENCHMARK_SAMPLE_RATE = 48000; // sampling rate used by the benchmark
+    static const int N_BENCHMARK_DECKS = 4; // no. of decks the benchmark budget is given for
+    static const int N_BENCHMARK_RUNS = 5;  // no. of runs per ratio, each block keeps its fastest
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimeStretchAudioSource)
+};
\ No newline at end of file
@@ -15,23 +15,16 @@
 *  Track
 * Description:
 *  constructor of the Track class. Initializes the
-*  various properties. Get track duration using a reader
-*  obtained from the AudioFormatManager.
+*  various properties. Does not open the file, the
+*  metadata is filled in later with setMetadata.
 * Parameters:
 *  fullPath: full path of the track
-*  formatManager: reference to global AudioFormatManager
 * Output:
 *  N/A
 *******************************************/
-Track::Track(String _fullPath, AudioFormatManager &formatManager):
-    fullPath(_fullPath), loaded{ false } {
-    // create URL from the full path
-    auto audioURL = URL(File(fullPath));
-    // generate a reader to obtain total track duration
-    auto* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
-    duration = reader->lengthInSamples / reader->sampleRate;
-    delete reader;
-}
+Track::Track(String _fullPath):
+    fullPath(_fullPath), loaded{ false }, 
+    metadata(std::make_shared<TrackMetadata>()) {}
 
 /******************************************
 * Name:
@@ -63,6 +56,35 @@ void Track::setSpeed(double ratio) {
     audioPlayer->setSpeed(ratio);
 }
 
+/******************************************
+* Name:
+*  setKeyLock
+* Description:
+*  setter for key lock by passing to associated player.
+* Parameters:
+*  isLocked: true to keep the pitch when changing speed
+* Output:
+*  N/A
+*******************************************/
+void Track::setKeyLock(bool isLocked) {
+    audioPlayer->setKeyLock(isLocked);
+}
+
+/******************************************
+* Name:
+*  setResamplerQuality
+* Description:
+*  setter for the resampling quality by passing to
+*  associated player.
+* Parameters:
+*  quality: linear, cubic or sinc
+* Output:
+*  N/A
+*******************************************/
+void Track::setResamplerQuality(ResamplerAudioSource::Quality quality) {
+    audioPlayer->setResamplerQuality(quality);
+}
+
 /******************************************
 * Name:
 *  setVolume
@@ -94,6 +116,53 @@ void Track::setFrequencyRange(double fLow, double fHigh) {
     audioPlayer->setCutoffFrequency(fLow, fHigh);
 }
 
+/******************************************
+* Name:
+*  setFilterSlope
+* Description:
+*  setter for the slope of the bandwidth filters by passing
+*  to associated player.
+* Parameters:
+*  slope: 12, 24 or 48 dB/oct
+* Output:
+*  N/A
+*******************************************/
+void Track::setFilterSlope(FilterAudioSource::Slope slope) {
+    audioPlayer->setFilterSlope(slope);
+}
+
+/******************************************
+* Name:
+*  setEqGain
+* Description:
+*  setter for the gain of an EQ band by passing to
+*  associated player.
+* Parameters:
+*  band: low, mid or high
+*  gainDb: gain of the band in dB
+* Output:
+*  N/A
+*******************************************/
+void Track::setEqGain(FilterAudioSource::Band band, double gainDb) {
+    audioPlayer->setEqGain(band, gainDb);
+}
+
+/******************************************
+* Name:
+*  setEqKill
+* Description:
+*  setter for the kill switch of an EQ band by passing
+*  to associated player.
+* Parameters:
+*  band: low, mid or high
+*  isKilled: true to silence the band
+* Output:
+*  N/A
+*******************************************/
+void Track::setEqKill(FilterAudioSource::Band band, bool isKilled) {
+    audioPlayer->setEqKill(band, isKilled);
+}
+
 /******************************************
 * Name:
 *  setFrequencyDisplay
@@ -148,7 +217,56 @@ String Track::getFullPath() {
 *  total duration of track
 *******************************************/
 double Track::getDuration() {
-    return duration;
+    return metadata->duration.load();
+}
+
+/******************************************
+* Name:
+*  getMetadata
+* Description:
+*  getter for the shared metadata of the track, used
+*  to fill it in from a background probe.
+* Parameters:
+*  N/A
+* Output:
+*  shared pointer to the track's metadata
+*******************************************/
+std::shared_ptr<TrackMetadata> Track::getMetadata() {
+    return metadata;
+}
+
+/******************************************
+* Name:
+*  setMetadata
+* Description:
+*  setter for the metadata of the track, marks the
+*  metadata as probed. Safe to call from any thread.
+* Parameters:
+*  duration: total duration in seconds
+*  sampleRate: sampling rate of the file
+*  numChannels: no. of channels in the file
+* Output:
+*  N/A
+*******************************************/
+void Track::setMetadata(double duration, double sampleRate, int numChannels) {
+    metadata->duration.store(duration);
+    metadata->sampleRate.store(sampleRate);
+    metadata->numChannels.store(numChannels);
+    metadata->probed.store(true);
+}
+
+/******************************************
+* Name:
+*  isProbed
+* Description:
+*  getter to check if the metadata of the track is known.
+* Parameters:
+*  N/A
+* Output:
+*  if the metadata has been probed
+*******************************************/
+bool Track::isProbed() {
+    return metadata->probed.load();
 }
 
 /******************************************
@@ -156,13 +274,20 @@ double Track::getDuration() {
 *  getDurationAsString
 * Description:
 *  getter for the total duration formatted as
-*  "HH:MM:SS"
+*  "HH:MM:SS", or a placeholder if not probed yet.
 * Parameters:
 *  N/A
 * Output:
 *  returns a formatted string of the total duration
 *******************************************/
 String Track::getDurationAsString() {
+    // placeholder until the probe is done
+    if (!isProbed()) {
+        return "--:--:--";
+    }
+
+    auto duration = getDuration();
+
     // compute individual seconds, minutes and hours
     int hrs = (int)duration / 3600;
     int min = (int)duration / 60;
@@ -200,6 +325,20 @@ bool Track::isLoaded() {
     return loaded;
 }
 
+/******************************************
+* Name:
+*  isPlaying
+* Description:
+*  getter to check if the track is playing
+* Parameters:
+*  N/A
+* Output:
+*  if track is playing in its deck player
+*******************************************/
+bool Track::isPlaying() {
+    return audioPlayer->isPlaying();
+}
+
 /******************************************
 * Name:
 *  isMatch
@@ -262,9 +401,10 @@ void Track::stop() {
 * Name:
 *  load
 * Description:
-*  associate a DJAudioPlayer with the track and load
-*  the track specified in this instance. send a message
-*  so the playlist can enable/disable relevant buttons.
+*  associate a DJAudioPlayer with the track. The audio
+*  itself is attached with setSource once it has been loaded
+*  in the background. send a message so the playlist can
+*  enable/disable relevant buttons.
 * Parameters:
 *  player: the DJAudioPlayer to load the track in
 * Output:
@@ -274,18 +414,30 @@ void Track::load(DJAudioPlayer *_player) {
     // associate DJAudioPlayer
     audioPlayer = _player;
 
-    // load the track into the audio player
-    audioPlayer->loadURL(URL{ File{fullPath} });
-    audioPlayer->setPositionRelative(0.000001);
-
     // update flag
     loaded = true;
 
-
     // send message to all change listeners (playlist)
     sendChangeMessage();
 }
 
+/******************************************
+* Name:
+*  setSource
+* Description:
+*  attach the audio loaded in the background to the
+*  associated player and rewind to the start.
+* Parameters:
+*  source: read-ahead source of this track's audio
+* Output:
+*  N/A
+*******************************************/
+void Track::setSource(std::unique_ptr<ReadAheadAudioSource> source) {
+    // load the track into the audio player
+    audioPlayer->setSource(std::move(source));
+    audioPlayer->setPositionRelative(0.000001);
+}
+
 /******************************************
 * Name:
 *  unload
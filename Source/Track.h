@@ -16,6 +16,17 @@ using namespace juce;
 #include "DJAudioPlayer.h"
 #include "FrequencyDisplay.h"
 
+// metadata of a track, probed from the file in the background. Shared
+// between the track and the probe, so it can outlive a removed track.
+struct TrackMetadata {
+    std::atomic<bool> probed{ false };      // flag indicating if the metadata is known
+    std::atomic<double> duration{ 0 };      // total duration of track in seconds
+    std::atomic<double> sampleRate{ 0 };    // sampling rate of the file
+    std::atomic<int> numChannels{ 0 };      // no. of channels in the file
+    std::atomic<int64> fileSize{ 0 };       // size of the file when probed, to detect changes
+    std::atomic<int64> modificationTime{ 0 };   // modification time of the file when probed (ms)
+};
+
 class Track: public ChangeBroadcaster {
 public:
     // constructors & destructors
@@ -24,15 +35,14 @@ public:
     *  Track
     * Description:
     *  constructor of the Track class. Initializes the
-    *  various properties. Get track duration using a reader
-    *  obtained from the AudioFormatManager.
+    *  various properties. Does not open the file, the 
+    *  metadata is filled in later with setMetadata.
     * Parameters:
     *  fullPath: full path of the track
-    *  formatManager: reference to global AudioFormatManager
     * Output:
     *  N/A
     *******************************************/
-    Track(String fullPath, AudioFormatManager& formatManager);
+    Track(String fullPath);
 
     // getters & setters
     /******************************************
@@ -61,6 +71,31 @@ public:
     *******************************************/
     void setSpeed(double ratio);
 
+    /******************************************
+    * Name:
+    *  setKeyLock
+    * Description:
+    *  setter for key lock by passing to associated player.
+    * Parameters:
+    *  isLocked: true to keep the pitch when changing speed
+    * Output:
+    *  N/A
+    *******************************************/
+    void setKeyLock(bool isLocked);
+
+    /******************************************
+    * Name:
+    *  setResamplerQuality
+    * Description:
+    *  setter for the resampling quality by passing to
+    *  associated player.
+    * Parameters:
+    *  quality: linear, cubic or sinc
+    * Output:
+    *  N/A
+    *******************************************/
+    void setResamplerQuality(ResamplerAudioSource::Quality quality);
+
     /******************************************
     * Name:
     *  setVolume
@@ -88,6 +123,47 @@ public:
     *******************************************/
     void setFrequencyRange(double fLow, double fHigh);
 
+    /******************************************
+    * Name:
+    *  setFilterSlope
+    * Description:
+    *  setter for the slope of the bandwidth filters by passing
+    *  to associated player.
+    * Parameters:
+    *  slope: 12, 24 or 48 dB/oct
+    * Output:
+    *  N/A
+    *******************************************/
+    void setFilterSlope(FilterAudioSource::Slope slope);
+
+    /******************************************
+    * Name:
+    *  setEqGain
+    * Description:
+    *  setter for the gain of an EQ band by passing to
+    *  associated player.
+    * Parameters:
+    *  band: low, mid or high
+    *  gainDb: gain of the band in dB
+    * Output:
+    *  N/A
+    *******************************************/
+    void setEqGain(FilterAudioSource::Band band, double gainDb);
+
+    /******************************************
+    * Name:
+    *  setEqKill
+    * Description:
+    *  setter for the kill switch of an EQ band by passing
+    *  to associated player.
+    * Parameters:
+    *  band: low, mid or high
+    *  isKilled: true to silence the band
+    * Output:
+    *  N/A
+    *******************************************/
+    void setEqKill(FilterAudioSource::Band band, bool isKilled);
+
     /******************************************
     * Name:
     *  setFrequencyDisplay
@@ -133,16 +209,56 @@ public:
     * Parameters:
     *  N/A
     * Output:
-    *  total duration of track
+    *  total duration of track, 0 if not probed yet
     *******************************************/
     double getDuration();
 
+    /******************************************
+    * Name:
+    *  getMetadata
+    * Description:
+    *  getter for the shared metadata of the track, used
+    *  to fill it in from a background probe.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  shared pointer to the track's metadata
+    *******************************************/
+    std::shared_ptr<TrackMetadata> getMetadata();
+
+    /******************************************
+    * Name:
+    *  setMetadata
+    * Description:
+    *  setter for the metadata of the track, marks the
+    *  metadata as probed. Safe to call from any thread.
+    * Parameters:
+    *  duration: total duration in seconds
+    *  sampleRate: sampling rate of the file
+    *  numChannels: no. of channels in the file
+    * Output:
+    *  N/A
+    *******************************************/
+    void setMetadata(double duration, double sampleRate, int numChannels);
+
+    /******************************************
+    * Name:
+    *  isProbed
+    * Description:
+    *  getter to check if the metadata of the track is known.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  if the metadata has been probed
+    *******************************************/
+    bool isProbed();
+
     /******************************************
     * Name:
     *  getDurationAsString
     * Description:
     *  getter for the total duration formatted as 
-    *  "HH:MM:SS"
+    *  "HH:MM:SS", or a placeholder if not probed yet.
     * Parameters:
     *  N/A
     * Output:
@@ -174,6 +290,18 @@ public:
     *******************************************/
     bool isLoaded();
 
+    /******************************************
+    * Name:
+    *  isPlaying
+    * Description:
+    *  getter to check if the track is playing
+    * Parameters:
+    *  N/A
+    * Output:
+    *  if track is playing in its deck player
+    *******************************************/
+    bool isPlaying();
+
     // methods
     /******************************************
     * Name:
@@ -227,9 +355,10 @@ public:
     * Name:
     *  load
     * Description:
-    *  associate a DJAudioPlayer with the track and load
-    *  the track specified in this instance. send a message
-    *  so the playlist can enable/disable relevant buttons.
+    *  associate a DJAudioPlayer with the track. The audio
+    *  itself is attached with setSource once it has been loaded
+    *  in the background. send a message so the playlist can 
+    *  enable/disable relevant buttons.
     * Parameters:
     *  player: the DJAudioPlayer to load the track in
     * Output:
@@ -237,6 +366,19 @@ public:
     *******************************************/
     void load(DJAudioPlayer* player);
 
+    /******************************************
+    * Name:
+    *  setSource
+    * Description:
+    *  attach the audio loaded in the background to the 
+    *  associated player and rewind to the start.
+    * Parameters:
+    *  source: read-ahead source of this track's audio
+    * Output:
+    *  N/A
+    *******************************************/
+    void setSource(std::unique_ptr<ReadAheadAudioSource> source);
+
     /******************************************
     * Name:
     *  unload
@@ -280,7 +422,7 @@ public:
 private:
     // functionality members
     bool loaded;    // flag indicating if the track is loaded in a deck player component
-    double duration;    // total duration of track
+    std::shared_ptr<TrackMetadata> metadata;    // metadata probed in the background
     String fullPath;    // full path of track
     int playerId;       // associated DJAudioPlayer id
     DJAudioPlayer *audioPlayer; // pointer to associated DJAudioPlayer
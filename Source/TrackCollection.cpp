@@ -24,7 +24,26 @@
 *******************************************/
 TrackCollection::TrackCollection(AudioFormatManager& _formatManager) :
     formatManager(_formatManager),
-    tracksSearched(false) {}
+    tracksSearched(false),
+    searchNames(std::make_shared<const StringArray>()),
+    database(ConfigManager::getFile(ConfigManager::PATH_LIBRARY)) {}
+
+/******************************************
+* Name:
+*  ~TrackCollection
+* Description:
+*  destructor for the TrackCollection class. Drops
+*  queued metadata probes and searches and waits for
+*  running ones.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+TrackCollection::~TrackCollection() {
+    searchPool.removeAllJobs(true, 2000);
+    probePool.removeAllJobs(true, 2000);
+}
 
 /******************************************
 * Name:
@@ -65,6 +84,28 @@ bool TrackCollection::isKnownFormat(String format) {
     return false;
 }
 
+/******************************************
+* Name:
+*  getKnownFormats
+* Description:
+*  Returns a snapshot of the file extensions the
+*  AudioManager is able to process, which can be used
+*  from other threads.
+* Parameters:
+*  N/A
+* Output:
+*  set of processable file extensions
+*******************************************/
+std::unordered_set<String> TrackCollection::getKnownFormats() {
+    std::unordered_set<String> formats;
+    for (auto i = 0; i < formatManager.getNumKnownFormats(); ++i) {
+        for (auto f : formatManager.getKnownFormat(i)->getFileExtensions()) {
+            formats.insert(f);
+        }
+    }
+    return formats;
+}
+
 /******************************************
 * Name:
 *  size
@@ -87,45 +128,61 @@ int TrackCollection::size() {
 * Description:
 *  Check if the file extension of the path provided
 *  is processable by the format manager, if so, add
-*  track to the collection
+*  track to the collection and queue its metadata to
+*  be probed in the background
 * Parameters:
 *  path: full path of track to add.
 * Output:
 *  N/A
 *******************************************/
 void TrackCollection::addTrack(const String &path) {
-    if (isKnownFormat(File(path).getFileExtension())) {
-        tracks.add(new Track(path, formatManager));
-    }
+    addTracks(StringArray(path));
 }
 
 /******************************************
 * Name:
 *  addTracks
 * Description:
-*  Adds an array of paths of tracks.
-*  First check, if the given track exist in the collection,
-*  If not, add the track to the collection
+*  Adds an array of paths of tracks. Paths already
+*  in the collection are skipped.
+*  The added tracks are appended to the database together
+*  and queued to be probed in the background, and passed
+*  to onTracksAdded.
 * Parameters:
-*  path: array of full path of tracks to add
+*  newPaths: array of full path of tracks to add
 * Output:
 *  N/A
 *******************************************/
-void TrackCollection::addTracks(const StringArray &paths) {
-    // iterate through all paths in the provided argument
-    for (auto p : paths) {
-        auto exists = false;
-        // iterate over all existing tracks in collection
-        for (auto i = 0; i < tracks.size(); ++i) {
-            if (tracks[i]->getFullPath() == p) {
-                exists = true;
-                break;
-            }
-        }
-        // if new path not found in collection, add it to collection
-        if (!exists) {
-            addTrack(p);
+void TrackCollection::addTracks(const StringArray &newPaths) {
+    // grow the index once for the whole batch
+    paths.reserve(paths.size() + newPaths.size());
+
+    // iterate through all paths in the provided argument, duplicates are
+    // skipped by looking them up in the path index
+    std::vector<LibraryDatabase::Entry> added;
+    StringArray addedPaths;
+    for (auto p : newPaths) {
+        auto track = createTrack(p);
+        if (track == nullptr) {
+            continue;
         }
+        probeMetadata(track);
+
+        LibraryDatabase::Entry entry;
+        entry.path = p;
+        added.push_back(entry);
+        addedPaths.add(p);
+    }
+    if (!addedPaths.isEmpty()) {
+        updateSearchNames();
+    }
+    // append the batch to the database straight away, metadata is saved once probed
+    if (!added.empty() && !database.append(added)) {
+        changed.store(true);
+    }
+    // let others prepare for the new tracks, e.g. build their waveforms
+    if (!addedPaths.isEmpty() && onTracksAdded) {
+        onTracksAdded(addedPaths);
     }
     DBG(tracks.size());
 }
@@ -146,31 +203,156 @@ void TrackCollection::removeTrack(int i) {
     if (tracksSearched) {
         return;
     }
+    if (tracks[i] == nullptr) {
+        return;
+    }
+    // keep the path index in sync
+    paths.erase(tracks[i]->getFullPath());
     tracks.remove(i);
+    updateSearchNames();
+    changed.store(true);
 }
 
 /******************************************
 * Name:
 *  selectTracks
 * Description:
-*  perform search against all tracks in collection using
-*  isMatch of each track, on match, add track id to selectedTracks.
+*  perform search against the search index of all tracks in
+*  collection, add matching track ids to selectedTracks. If the
+*  keyword contains the previous keyword, only the previously
+*  selected tracks are searched.
 * Parameters:
 * keyword: keyword used to select tracks
 * Output:
 *  no. of selected tracks
 *******************************************/
 int TrackCollection::selectTracks(String keyword) {
+    // cancel any search running in the background
+    ++searchGeneration;
+
+    auto index = getSearchIndex();
+    keyword = keyword.toLowerCase();
+
+    // a track can only match the new keyword if it matched the one it contains,
+    // as long as the tracks have not changed since
+    if (tracksSearched && index == selectedIndex && keyword.contains(selectedKeyword)) {
+        selectedTracks = index->narrow(keyword, selectedTracks);
+    }
+    else {
+        selectedTracks = index->search(keyword);
+    }
     tracksSearched = true;
-    selectedTracks.clear();
-    // iterate over all tracks in collection
-    for (auto i = 0; i < tracks.size(); ++i) {
-        // if match keyword, add to selected tracks
-        if (tracks[i]->isMatch(keyword)) {
-            selectedTracks.push_back(i);
+    selectedKeyword = keyword;
+    selectedIndex = index;
+    return selectedTracks.size();
+}
+
+/******************************************
+* Name:
+*  getSearchIndex
+* Description:
+*  getter for the search index of the track filenames.
+*  The index is rebuilt on the calling thread if tracks
+*  were added or removed since it was last built.
+* Parameters:
+*  N/A
+* Output:
+*  index of the filenames of all tracks, by track id
+*******************************************/
+std::shared_ptr<const SearchIndex> TrackCollection::getSearchIndex() {
+    if (indexedNames != searchNames) {
+        searchIndex = std::make_shared<const SearchIndex>(*searchNames);
+        indexedNames = searchNames;
+    }
+    return searchIndex;
+}
+
+/******************************************
+* Name:
+*  selectTracksAsync
+* Description:
+*  perform search like selectTracks, but on a background
+*  worker, which also builds the search index if it is outdated.
+*  Starting a new search cancels any search still in progress,
+*  and only the result of the latest search is passed to the
+*  callback, on the message thread.
+* Parameters:
+*  keyword: keyword used to select tracks
+*  onSearched: called on the message thread with the result
+* Output:
+*  N/A
+*******************************************/
+void TrackCollection::selectTracksAsync(String keyword,
+    std::function<void(std::shared_ptr<SearchResult>)> onSearched) {
+    auto result = std::make_shared<SearchResult>();
+    result->generation = ++searchGeneration;
+    result->keyword = keyword.toLowerCase();
+    result->names = searchNames;
+
+    // reuse the index if the tracks have not changed, otherwise the job builds it
+    if (indexedNames == searchNames) {
+        result->index = searchIndex;
+    }
+
+    // only the selected tracks need searching if the keyword extends the selection's
+    auto narrow = tracksSearched && result->index != nullptr && result->index == selectedIndex &&
+        result->keyword.contains(selectedKeyword);
+    if (narrow) {
+        result->tracks = selectedTracks;
+    }
+
+    // searches not started yet are stale now
+    searchPool.removeAllJobs(false, 0);
+    searchPool.addJob([this, result, narrow, onSearched] {
+        // skip if a newer search was started meanwhile
+        if (result->generation != searchGeneration.load()) {
+            return;
         }
+        if (result->index == nullptr) {
+            result->index = std::make_shared<const SearchIndex>(*result->names);
+        }
+        result->tracks = narrow ? result->index->narrow(result->keyword, result->tracks)
+            : result->index->search(result->keyword);
+        if (result->generation != searchGeneration.load()) {
+            return;
+        }
+
+        // hand over to the playlist on the message thread
+        MessageManager::callAsync([result, onSearched] { onSearched(result); });
+    });
+}
+
+/******************************************
+* Name:
+*  setSelectedTracks
+* Description:
+*  select the tracks found by selectTracksAsync, keeping the
+*  index the search built for the next one. Results of
+*  searches that have been replaced by a newer one are ignored.
+* Parameters:
+*  result: result of the search
+* Output:
+*  false if tracks were added or removed while searching,
+*  so the search needs to be repeated
+*******************************************/
+bool TrackCollection::setSelectedTracks(const SearchResult& result) {
+    // a newer search was started, or the search was cleared
+    if (result.generation != searchGeneration.load()) {
+        return true;
     }
-    return selectedTracks.size();
+    // track ids are outdated
+    if (result.names != searchNames) {
+        return false;
+    }
+    // keep the index for the next search
+    searchIndex = result.index;
+    indexedNames = result.names;
+
+    tracksSearched = true;
+    selectedTracks = result.tracks;
+    selectedKeyword = result.keyword;
+    selectedIndex = result.index;
+    return true;
 }
 
 /******************************************
@@ -184,32 +366,96 @@ int TrackCollection::selectTracks(String keyword) {
 *  N/A
 *******************************************/
 void TrackCollection::clearSelectedTracks() {
+    // cancel any search running in the background
+    ++searchGeneration;
+
     tracksSearched = false;
     selectedTracks.clear();
+    selectedKeyword.clear();
+    selectedIndex.reset();
 }
 
 /******************************************
 * Name:
 *  load
 * Description:
-*  Read config through ConfigManager and extract
-*  all tracks saved to restore the track list
+*  Memory map the library database and restore the
+*  track list from it. If there is no database yet, the
+*  track list is imported from the JSON config instead and
+*  written to the database. A database that exists but
+*  cannot be read is renamed to a backup before that, and
+*  the user is warned. Cached metadata is used straight
+*  away, and only files whose size or modification time
+*  changed are probed again. The loaded tracks are passed
+*  to onTracksAdded.
 * Parameters:
 *  N/A
 * Output:
 *  N/A
 *******************************************/
 void TrackCollection::load() {
-    // read from config file
-    var config = ConfigManager::load();
-    if (config.isBool() && (bool)config == false) {
-        return;
+    // read from database, or import from config file if there is none
+    std::vector<LibraryDatabase::Entry> entries;
+    auto imported = false;
+    if (!database.read(entries)) {
+        entries.clear();
+        // the config is older than any database, so a damaged one is kept aside
+        // rather than overwritten, and nothing is written if that fails
+        if (!database.isMissing()) {
+            auto backupFile = database.backup();
+            if (backupFile == File()) {
+                DBG("TrackCollection::load: unable to read or back up library database");
+                AlertWindow::showMessageBoxAsync(MessageBoxIconType::WarningIcon,
+                    "Error",
+                    "The library database could not be read, and could not be renamed to keep it. The track list was not loaded.",
+                    "OK");
+                return;
+            }
+            DBG("TrackCollection::load: unable to read library database, kept as " << backupFile.getFullPathName());
+            AlertWindow::showMessageBoxAsync(MessageBoxIconType::WarningIcon,
+                "Error",
+                "The library database could not be read and was kept as " + backupFile.getFullPathName() +
+                ". The track list was restored from the older config file instead.",
+                "OK");
+        }
+        if (!importJSON(entries)) {
+            return;
+        }
+        imported = true;
     }
-    // extract relevant property
-    auto trackList = config.getProperty("tracks", var()).getArray();
-    // iterate over all tracks read from config, add to collection
-    for (auto track : *trackList) {
-        addTrack(track["path"]);
+    // iterate over all tracks read, add to collection
+    std::vector<std::pair<std::shared_ptr<TrackMetadata>, String>> cached;
+    StringArray loadedPaths;
+    for (auto& entry : entries) {
+        auto track = createTrack(entry.path);
+        if (track == nullptr) {
+            continue;
+        }
+        loadedPaths.add(entry.path);
+        // use cached metadata if present, otherwise probe
+        if (entry.probed) {
+            auto metadata = track->getMetadata();
+            metadata->fileSize.store(entry.fileSize);
+            metadata->modificationTime.store(entry.modificationTime);
+            track->setMetadata(entry.duration, entry.sampleRate, entry.numChannels);
+            cached.push_back({ metadata, entry.path });
+        }
+        else {
+            probeMetadata(track);
+        }
+    }
+    updateSearchNames();
+
+    // write imported tracks to the database, so tracks added from now on can be appended
+    if (imported && !database.write(createEntries())) {
+        changed.store(true);
+    }
+    // check in the background if any cached files have changed
+    validateMetadata(cached);
+
+    // let others prepare for the loaded tracks, e.g. build their waveforms
+    if (!loadedPaths.isEmpty() && onTracksAdded) {
+        onTracksAdded(loadedPaths);
     }
 }
 
@@ -217,26 +463,268 @@ void TrackCollection::load() {
 * Name:
 *  save
 * Description:
-*  Parse all tracks in collection's full path
-*  into JSON format and pass to ConfigManager for
-*  saving to config file.
+*  Rewrite the library database with all tracks in the
+*  collection and their probed metadata, if anything changed
+*  since it was loaded. Falls back to the JSON config if the
+*  database cannot be written.
 * Parameters:
 *  N/A
 * Output:
 *  N/A
 *******************************************/
 void TrackCollection::save() {
+    // tracks added since loading are already appended
+    if (!changed.load()) {
+        return;
+    }
+    if (!database.write(createEntries())) {
+        DBG("TrackCollection::save: unable to write library database, saving config instead");
+        exportJSON();
+    }
+}
+
+/******************************************
+* Name:
+*  exportJSON
+* Description:
+*  Parse all tracks in collection's full path and
+*  probed metadata into JSON format and pass to
+*  ConfigManager for saving to config file.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void TrackCollection::exportJSON() {
     var TrackList;
     Array<var> trackList;
     var config(new DynamicObject());
     // iterate over all tracks in collection and add to JSON object in correct format
-    for (auto i = 0; i < tracks.size(); ++i) {
+    for (auto& entry : createEntries()) {
         var curr(new DynamicObject());
-        curr.getDynamicObject()->setProperty("path", tracks[i]->getFullPath());
+        curr.getDynamicObject()->setProperty("path", entry.path);
+        // cache probed metadata, keyed by the file's size and modification time
+        if (entry.probed) {
+            curr.getDynamicObject()->setProperty("size", entry.fileSize);
+            curr.getDynamicObject()->setProperty("modified", entry.modificationTime);
+            curr.getDynamicObject()->setProperty("duration", entry.duration);
+            curr.getDynamicObject()->setProperty("sampleRate", entry.sampleRate);
+            curr.getDynamicObject()->setProperty("channels", entry.numChannels);
+        }
         trackList.add(curr);
     }
     // save to JSON object
     config.getDynamicObject()->setProperty("tracks", trackList);
     // write to file using ConfigManager
     ConfigManager::save(config);
+}
+
+/******************************************
+* Name:
+*  probeMetadata
+* Description:
+*  queue a track's metadata to be probed by the background
+*  worker pool. A change message is sent when done, so the
+*  playlist can fill in the placeholders.
+* Parameters:
+*  track: track to probe
+* Output:
+*  N/A
+*******************************************/
+void TrackCollection::probeMetadata(Track* track) {
+    // the job only holds the shared metadata, so the track can be removed meanwhile
+    auto metadata = track->getMetadata();
+    auto path = track->getFullPath();
+
+    probePool.addJob([this, metadata, path] {
+        probe(*metadata, path);
+
+        // notify listeners (playlist) on the message thread
+        sendChangeMessage();
+    });
+}
+
+/******************************************
+* Name:
+*  createTrack
+* Description:
+*  Check if the path provided is not in the collection
+*  yet, and if its file extension is processable by the
+*  format manager, if so, add track to the collection and
+*  the path index without probing it.
+* Parameters:
+*  path: full path of track to add.
+* Output:
+*  the added track, nullptr if not added
+*******************************************/
+Track* TrackCollection::createTrack(const String& path) {
+    if (paths.count(path) > 0 || !isKnownFormat(File(path).getFileExtension())) {
+        return nullptr;
+    }
+    paths.insert(path);
+    return tracks.add(new Track(path));
+}
+
+/******************************************
+* Name:
+*  updateSearchNames
+* Description:
+*  Publish the filenames of all tracks, by track id, for
+*  searches to build their index from in the background.
+*  Called once a batch of tracks was added or removed.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void TrackCollection::updateSearchNames() {
+    auto names = std::make_shared<StringArray>();
+    names->ensureStorageAllocated(tracks.size());
+    for (auto i = 0; i < tracks.size(); ++i) {
+        names->add(tracks[i]->getFileName());
+    }
+    searchNames = names;
+}
+
+/******************************************
+* Name:
+*  importJSON
+* Description:
+*  Read config through ConfigManager and extract
+*  all tracks saved in it.
+* Parameters:
+*  entries: vector the tracks read are added to
+* Output:
+*  true if the config was read
+*******************************************/
+bool TrackCollection::importJSON(std::vector<LibraryDatabase::Entry>& entries) {
+    // read from config file
+    var config = ConfigManager::load();
+    if (config.isBool() && (bool)config == false) {
+        return false;
+    }
+    // extract relevant property
+    auto trackList = config.getProperty("tracks", var()).getArray();
+    if (trackList == nullptr) {
+        return false;
+    }
+    // iterate over all tracks read from config
+    for (auto curr : *trackList) {
+        LibraryDatabase::Entry entry;
+        entry.path = curr["path"];
+        // cached metadata, if present
+        if (curr.hasProperty("duration")) {
+            entry.fileSize = (int64)curr["size"];
+            entry.modificationTime = (int64)curr["modified"];
+            entry.duration = curr["duration"];
+            entry.sampleRate = curr["sampleRate"];
+            entry.numChannels = curr["channels"];
+            entry.probed = true;
+        }
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+/******************************************
+* Name:
+*  createEntries
+* Description:
+*  create a database entry for each track in the collection.
+* Parameters:
+*  N/A
+* Output:
+*  entries of all tracks, in collection order
+*******************************************/
+std::vector<LibraryDatabase::Entry> TrackCollection::createEntries() {
+    std::vector<LibraryDatabase::Entry> entries;
+    entries.reserve(tracks.size());
+    for (auto i = 0; i < tracks.size(); ++i) {
+        LibraryDatabase::Entry entry;
+        entry.path = tracks[i]->getFullPath();
+        if (tracks[i]->isProbed()) {
+            auto metadata = tracks[i]->getMetadata();
+            entry.fileSize = metadata->fileSize.load();
+            entry.modificationTime = metadata->modificationTime.load();
+            entry.duration = metadata->duration.load();
+            entry.sampleRate = metadata->sampleRate.load();
+            entry.numChannels = metadata->numChannels.load();
+            entry.probed = true;
+        }
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+/******************************************
+* Name:
+*  probe
+* Description:
+*  read the size and modification time of a file and
+*  probe its metadata with a reader. Called from the
+*  background worker pool.
+* Parameters:
+*  metadata: metadata to fill in
+*  path: full path of the file
+* Output:
+*  N/A
+*******************************************/
+void TrackCollection::probe(TrackMetadata& metadata, const String& path) {
+    // remember file stat, so unchanged files are not probed again next time
+    File file(path);
+    metadata.fileSize.store(file.getSize());
+    metadata.modificationTime.store(file.getLastModificationTime().toMilliseconds());
+
+    // generate a reader to obtain total track duration and format
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader != nullptr) {
+        metadata.duration.store(reader->lengthInSamples / reader->sampleRate);
+        metadata.sampleRate.store(reader->sampleRate);
+        metadata.numChannels.store((int)reader->numChannels);
+    }
+    else {
+        DBG("TrackCollection::probe: unable to open " << path);
+    }
+    metadata.probed.store(true);
+
+    // probed metadata is saved to the database on save
+    changed.store(true);
+}
+
+/******************************************
+* Name:
+*  validateMetadata
+* Description:
+*  queue cached metadata to be checked against the files in
+*  the background, in batches. Files whose size or modification
+*  time changed are probed again.
+* Parameters:
+*  cached: metadata and full path of each track loaded from cache
+* Output:
+*  N/A
+*******************************************/
+void TrackCollection::validateMetadata(
+    const std::vector<std::pair<std::shared_ptr<TrackMetadata>, String>>& cached) {
+    for (size_t start = 0; start < cached.size(); start += SIZE_VALIDATE_BATCH) {
+        auto end = jmin(cached.size(), start + SIZE_VALIDATE_BATCH);
+        std::vector<std::pair<std::shared_ptr<TrackMetadata>, String>> batch(
+            cached.begin() + start, cached.begin() + end);
+
+        probePool.addJob([this, batch] {
+            auto changed = false;
+            for (auto& entry : batch) {
+                // only probe again if the file's stat no longer matches the cache
+                File file(entry.second);
+                if (file.getSize() != entry.first->fileSize.load() ||
+                    file.getLastModificationTime().toMilliseconds() != entry.first->modificationTime.load()) {
+                    probe(*entry.first, entry.second);
+                    changed = true;
+                }
+            }
+            // notify listeners (playlist) on the message thread
+            if (changed) {
+                sendChangeMessage();
+            }
+        });
+    }
 }
\ No newline at end of file
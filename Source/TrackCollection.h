@@ -14,9 +14,20 @@ using namespace juce;
 
 #include "Track.h"
 #include "PlayerPool.h"
+#include "LibraryDatabase.h"
+#include "SearchIndex.h"
 
-class TrackCollection {
+class TrackCollection: public ChangeBroadcaster {
 public:
+    // result of a search run in the background
+    struct SearchResult {
+        uint32 generation;  // no. of the search, only the latest one is used
+        String keyword;     // lowercase keyword searched for
+        std::shared_ptr<const StringArray> names;   // filenames of all tracks when the search started
+        std::shared_ptr<const SearchIndex> index;   // index searched in, built by the search if outdated
+        std::vector<int> tracks;    // ids of the matching tracks
+    };
+
     // constructors & destructors
     /******************************************
     * Name:
@@ -31,6 +42,20 @@ public:
     *******************************************/
     TrackCollection(AudioFormatManager& formatManager);
 
+    /******************************************
+    * Name:
+    *  ~TrackCollection
+    * Description:
+    *  destructor for the TrackCollection class. Drops
+    *  queued metadata probes and searches and waits for
+    *  running ones.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    ~TrackCollection();
+
     // getters & setters
     /******************************************
     * Name:
@@ -61,6 +86,20 @@ public:
     *******************************************/
     bool isKnownFormat(String format);
 
+    /******************************************
+    * Name:
+    *  getKnownFormats
+    * Description:
+    *  Returns a snapshot of the file extensions the
+    *  AudioManager is able to process, which can be used
+    *  from other threads.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  set of processable file extensions
+    *******************************************/
+    std::unordered_set<String> getKnownFormats();
+
     /******************************************
     * Name:
     *  size
@@ -81,7 +120,8 @@ public:
     * Description:
     *  Check if the file extension of the path provided
     *  is processable by the format manager, if so, add
-    *  track to the collection
+    *  track to the collection and queue its metadata to
+    *  be probed in the background
     * Parameters:
     *  path: full path of track to add.
     * Output:
@@ -93,15 +133,16 @@ public:
     * Name:
     *  addTracks
     * Description:
-    *  Adds an array of paths of tracks.
-    *  First check, if the given track exist in the collection,
-    *  If not, add the track to the collection
+    *  Adds an array of paths of tracks. Paths already
+    *  in the collection are skipped. The added tracks are
+    *  appended to the database together, queued to be
+    *  probed in the background and passed to onTracksAdded.
     * Parameters:
-    *  path: array of full path of tracks to add
+    *  newPaths: array of full path of tracks to add
     * Output:
     *  N/A
     *******************************************/
-    void addTracks(const StringArray& paths);
+    void addTracks(const StringArray& newPaths);
 
     /******************************************
     * Name:
@@ -120,8 +161,10 @@ public:
     * Name:
     *  selectTracks
     * Description:
-    *  perform search against all tracks in collection using
-    *  isMatch of each track, on match, add track id to selectedTracks.
+    *  perform search against the search index of all tracks in
+    *  collection, add matching track ids to selectedTracks. If the
+    *  keyword contains the previous keyword, only the previously 
+    *  selected tracks are searched.
     * Parameters:
     * keyword: keyword used to select tracks
     * Output:
@@ -129,6 +172,52 @@ public:
     *******************************************/
     int selectTracks(String keyword);
 
+    /******************************************
+    * Name:
+    *  getSearchIndex
+    * Description:
+    *  getter for the search index of the track filenames.
+    *  The index is rebuilt on the calling thread if tracks
+    *  were added or removed since it was last built.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  index of the filenames of all tracks, by track id
+    *******************************************/
+    std::shared_ptr<const SearchIndex> getSearchIndex();
+
+    /******************************************
+    * Name:
+    *  selectTracksAsync
+    * Description:
+    *  perform search like selectTracks, but on a background
+    *  worker, which also builds the search index if it is outdated.
+    *  Starting a new search cancels any search still in progress,
+    *  and only the result of the latest search is passed to the
+    *  callback, on the message thread.
+    * Parameters:
+    *  keyword: keyword used to select tracks
+    *  onSearched: called on the message thread with the result
+    * Output:
+    *  N/A
+    *******************************************/
+    void selectTracksAsync(String keyword, std::function<void(std::shared_ptr<SearchResult>)> onSearched);
+
+    /******************************************
+    * Name:
+    *  setSelectedTracks
+    * Description:
+    *  select the tracks found by selectTracksAsync, keeping the
+    *  index the search built for the next one. Results of
+    *  searches that have been replaced by a newer one are ignored.
+    * Parameters:
+    *  result: result of the search
+    * Output:
+    *  false if tracks were added or removed while searching,
+    *  so the search needs to be repeated
+    *******************************************/
+    bool setSelectedTracks(const SearchResult& result);
+
     /******************************************
     * Name:
     *  clearSelectedTracks 
@@ -145,8 +234,15 @@ public:
     * Name:
     *  load
     * Description:
-    *  Read config through ConfigManager and extract
-    *  all tracks saved to restore the track list
+    *  Memory map the library database and restore the
+    *  track list from it. If there is no database yet, the
+    *  track list is imported from the JSON config instead and
+    *  written to the database. A database that exists but
+    *  cannot be read is renamed to a backup before that, and
+    *  the user is warned. Cached metadata is used straight
+    *  away, and only files whose size or modification time 
+    *  changed are probed again. The loaded tracks are passed
+    *  to onTracksAdded.
     * Parameters:
     *  N/A
     * Output:
@@ -158,9 +254,10 @@ public:
     * Name:
     *  save
     * Description:    
-    *  Parse all tracks in collection's full path
-    *  into JSON format and pass to ConfigManager for
-    *  saving to config file.
+    *  Rewrite the library database with all tracks in the
+    *  collection and their probed metadata, if anything changed
+    *  since it was loaded. Falls back to the JSON config if the
+    *  database cannot be written.
     * Parameters:
     *  N/A
     * Output:
@@ -168,10 +265,140 @@ public:
     *******************************************/
     void save();
 
+    /******************************************
+    * Name:
+    *  exportJSON
+    * Description:    
+    *  Parse all tracks in collection's full path and
+    *  probed metadata into JSON format and pass to 
+    *  ConfigManager for saving to config file.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void exportJSON();
+
+    /******************************************
+    * Name:
+    *  probeMetadata
+    * Description:
+    *  queue a track's metadata to be probed by the background
+    *  worker pool. A change message is sent when done, so the
+    *  playlist can fill in the placeholders.
+    * Parameters:
+    *  track: track to probe
+    * Output:
+    *  N/A
+    *******************************************/
+    void probeMetadata(Track* track);
+
+    // public members
+    std::function<void(const StringArray&)> onTracksAdded;  // called with the full paths of tracks
+                                                            // loaded or added to the collection
+
+    // public constants
+    static const int SIZE_VALIDATE_BATCH = 256; // no. of cached tracks checked per background job
+
 private:
+    // methods
+    /******************************************
+    * Name:
+    *  createTrack
+    * Description:
+    *  Check if the path provided is not in the collection
+    *  yet, and if its file extension is processable by the
+    *  format manager, if so, add track to the collection and
+    *  the path index without probing it.
+    * Parameters:
+    *  path: full path of track to add.
+    * Output:
+    *  the added track, nullptr if not added
+    *******************************************/
+    Track* createTrack(const String& path);
+
+    /******************************************
+    * Name:
+    *  updateSearchNames
+    * Description:
+    *  Publish the filenames of all tracks, by track id, for
+    *  searches to build their index from in the background.
+    *  Called once a batch of tracks was added or removed.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void updateSearchNames();
+
+    /******************************************
+    * Name:
+    *  importJSON
+    * Description:
+    *  Read config through ConfigManager and extract
+    *  all tracks saved in it.
+    * Parameters:
+    *  entries: vector the tracks read are added to
+    * Output:
+    *  true if the config was read
+    *******************************************/
+    bool importJSON(std::vector<LibraryDatabase::Entry>& entries);
+
+    /******************************************
+    * Name:
+    *  createEntries
+    * Description:
+    *  create a database entry for each track in the collection.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  entries of all tracks, in collection order
+    *******************************************/
+    std::vector<LibraryDatabase::Entry> createEntries();
+
+    /******************************************
+    * Name:
+    *  probe
+    * Description:
+    *  read the size and modification time of a file and
+    *  probe its metadata with a reader. Called from the
+    *  background worker pool.
+    * Parameters:
+    *  metadata: metadata to fill in
+    *  path: full path of the file
+    * Output:
+    *  N/A
+    *******************************************/
+    void probe(TrackMetadata& metadata, const String& path);
+
+    /******************************************
+    * Name:
+    *  validateMetadata
+    * Description:
+    *  queue cached metadata to be checked against the files in
+    *  the background, in batches. Files whose size or modification 
+    *  time changed are probed again.
+    * Parameters:
+    *  cached: metadata and full path of each track loaded from cache
+    * Output:
+    *  N/A
+    *******************************************/
+    void validateMetadata(const std::vector<std::pair<std::shared_ptr<TrackMetadata>, String>>& cached);
+
     // functionality members
     bool tracksSearched;        // flag indicating if a search is performed
     AudioFormatManager& formatManager;  // reference to global AudioFormatManager
     OwnedArray<Track> tracks; // pointer array of all tracks in the collection
+    std::unordered_set<String> paths;   // index of the full paths of all tracks in the collection
     std::vector<int> selectedTracks;    // vector of selected (matching search condition) track ids
+    String selectedKeyword;     // lowercase keyword the selected tracks match
+    std::shared_ptr<const StringArray> searchNames;     // filenames of all tracks by id, replaced when tracks change
+    std::shared_ptr<const StringArray> indexedNames;    // filenames the search index was built from
+    std::shared_ptr<const SearchIndex> searchIndex;     // latest index built, outdated unless built from searchNames
+    std::shared_ptr<const SearchIndex> selectedIndex;   // index the selected tracks were searched in
+    std::atomic<uint32> searchGeneration{ 0 };  // no. of the latest search started
+    ThreadPool searchPool{ 1 }; // single thread pool running searches
+    ThreadPool probePool{ jmax(1, SystemStats::getNumCpus() - 1) };  // worker pool probing metadata
+    LibraryDatabase database;   // binary library database the track list is saved to
+    std::atomic<bool> changed{ false }; // if the database needs rewriting on save
 };
\ No newline at end of file
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    TrackLoader.cpp
+    Created: 17 Oct 2026 10:31:27pm
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#include "TrackLoader.h"
+
+/******************************************
+* Name:
+*  TrackLoader
+* Description:
+*  constructor of the TrackLoader class. Starts the background
+*  thread that works through the load queue.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+TrackLoader::TrackLoader() {}
+
+/******************************************
+* Name:
+*  ~TrackLoader
+* Description:
+*  destructor of the TrackLoader class. Drops queued loads and
+*  cancels the one in progress, waiting for it to finish.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+TrackLoader::~TrackLoader() {
+    // a cancelled load returns quickly, but never give up before priming would time out
+    pool.removeAllJobs(true, TIMEOUT_EXIT);
+}
+
+/******************************************
+* Name:
+*  loadAsync
+* Description:
+*  queues a track to be loaded for a player. On the background
+*  thread the file is opened and the first part of the audio is
+*  decoded into the player's read-ahead buffer. The result is then
+*  passed to the callback on the message thread, unless the load
+*  was cancelled by destroying the TrackLoader.
+* Parameters:
+*  player: player the track is loaded for
+*  fullPath: full path of the track
+*  onLoaded: called on the message thread when the load is done
+* Output:
+*  N/A
+*******************************************/
+void TrackLoader::loadAsync(DJAudioPlayer* player, const String& fullPath,
+    std::function<void(std::shared_ptr<LoadedTrack>)> onLoaded) {
+    pool.addJob([this, player, fullPath, onLoaded] {
+        auto loaded = std::make_shared<LoadedTrack>();
+        auto* job = ThreadPoolJob::getCurrentThreadPoolJob();   // set to exit when the TrackLoader is destroyed
+
+        // open the file and decode the first part of it
+        loaded->source = player->createSource(URL{ File{fullPath} });
+        if (loaded->source != nullptr) {
+            auto numSamples = (int)(PRIME_SECONDS * loaded->source->getSampleRate());
+            loaded->source->prime(numSamples, [job] { return job != nullptr && job->shouldExit(); });
+        }
+
+        // dropped when cancelled, the decks may already be gone
+        if (job != nullptr && job->shouldExit()) {
+            return;
+        }
+
+        // hand over to the deck on the message thread
+        MessageManager::callAsync([loaded, onLoaded] { onLoaded(loaded); });
+    });
+}
+
+const double TrackLoader::PRIME_SECONDS = 1.0;
\ No newline at end of file
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    TrackLoader.h
+    Created: 17 Oct 2026 10:31:27pm
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+using namespace juce;
+
+#include "DJAudioPlayer.h"
+#include "ReadAheadAudioSource.h"
+
+class TrackLoader {
+public:
+    // result of a load, handed to the deck on the message thread
+    struct LoadedTrack {
+        std::unique_ptr<ReadAheadAudioSource> source;   // primed source for the player,
+                                                        // nullptr if the file could not be opened
+    };
+
+    // constructors & destructors
+    /******************************************
+    * Name:
+    *  TrackLoader
+    * Description:
+    *  constructor of the TrackLoader class. Starts the background
+    *  thread that works through the load queue.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    TrackLoader();
+
+    /******************************************
+    * Name:
+    *  ~TrackLoader
+    * Description:
+    *  destructor of the TrackLoader class. Drops queued loads and
+    *  cancels the one in progress, waiting for it to finish.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    ~TrackLoader();
+
+    // methods
+    /******************************************
+    * Name:
+    *  loadAsync
+    * Description:
+    *  queues a track to be loaded for a player. On the background
+    *  thread the file is opened and the first part of the audio is
+    *  decoded into the player's read-ahead buffer. The result is then
+    *  passed to the callback on the message thread, unless the load
+    *  was cancelled by destroying the TrackLoader.
+    * Parameters:
+    *  player: player the track is loaded for
+    *  fullPath: full path of the track
+    *  onLoaded: called on the message thread when the load is done
+    * Output:
+    *  N/A
+    *******************************************/
+    void loadAsync(DJAudioPlayer* player, const String& fullPath,
+        std::function<void(std::shared_ptr<LoadedTrack>)> onLoaded);
+
+    // public constants
+    static const double PRIME_SECONDS;  // seconds of audio decoded before handing over
+    static const int TIMEOUT_EXIT = ReadAheadAudioSource::TIMEOUT_PRIME + 1000;  // max. time in ms to wait for a load on exit
+
+private:
+    // functionality members
+    ThreadPool pool{ 1 };   // single thread pool, works through loads in order
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackLoader)
+};
\ No newline at end of file
@@ -0,0 +1,519 @@
+/*
+  ==============================================================================
+
+    WaveformCache.cpp
+    Created: 18 Oct 2026 4:40:05am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#include "WaveformCache.h"
+
+/******************************************
+* Name:
+*  WaveformCache
+* Description:
+*  constructor of the WaveformCache class. Keeps the peaks of
+*  the most recently used tracks in memory and the peaks of all
+*  tracks seen in a folder on disk, so they are only built once.
+*  Peaks that are in neither are built on a background thread.
+* Parameters:
+*  formatManager: reference to global AudioFormatManager
+*  directory: folder to keep the peak files in
+*  maxTracks: max. no. of tracks to keep the peaks of in memory
+*  maxDiskSize: max. total size of the peak files, in bytes
+* Output:
+*  N/A
+*******************************************/
+WaveformCache::WaveformCache(AudioFormatManager& _formatManager, const File& _directory,
+    int _maxTracks, int64 _maxDiskSize) :
+    formatManager(_formatManager),
+    directory(_directory),
+    maxTracks(jmax(1, _maxTracks)),
+    maxDiskSize(jmax((int64)0, _maxDiskSize)) {}
+
+/******************************************
+* Name:
+*  ~WaveformCache
+* Description:
+*  destructor of the WaveformCache class. Drops queued builds
+*  and waits for the ones in progress to stop.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+WaveformCache::~WaveformCache() {
+    cancelled.store(true);
+    pregenerationPool.removeAllJobs(true, 2000);
+    pool.removeAllJobs(true, 2000);
+}
+
+/******************************************
+* Name:
+*  getPeaksAsync
+* Description:
+*  gets the peaks of a track from memory if they are there,
+*  otherwise reads them from disk or, if not on disk either,
+*  decodes the file on the background thread. A track requested
+*  again while it is being built is only decoded once. Must be
+*  called from the message thread.
+* Parameters:
+*  fullPath: full path of the track
+*  onReady: called on the message thread with the peaks, or
+*    nullptr if the file could not be read
+* Output:
+*  N/A
+*******************************************/
+void WaveformCache::getPeaksAsync(const String& fullPath,
+    std::function<void(std::shared_ptr<const WaveformPeaks>)> onReady) {
+    std::shared_ptr<const WaveformPeaks> peaks;
+    {
+        const ScopedLock sl(lock);
+        peaks = findInMemory(fullPath);
+
+        // not in memory, wait for the load in progress or start a new one
+        if (peaks == nullptr) {
+            auto it = pending.find(fullPath);
+            if (it != pending.end()) {
+                it->second.push_back(onReady);
+            }
+            else {
+                pending[fullPath].push_back(onReady);
+                pool.addJob([this, fullPath] { loadPeaks(fullPath, true); });
+            }
+            return;
+        }
+    }
+
+    // already in memory, hand over straight away
+    onReady(peaks);
+}
+
+/******************************************
+* Name:
+*  pregenerate
+* Description:
+*  queues tracks to have their peaks built and saved to disk
+*  ahead of being loaded, on a separate background thread so
+*  requests from the decks are not held up. Tracks already on
+*  disk are skipped. Pre-generated peaks never evict other peak
+*  files, so pre-generation stops once the size limit is reached.
+* Parameters:
+*  fullPaths: full paths of the tracks
+* Output:
+*  N/A
+*******************************************/
+void WaveformCache::pregenerate(const StringArray& fullPaths) {
+    for (auto& fullPath : fullPaths) {
+        pregenerationPool.addJob([this, fullPath] { pregeneratePeaks(fullPath); });
+    }
+}
+
+/******************************************
+* Name:
+*  loadPeaks
+* Description:
+*  called on a background thread. Reads the peaks of a track
+*  from disk, or decodes the track and saves its peaks to disk,
+*  then passes them to every callback waiting for them. The
+*  track must have an entry in pending.
+* Parameters:
+*  fullPath: full path of the track
+*  mayEvict: if older peak files may be removed to make room
+* Output:
+*  N/A
+*******************************************/
+void WaveformCache::loadPeaks(const String& fullPath, bool mayEvict) {
+    // read from disk, or decode the whole file; without holding the lock
+    File track(fullPath);
+    std::shared_ptr<const WaveformPeaks> peaks = readFromDisk(fullPath);
+    if (peaks == nullptr) {
+        std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(track));
+        if (reader != nullptr) {
+            auto built = WaveformPeaks::build(*reader, cancelled);
+            if (built != nullptr) {
+                writeToDisk(fullPath, track, *built, mayEvict);
+            }
+            peaks = built;
+        }
+    }
+    if (cancelled.load()) {
+        return;
+    }
+
+    // take the waiting callbacks, keeping the peaks in memory if anyone waited for them
+    std::vector<std::function<void(std::shared_ptr<const WaveformPeaks>)>> callbacks;
+    {
+        const ScopedLock sl(lock);
+        callbacks.swap(pending[fullPath]);
+        pending.erase(fullPath);
+        if (peaks != nullptr && !callbacks.empty()) {
+            addToMemory(fullPath, peaks);
+        }
+    }
+
+    // hand over on the message thread
+    if (!callbacks.empty()) {
+        MessageManager::callAsync([callbacks, peaks] {
+            for (auto& onReady : callbacks) {
+                onReady(peaks);
+            }
+        });
+    }
+}
+
+/******************************************
+* Name:
+*  pregeneratePeaks
+* Description:
+*  called on the pre-generation thread. Builds and saves the
+*  peaks of a track, unless they are on disk already, being
+*  loaded for a deck or would not fit within the size limit.
+* Parameters:
+*  fullPath: full path of the track
+* Output:
+*  N/A
+*******************************************/
+void WaveformCache::pregeneratePeaks(const String& fullPath) {
+    if (cancelled.load() || diskFull.load() || isOnDisk(fullPath)) {
+        return;
+    }
+
+    // stop pre-generating once the peaks would only fit by evicting others,
+    // checked from the length in the file header before decoding anything
+    {
+        std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(File(fullPath)));
+        if (reader == nullptr) {
+            return;
+        }
+        const ScopedLock sl(diskLock);
+        if (getDiskSize() + getPeakFileSize(fullPath, reader->lengthInSamples) > maxDiskSize) {
+            diskFull.store(true);
+            return;
+        }
+    }
+
+    // claim the track, a deck requesting it meanwhile waits for this build
+    {
+        const ScopedLock sl(lock);
+        if (pending.find(fullPath) != pending.end()) {
+            return;
+        }
+        pending[fullPath];
+    }
+    loadPeaks(fullPath, false);
+}
+
+/******************************************
+* Name:
+*  findInMemory
+* Description:
+*  looks up the peaks of a track in memory and marks them as
+*  the most recently used. The lock must be held.
+* Parameters:
+*  fullPath: full path of the track
+* Output:
+*  the peaks, nullptr if they are not in memory
+*******************************************/
+std::shared_ptr<const WaveformPeaks> WaveformCache::findInMemory(const String& fullPath) {
+    for (auto it = recent.begin(); it != recent.end(); ++it) {
+        if (it->first == fullPath) {
+            // move to the back, as the most recently used
+            auto entry = *it;
+            recent.erase(it);
+            recent.push_back(entry);
+            return entry.second;
+        }
+    }
+    return nullptr;
+}
+
+/******************************************
+* Name:
+*  addToMemory
+* Description:
+*  keeps the peaks of a track in memory as the most recently
+*  used, dropping the least recently used ones over the limit.
+*  The lock must be held.
+* Parameters:
+*  fullPath: full path of the track
+*  peaks: peaks of the track
+* Output:
+*  N/A
+*******************************************/
+void WaveformCache::addToMemory(const String& fullPath, std::shared_ptr<const WaveformPeaks> peaks) {
+    // replace any older peaks of the same track
+    recent.erase(std::remove_if(recent.begin(), recent.end(),
+        [&fullPath](const std::pair<String, std::shared_ptr<const WaveformPeaks>>& entry) {
+            return entry.first == fullPath;
+        }), recent.end());
+    recent.emplace_back(fullPath, peaks);
+
+    // drop the least recently used
+    while ((int)recent.size() > maxTracks) {
+        recent.erase(recent.begin());
+    }
+}
+
+/******************************************
+* Name:
+*  getPeakFile
+* Description:
+*  getter for the peak file of a track. Named after a hash of
+*  the path, so a changed track overwrites its old peaks.
+* Parameters:
+*  fullPath: full path of the track
+* Output:
+*  the peak file, which may not exist
+*******************************************/
+File WaveformCache::getPeakFile(const String& fullPath) {
+    return directory.getChildFile(String::toHexString(fullPath.hashCode64()) + EXTENSION);
+}
+
+/******************************************
+* Name:
+*  getPeakFileSize
+* Description:
+*  getter for the size the peak file of a track will have.
+* Parameters:
+*  fullPath: full path of the track
+*  lengthInSamples: length of the track in samples
+* Output:
+*  size of the peak file, in bytes
+*******************************************/
+int64 WaveformCache::getPeakFileSize(const String& fullPath, int64 lengthInSamples) {
+    auto numPeaks = (lengthInSamples + WaveformPeaks::SAMPLES_PER_PEAK - 1) /
+        WaveformPeaks::SAMPLES_PER_PEAK;
+    return (int64)sizeof(FileHeader) + (int64)fullPath.getNumBytesAsUTF8() +
+        numPeaks * (int64)sizeof(WaveformPeaks::Peak);
+}
+
+/******************************************
+* Name:
+*  getDiskSize
+* Description:
+*  getter for the total size of the peak files. The folder is
+*  only scanned the first time, after that the size is kept up
+*  to date by writeToDisk and trimDisk. The disk lock must be
+*  held.
+* Parameters:
+*  N/A
+* Output:
+*  total size of the peak files, in bytes
+*******************************************/
+int64 WaveformCache::getDiskSize() {
+    if (diskSize < 0) {
+        diskSize = 0;
+        for (auto& file : directory.findChildFiles(File::findFiles, false, "*" + EXTENSION)) {
+            diskSize += file.getSize();
+        }
+    }
+    return diskSize;
+}
+
+/******************************************
+* Name:
+*  readHeader
+* Description:
+*  reads the header and path of a peak file and checks that
+*  they belong to the track as it is now.
+* Parameters:
+*  stream: stream of the peak file
+*  fullPath: full path of the track
+*  track: the track file
+*  header: header to fill in
+* Output:
+*  true if the peak file is valid for the track
+*******************************************/
+bool WaveformCache::readHeader(InputStream& stream, const String& fullPath, const File& track,
+    FileHeader& header) {
+    if (stream.read(&header, (int)sizeof(FileHeader)) != (int)sizeof(FileHeader)) {
+        return false;
+    }
+
+    // the track must not have changed since the peaks were built
+    if (header.magic != MAGIC || header.version != VERSION ||
+        header.fileSize != track.getSize() ||
+        header.modificationTime != track.getLastModificationTime().toMilliseconds() ||
+        header.pathLength > MAX_PATH_LENGTH) {
+        return false;
+    }
+
+    // the path must match, in case two paths have the same hash
+    MemoryBlock path;
+    if (stream.readIntoMemoryBlock(path, (ssize_t)header.pathLength) != (size_t)header.pathLength ||
+        String::fromUTF8((const char*)path.getData(), (int)path.getSize()) != fullPath) {
+        return false;
+    }
+
+    // the no. of peaks must match the length of the track and the rest of the file
+    auto numPeaks = (header.lengthInSamples + WaveformPeaks::SAMPLES_PER_PEAK - 1) /
+        WaveformPeaks::SAMPLES_PER_PEAK;
+    return header.lengthInSamples > 0 && header.sampleRate > 0 &&
+        (int64)header.numPeaks == numPeaks &&
+        stream.getNumBytesRemaining() == (int64)header.numPeaks * (int64)sizeof(WaveformPeaks::Peak);
+}
+
+/******************************************
+* Name:
+*  isOnDisk
+* Description:
+*  checks if valid peaks of a track are on disk, without
+*  reading them.
+* Parameters:
+*  fullPath: full path of the track
+* Output:
+*  true if the peaks are on disk
+*******************************************/
+bool WaveformCache::isOnDisk(const String& fullPath) {
+    FileInputStream stream(getPeakFile(fullPath));
+    FileHeader header;
+    return stream.openedOk() && readHeader(stream, fullPath, File(fullPath), header);
+}
+
+/******************************************
+* Name:
+*  readFromDisk
+* Description:
+*  reads the peaks of a track from disk and marks the peak
+*  file as the most recently used.
+* Parameters:
+*  fullPath: full path of the track
+* Output:
+*  the peaks, nullptr if not on disk or outdated
+*******************************************/
+std::shared_ptr<WaveformPeaks> WaveformCache::readFromDisk(const String& fullPath) {
+    auto file = getPeakFile(fullPath);
+    std::vector<WaveformPeaks::Peak> peaks;
+    FileHeader header;
+    {
+        FileInputStream stream(file);
+        if (!stream.openedOk() || !readHeader(stream, fullPath, File(fullPath), header)) {
+            return nullptr;
+        }
+        peaks.resize((size_t)header.numPeaks);
+        auto numBytes = (int)(peaks.size() * sizeof(WaveformPeaks::Peak));
+        if (stream.read(peaks.data(), numBytes) != numBytes) {
+            DBG("WaveformCache::readFromDisk: unable to read " << file.getFullPathName());
+            return nullptr;
+        }
+    }
+
+    // the modification time of the peak file is its last use, for trimming
+    file.setLastModificationTime(Time::getCurrentTime());
+    return std::make_shared<WaveformPeaks>(header.sampleRate, header.lengthInSamples,
+        std::move(peaks));
+}
+
+/******************************************
+* Name:
+*  writeToDisk
+* Description:
+*  saves the peaks of a track to disk, replacing any older
+*  peak file, then removes the least recently used peak files
+*  over the size limit. If no peak files may be removed, the
+*  peaks are not saved unless they fit within the limit.
+* Parameters:
+*  fullPath: full path of the track
+*  track: the track file, as it was when the peaks were built
+*  peaks: peaks of the track
+*  mayEvict: if older peak files may be removed to make room
+* Output:
+*  true if saved
+*******************************************/
+bool WaveformCache::writeToDisk(const String& fullPath, const File& track,
+    const WaveformPeaks& peaks, bool mayEvict) {
+    const auto& basePeaks = peaks.getBasePeaks();
+    auto path = fullPath.toUTF8();
+
+    FileHeader header;
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.fileSize = track.getSize();
+    header.modificationTime = track.getLastModificationTime().toMilliseconds();
+    header.lengthInSamples = peaks.getLengthInSamples();
+    header.sampleRate = peaks.getSampleRate();
+    header.pathLength = (uint32)path.sizeInBytes() - 1;
+    header.numPeaks = (uint32)basePeaks.size();
+
+    const ScopedLock sl(diskLock);
+    if (!directory.createDirectory()) {
+        DBG("WaveformCache::writeToDisk: unable to create " << directory.getFullPathName());
+        return false;
+    }
+
+    // the size after replacing any older peak file of the track
+    auto file = getPeakFile(fullPath);
+    auto newDiskSize = getDiskSize() - file.getSize() +
+        getPeakFileSize(fullPath, header.lengthInSamples);
+    if (!mayEvict && newDiskSize > maxDiskSize) {
+        diskFull.store(true);
+        return false;
+    }
+
+    // write to a temporary file first, so a peak file is never left half written
+    TemporaryFile temp(file);
+    {
+        FileOutputStream stream(temp.getFile());
+        if (stream.failedToOpen()) {
+            DBG("WaveformCache::writeToDisk: unable to create " << file.getFullPathName());
+            return false;
+        }
+        stream.write(&header, sizeof(FileHeader));
+        stream.write(path.getAddress(), header.pathLength);
+        stream.write(basePeaks.data(), basePeaks.size() * sizeof(WaveformPeaks::Peak));
+        stream.flush();
+        if (stream.getStatus().failed()) {
+            DBG("WaveformCache::writeToDisk: unable to write " << file.getFullPathName());
+            return false;
+        }
+    }
+    if (!temp.overwriteTargetFileWithTemporary()) {
+        return false;
+    }
+
+    diskSize = newDiskSize;
+    if (diskSize > maxDiskSize) {
+        trimDisk();
+    }
+    return true;
+}
+
+/******************************************
+* Name:
+*  trimDisk
+* Description:
+*  removes the least recently used peak files until their
+*  total size is within the limit. Scans the folder, so only
+*  called once the limit is exceeded. The disk lock must be held.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void WaveformCache::trimDisk() {
+    auto files = directory.findChildFiles(File::findFiles, false, "*" + EXTENSION);
+    auto totalSize = (int64)0;
+    for (auto& file : files) {
+        totalSize += file.getSize();
+    }
+
+    // least recently used first
+    std::sort(files.begin(), files.end(), [](const File& a, const File& b) {
+        return a.getLastModificationTime() < b.getLastModificationTime();
+    });
+    for (auto& file : files) {
+        if (totalSize <= maxDiskSize) {
+            break;
+        }
+        auto size = file.getSize();
+        if (file.deleteFile()) {
+            totalSize -= size;
+        }
+    }
+    diskSize = totalSize;
+}
+
+const String WaveformCache::EXTENSION = ".peaks";
\ No newline at end of file
@@ -0,0 +1,304 @@
+/*
+  ==============================================================================
+
+    WaveformCache.h
+    Created: 18 Oct 2026 4:40:05am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+using namespace juce;
+
+#include "WaveformPeaks.h"
+
+class WaveformCache {
+public:
+    // constructors & destructors
+    /******************************************
+    * Name:
+    *  WaveformCache
+    * Description:
+    *  constructor of the WaveformCache class. Keeps the peaks of
+    *  the most recently used tracks in memory and the peaks of all
+    *  tracks seen in a folder on disk, so they are only built once.
+    *  Peaks that are in neither are built on a background thread.
+    * Parameters:
+    *  formatManager: reference to global AudioFormatManager
+    *  directory: folder to keep the peak files in
+    *  maxTracks: max. no. of tracks to keep the peaks of in memory
+    *  maxDiskSize: max. total size of the peak files, in bytes
+    * Output:
+    *  N/A
+    *******************************************/
+    WaveformCache(AudioFormatManager& formatManager, const File& directory, int maxTracks,
+        int64 maxDiskSize);
+
+    /******************************************
+    * Name:
+    *  ~WaveformCache
+    * Description:
+    *  destructor of the WaveformCache class. Drops queued builds
+    *  and waits for the ones in progress to stop.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    ~WaveformCache();
+
+    // methods
+    /******************************************
+    * Name:
+    *  getPeaksAsync
+    * Description:
+    *  gets the peaks of a track from memory if they are there,
+    *  otherwise reads them from disk or, if not on disk either,
+    *  decodes the file on the background thread. A track requested
+    *  again while it is being built is only decoded once. Must be
+    *  called from the message thread.
+    * Parameters:
+    *  fullPath: full path of the track
+    *  onReady: called on the message thread with the peaks, or
+    *    nullptr if the file could not be read
+    * Output:
+    *  N/A
+    *******************************************/
+    void getPeaksAsync(const String& fullPath,
+        std::function<void(std::shared_ptr<const WaveformPeaks>)> onReady);
+
+    /******************************************
+    * Name:
+    *  pregenerate
+    * Description:
+    *  queues tracks to have their peaks built and saved to disk
+    *  ahead of being loaded, on a separate background thread so
+    *  requests from the decks are not held up. Tracks already on
+    *  disk are skipped. Pre-generated peaks never evict other peak
+    *  files, so pre-generation stops once the size limit is reached.
+    * Parameters:
+    *  fullPaths: full paths of the tracks
+    * Output:
+    *  N/A
+    *******************************************/
+    void pregenerate(const StringArray& fullPaths);
+
+private:
+    // header of a peak file, followed by the UTF-8 path of the
+    // track and the peaks of the finest level, in native byte order
+    struct FileHeader {
+        uint32 magic;           // identifies the type of file
+        uint32 version;         // format version
+        int64 fileSize;         // size of the track when the peaks were built
+        int64 modificationTime; // modification time of the track when the peaks were built, in ms
+        int64 lengthInSamples;  // length of the track in samples
+        double sampleRate;      // sampling rate of the track
+        uint32 pathLength;      // length of the UTF-8 path, in bytes
+        uint32 numPeaks;        // no. of peaks following the path
+    };
+    static_assert(sizeof(FileHeader) == 48, "WaveformCache::FileHeader must be 48 bytes");
+    static_assert(sizeof(WaveformPeaks::Peak) == 12, "WaveformPeaks::Peak must be 12 bytes");
+
+    // methods
+    /******************************************
+    * Name:
+    *  loadPeaks
+    * Description:
+    *  called on a background thread. Reads the peaks of a track
+    *  from disk, or decodes the track and saves its peaks to disk,
+    *  then passes them to every callback waiting for them. The
+    *  track must have an entry in pending.
+    * Parameters:
+    *  fullPath: full path of the track
+    *  mayEvict: if older peak files may be removed to make room
+    * Output:
+    *  N/A
+    *******************************************/
+    void loadPeaks(const String& fullPath, bool mayEvict);
+
+    /******************************************
+    * Name:
+    *  pregeneratePeaks
+    * Description:
+    *  called on the pre-generation thread. Builds and saves the
+    *  peaks of a track, unless they are on disk already, being
+    *  loaded for a deck or would not fit within the size limit.
+    * Parameters:
+    *  fullPath: full path of the track
+    * Output:
+    *  N/A
+    *******************************************/
+    void pregeneratePeaks(const String& fullPath);
+
+    /******************************************
+    * Name:
+    *  findInMemory
+    * Description:
+    *  looks up the peaks of a track in memory and marks them as
+    *  the most recently used. The lock must be held.
+    * Parameters:
+    *  fullPath: full path of the track
+    * Output:
+    *  the peaks, nullptr if they are not in memory
+    *******************************************/
+    std::shared_ptr<const WaveformPeaks> findInMemory(const String& fullPath);
+
+    /******************************************
+    * Name:
+    *  addToMemory
+    * Description:
+    *  keeps the peaks of a track in memory as the most recently
+    *  used, dropping the least recently used ones over the limit.
+    *  The lock must be held.
+    * Parameters:
+    *  fullPath: full path of the track
+    *  peaks: peaks of the track
+    * Output:
+    *  N/A
+    *******************************************/
+    void addToMemory(const String& fullPath, std::shared_ptr<const WaveformPeaks> peaks);
+
+    /******************************************
+    * Name:
+    *  getPeakFile
+    * Description:
+    *  getter for the peak file of a track. Named after a hash of
+    *  the path, so a changed track overwrites its old peaks.
+    * Parameters:
+    *  fullPath: full path of the track
+    * Output:
+    *  the peak file, which may not exist
+    *******************************************/
+    File getPeakFile(const String& fullPath);
+
+    /******************************************
+    * Name:
+    *  getPeakFileSize
+    * Description:
+    *  getter for the size the peak file of a track will have.
+    * Parameters:
+    *  fullPath: full path of the track
+    *  lengthInSamples: length of the track in samples
+    * Output:
+    *  size of the peak file, in bytes
+    *******************************************/
+    static int64 getPeakFileSize(const String& fullPath, int64 lengthInSamples);
+
+    /******************************************
+    * Name:
+    *  getDiskSize
+    * Description:
+    *  getter for the total size of the peak files. The folder is
+    *  only scanned the first time, after that the size is kept up
+    *  to date by writeToDisk and trimDisk. The disk lock must be
+    *  held.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  total size of the peak files, in bytes
+    *******************************************/
+    int64 getDiskSize();
+
+    /******************************************
+    * Name:
+    *  readHeader
+    * Description:
+    *  reads the header and path of a peak file and checks that
+    *  they belong to the track as it is now.
+    * Parameters:
+    *  stream: stream of the peak file
+    *  fullPath: full path of the track
+    *  track: the track file
+    *  header: header to fill in
+    * Output:
+    *  true if the peak file is valid for the track
+    *******************************************/
+    static bool readHeader(InputStream& stream, const String& fullPath, const File& track,
+        FileHeader& header);
+
+    /******************************************
+    * Name:
+    *  isOnDisk
+    * Description:
+    *  checks if valid peaks of a track are on disk, without
+    *  reading them.
+    * Parameters:
+    *  fullPath: full path of the track
+    * Output:
+    *  true if the peaks are on disk
+    *******************************************/
+    bool isOnDisk(const String& fullPath);
+
+    /******************************************
+    * Name:
+    *  readFromDisk
+    * Description:
+    *  reads the peaks of a track from disk and marks the peak
+    *  file as the most recently used.
+    * Parameters:
+    *  fullPath: full path of the track
+    * Output:
+    *  the peaks, nullptr if not on disk or outdated
+    *******************************************/
+    std::shared_ptr<WaveformPeaks> readFromDisk(const String& fullPath);
+
+    /******************************************
+    * Name:
+    *  writeToDisk
+    * Description:
+    *  saves the peaks of a track to disk, replacing any older
+    *  peak file, then removes the least recently used peak files
+    *  over the size limit. If no peak files may be removed, the
+    *  peaks are not saved unless they fit within the limit.
+    * Parameters:
+    *  fullPath: full path of the track
+    *  track: the track file, as it was when the peaks were built
+    *  peaks: peaks of the track
+    *  mayEvict: if older peak files may be removed to make room
+    * Output:
+    *  true if saved
+    *******************************************/
+    bool writeToDisk(const String& fullPath, const File& track, const WaveformPeaks& peaks,
+        bool mayEvict);
+
+    /******************************************
+    * Name:
+    *  trimDisk
+    * Description:
+    *  removes the least recently used peak files until their
+    *  total size is within the limit. Scans the folder, so only
+    *  called once the limit is exceeded. The disk lock must be held.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void trimDisk();
+
+    // functionality members
+    AudioFormatManager& formatManager;  // reference to global AudioFormatManager
+    File directory;     // folder holding the peak files
+    int maxTracks;      // max. no. of tracks kept in memory
+    int64 maxDiskSize;  // max. total size of the peak files, in bytes
+    CriticalSection lock;   // guards the members below
+    std::vector<std::pair<String, std::shared_ptr<const WaveformPeaks>>> recent; // peaks in memory,
+                                                                                 // least recently used first
+    std::map<String, std::vector<std::function<void(std::shared_ptr<const WaveformPeaks>)>>>
+        pending;    // callbacks waiting for each track queued or being loaded
+    CriticalSection diskLock;   // serializes writing and trimming the peak files
+    int64 diskSize = -1;        // total size of the peak files, -1 until the folder is scanned
+    std::atomic<bool> diskFull{ false };    // set once pre-generated peaks no longer fit on disk
+    std::atomic<bool> cancelled{ false };   // set on destruction to stop the builds in progress
+    ThreadPool pool{ 1 };   // single background thread loading the peaks for the decks
+    ThreadPool pregenerationPool{ 1 };  // single background thread pre-generating peaks
+
+    // private constants
+    static const uint32 MAGIC = 0x4b50544f; // "OTPK", identifies a peak file
+    static const uint32 VERSION = 1;        // current format version
+    static const uint32 MAX_PATH_LENGTH = 65536;    // max. length of a path in a peak file
+    static const String EXTENSION;  // file extension of the peak files
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformCache)
+};
\ No newline at end of file
@@ -11,26 +11,29 @@
 #include <JuceHeader.h>
 #include "WaveformDisplay.h"
 
-//==============================================================================
 /******************************************
 * Name:
 *  WaveformDisplay
 * Description:
 *  Constructor of the WaveformDisplay class. set up custom LookAndFeel,
-*  initialize and add GUI components, add this as a change listener to the
-*  audio thumbnail cache.
+*  initialize and add GUI components. When the renderer is enabled the
+*  waveform and playhead are drawn by it on the GPU instead.
 * Parameters:
-*  formatManagerToUse: reference to global AudioFormatManager
-*  cacheToUse: reference to global AudioThumbnailCache
+*  cacheToUse: reference to global WaveformCache
 *  track: pointer to associated track
+*  rendererToUse: reference to global WaveformRenderer
 * Output:
 *  N/A
 *******************************************/
-WaveformDisplay::WaveformDisplay(AudioFormatManager& formatManagerToUse,
-    AudioThumbnailCache& cacheToUse, Track* _track) :
-    audioThumb(1000, formatManagerToUse, cacheToUse),
+WaveformDisplay::WaveformDisplay(WaveformCache& cacheToUse, Track* _track,
+    WaveformRenderer& rendererToUse) :
     fileLoaded(false),
     track(_track),
+    cache(cacheToUse),
+    renderer(rendererToUse),
+    zoom(MIN_ZOOM),
+    samplesPerPixel(0),
+    viewColumn(0),
     playhead(_track)
 {
     // set custom LookAndFeel
@@ -39,8 +42,22 @@ WaveformDisplay::WaveformDisplay(AudioFormatManager& formatManagerToUse,
     // add and make visible the playhead component
     addAndMakeVisible(playhead);
 
-    // add this as change listener to the thumbnail
-    audioThumb.addChangeListener(this);
+    // everything is drawn from the image or background, nothing behind needs painting
+    setOpaque(true);
+
+    // drawn on the GPU underneath, this component only paints the border
+    if (renderer.isEnabled()) {
+        setOpaque(false);
+        playhead.setPaintingEnabled(false);
+
+        Colour colours[WaveformRenderer::numViewColours];
+        colours[WaveformRenderer::colourBackground] = lookAndFeel.findColour(ResizableWindow::backgroundColourId);
+        colours[WaveformRenderer::colourWaveform] = lookAndFeel.findColour(OtoDecksLookAndFeel::waveformColourId);
+        colours[WaveformRenderer::colourRms] = colours[WaveformRenderer::colourWaveform].brighter();
+        colours[WaveformRenderer::colourPlayhead] =
+            lookAndFeel.findColour(OtoDecksLookAndFeel::playheadColourId).withAlpha((uint8)127);
+        renderer.addWaveform(this, colours);
+    }
 }
 
 /******************************************
@@ -49,13 +66,17 @@ WaveformDisplay::WaveformDisplay(AudioFormatManager& formatManagerToUse,
 * Description:
 *  Destructor for the WaveformDisplay class.
 *  Sets the LookAndFeel to nullptr to release
-*  the reference.
+*  the reference and stops the renderer drawing it.
 * Parameters:
 *  N/A
 * Output:
 *  N/A
 *******************************************/
 WaveformDisplay::~WaveformDisplay() {
+    if (renderer.isEnabled()) {
+        renderer.removeView(this);
+    }
+
     // release reference to custom LookAndFeel
     setLookAndFeel(nullptr);
 }
@@ -64,7 +85,9 @@ WaveformDisplay::~WaveformDisplay() {
 * Name:
 *  paint
 * Description:
-*  override of base class paint method
+*  override of base class paint method. Copies the
+*  repainted region from the waveform image, or just
+*  draws the border over what the renderer draws.
 * Parameters:
 *  g: reference to Graphics used for drawing the
 *    time-domain waveform
@@ -73,30 +96,27 @@ WaveformDisplay::~WaveformDisplay() {
 *******************************************/
 void WaveformDisplay::paint (juce::Graphics& g)
 {
-    // get, set background colour and draw
     auto& lookAndFeel = getLookAndFeel();
-    g.fillAll (lookAndFeel.findColour (juce::ResizableWindow::backgroundColourId));   // clear the background
-
-    // draw border
-    g.setColour (juce::Colours::grey);
-    g.drawRect (getLocalBounds(), 1);   // draw an outline around the component
 
-    // draw waveform if file is loaded
-    g.setColour(lookAndFeel.findColour(OtoDecksLookAndFeel::waveformColourId));
-    if (fileLoaded) {
-        audioThumb.drawChannel(g,
-            getLocalBounds(),
-            0,
-            audioThumb.getTotalLength(),
-            0,
-            1.0f);
-    }
-    // write text if file is not loaded (irrelevant but kept as legacy code)
-    else {
+    // draw waveform if file is loaded, only the clipped (repainted) region is copied
+    if (fileLoaded && waveformImage.isValid()) {
+        g.drawImageAt(waveformImage, 0, 0);
+    }
+    // write text if file is not loaded (irrelevant but kept as legacy code); on the GPU
+    // the renderer draws the background, and the waveform once it is loaded
+    else if (!fileLoaded || !renderer.isEnabled()) {
+        if (!renderer.isEnabled()) {
+            g.fillAll(lookAndFeel.findColour(juce::ResizableWindow::backgroundColourId));   // clear the background
+        }
+        g.setColour(lookAndFeel.findColour(OtoDecksLookAndFeel::waveformColourId));
         g.setFont(20.0f);
         g.drawText("File not loaded...", getLocalBounds(),
             juce::Justification::centred, true);   // draw some placeholder text
     }
+
+    // draw border
+    g.setColour (juce::Colours::grey);
+    g.drawRect (getLocalBounds(), 1);   // draw an outline around the component
 }
 
 /******************************************
@@ -104,7 +124,8 @@ void WaveformDisplay::paint (juce::Graphics& g)
 *  resized
 * Description:
 *  override of base class resized function to
-*  properly scale subcomponents.
+*  properly scale subcomponents and redraw the
+*  waveform image at the new size.
 * Parameters:
 *  N/A
 * Output:
@@ -113,21 +134,25 @@ void WaveformDisplay::paint (juce::Graphics& g)
 void WaveformDisplay::resized()
 {   // resize playhead to fill entire component space
     playhead.setBounds(getLocalBounds());
+    updateWaveform(true);
 }
 
 /******************************************
 * Name:
-*  changeListenerCallback
+*  mouseWheelMove
 * Description:
-*  Used to associate this with the audio thumbnail cache
-*  to repaint when notified that the thumbnail is changed (ready).
+*  override of base class mouseWheelMove method. Zooms
+*  in or out of the waveform around the playhead.
 * Parameters:
-*  source: Not Used.
+*  event: Not Used.
+*  wheel: details of the wheel movement
 * Output:
 *  N/A
 *******************************************/
-void WaveformDisplay::changeListenerCallback(ChangeBroadcaster* source) {
-    repaint();
+void WaveformDisplay::mouseWheelMove(const MouseEvent& event, const MouseWheelDetails& wheel) {
+    if (wheel.deltaY != 0) {
+        setZoom(wheel.deltaY > 0 ? zoom * STEP_ZOOM : zoom / STEP_ZOOM);
+    }
 }
 
 /******************************************
@@ -135,31 +160,192 @@ void WaveformDisplay::changeListenerCallback(ChangeBroadcaster* source) {
 *  repaintPlayhead
 * Description:
 *  relay function to repaint only the playhead when timer
-*  in deck player component triggers.
+*  in deck player component triggers. When zoomed in, the
+*  waveform scrolls with the playhead and is updated too.
 * Parameters:
 *  N/A
 * Output:
 *  N/A
 *******************************************/
 void WaveformDisplay::repaintPlayhead() {
-    // update playhead position and repaint ONLY the playhead
+    // update playhead position, repainting ONLY where it was and where it is now
     playhead.setPosition(track->getPositionRelative());
-    playhead.repaint();
+
+    // zoomed in, the view moves with the playhead; on the GPU the playhead is drawn with it
+    if (zoom > MIN_ZOOM || renderer.isEnabled()) {
+        updateWaveform(false);
+    }
 }
 
 /******************************************
 * Name:
 *  loadURL
 * Description:
-*  load the audio file at specified URL and start
-*  loading the waveform in the audio thumbnail cache
+*  get the peaks of the audio file at specified URL from
+*  the waveform cache, which builds them in the background
+*  if needed, and draw them once they are ready.
 * Parameters:
 *  audioURL: url to audio file
 * Output:
 *  N/A
 *******************************************/
 void WaveformDisplay::loadURL(URL audioURL) {
-    // load audio thumbnail
-    audioThumb.clear();
-    fileLoaded = audioThumb.setSource(new URLInputSource(audioURL));
-}
\ No newline at end of file
+    peaks = nullptr;
+    fileLoaded = false;
+    if (renderer.isEnabled()) {
+        renderer.setPeaks(this, nullptr);
+    }
+    repaint();
+
+    // the display may be closed before the peaks are ready
+    Component::SafePointer<WaveformDisplay> safeThis(this);
+    cache.getPeaksAsync(audioURL.getLocalFile().getFullPathName(),
+        [safeThis](std::shared_ptr<const WaveformPeaks> loadedPeaks) {
+            if (safeThis != nullptr) {
+                safeThis->peaks = loadedPeaks;
+                safeThis->fileLoaded = loadedPeaks != nullptr;
+                if (safeThis->renderer.isEnabled()) {
+                    safeThis->renderer.setPeaks(safeThis.getComponent(), loadedPeaks);
+                }
+                safeThis->updateWaveform(true);
+                safeThis->repaint();
+            }
+        });
+}
+
+/******************************************
+* Name:
+*  setZoom
+* Description:
+*  setter for how far the waveform is zoomed in. At the
+*  lowest zoom the whole track is shown, otherwise a part of
+*  it centred on the playhead.
+* Parameters:
+*  zoom: track length / visible length (MIN_ZOOM - MAX_ZOOM)
+* Output:
+*  N/A
+*******************************************/
+void WaveformDisplay::setZoom(double newZoom) {
+    zoom = jlimit(MIN_ZOOM, MAX_ZOOM, newZoom);
+    updateWaveform(true);
+}
+
+/******************************************
+* Name:
+*  updateWaveform
+* Description:
+*  computes the visible part of the track from the zoom and
+*  the playhead position and passes it to the playhead. Brings
+*  the waveform image up to date and repaints it, if it changed.
+*  When the view only scrolled, the image is shifted and just
+*  the newly visible columns are drawn. On the GPU, the view and
+*  playhead are passed to the renderer instead.
+* Parameters:
+*  redrawAll: if the whole image must be drawn again
+* Output:
+*  N/A
+*******************************************/
+void WaveformDisplay::updateWaveform(bool redrawAll) {
+    auto width = getWidth();
+    auto height = getHeight();
+    if (!fileLoaded || width <= 0 || height <= 0) {
+        waveformImage = Image();
+        return;
+    }
+
+    // columns of the view, zoomed in the playhead is kept in the centre column
+    auto length = (double)peaks->getLengthInSamples();
+    auto newSamplesPerPixel = length / zoom / width;
+    if (newSamplesPerPixel != samplesPerPixel) {
+        samplesPerPixel = newSamplesPerPixel;
+        redrawAll = true;
+    }
+    auto newViewColumn = (int64)0;
+    if (zoom > MIN_ZOOM) {
+        newViewColumn = (int64)(track->getPositionRelative() * length / samplesPerPixel) - width / 2;
+    }
+    auto shift = newViewColumn - viewColumn;
+    viewColumn = newViewColumn;
+    playhead.setView(viewColumn * samplesPerPixel / length, 1.0 / zoom);
+
+    // on the GPU the waveform is drawn from the peaks uploaded once, only the view is passed on
+    if (renderer.isEnabled()) {
+        renderer.setView(this, viewColumn * samplesPerPixel / length, 1.0 / zoom,
+            track->getPositionRelative());
+        return;
+    }
+
+    // new image at the current size
+    if (waveformImage.getWidth() != width || waveformImage.getHeight() != height) {
+        waveformImage = Image(Image::RGB, width, height, false);
+        redrawAll = true;
+    }
+
+    // draw everything, or shift the image and draw only the columns scrolled into view
+    if (redrawAll || std::abs(shift) >= width) {
+        drawColumns(0, width);
+    }
+    else if (shift > 0) {
+        waveformImage.moveImageSection(0, 0, (int)shift, 0, width - (int)shift, height);
+        drawColumns(width - (int)shift, width);
+    }
+    else if (shift < 0) {
+        waveformImage.moveImageSection((int)-shift, 0, 0, 0, width + (int)shift, height);
+        drawColumns(0, (int)-shift);
+    }
+    // nothing changed
+    else {
+        return;
+    }
+    repaint();
+}
+
+/******************************************
+* Name:
+*  drawColumns
+* Description:
+*  draws a range of pixel columns of the waveform image
+*  from the peaks.
+* Parameters:
+*  startX: first column to draw
+*  endX: one past the last column to draw
+* Output:
+*  N/A
+*******************************************/
+void WaveformDisplay::drawColumns(int startX, int endX) {
+    auto numColumns = endX - startX;
+    auto centre = waveformImage.getHeight() * 0.5f;
+    auto& lookAndFeel = getLookAndFeel();
+    auto colour = lookAndFeel.findColour(OtoDecksLookAndFeel::waveformColourId);
+
+    // clear the columns
+    Graphics g(waveformImage);
+    g.reduceClipRegion(startX, 0, numColumns, waveformImage.getHeight());
+    g.fillAll(lookAndFeel.findColour(juce::ResizableWindow::backgroundColourId));
+
+    // one peak per column
+    columns.resize((size_t)numColumns);
+    peaks->getPeaks((viewColumn + startX) * samplesPerPixel, samplesPerPixel, columns.data(),
+        numColumns);
+
+    // min. to max. of each column, with the RMS level on top of it
+    RectangleList<float> waveform, rms;
+    waveform.ensureStorageAllocated(numColumns);
+    rms.ensureStorageAllocated(numColumns);
+    for (auto i = 0; i < numColumns; ++i) {
+        const auto& peak = columns[(size_t)i];
+        auto x = (float)(startX + i);
+        auto top = centre - peak.max * centre;
+        auto bottom = centre - peak.min * centre;
+        waveform.addWithoutMerging({ x, top, 1.0f, jmax(1.0f, bottom - top) });
+        rms.addWithoutMerging({ x, centre - peak.rms * centre, 1.0f, peak.rms * 2 * centre });
+    }
+    g.setColour(colour);
+    g.fillRectList(waveform);
+    g.setColour(colour.brighter());
+    g.fillRectList(rms);
+}
+
+const double WaveformDisplay::MIN_ZOOM = 1.0;
+const double WaveformDisplay::MAX_ZOOM = 64.0;
+const double WaveformDisplay::STEP_ZOOM = 1.25;
\ No newline at end of file
@@ -15,13 +15,14 @@ using namespace juce;
 
 #include "OtoDecksLookAndFeel.h"
 #include "WaveformDisplayPlayhead.h"
+#include "WaveformCache.h"
+#include "WaveformRenderer.h"
 #include "Track.h"
 
 //==============================================================================
 /*
 */
-class WaveformDisplay  : public juce::Component,
-    public ChangeListener
+class WaveformDisplay  : public juce::Component
 {
 public:
     // constructors & destructors
@@ -30,17 +31,16 @@ public:
     *  WaveformDisplay
     * Description:
     *  Constructor of the WaveformDisplay class. set up custom LookAndFeel,
-    *  initialize and add GUI components, add this as a change listener to the
-    *  audio thumbnail cache.
+    *  initialize and add GUI components. When the renderer is enabled the
+    *  waveform and playhead are drawn by it on the GPU instead.
     * Parameters:
-    *  formatManagerToUse: reference to global AudioFormatManager
-    *  cacheToUse: reference to global AudioThumbnailCache
+    *  cacheToUse: reference to global WaveformCache
     *  track: pointer to associated track
+    *  rendererToUse: reference to global WaveformRenderer
     * Output:
     *  N/A
     *******************************************/
-    WaveformDisplay(AudioFormatManager& formatManagerToUse,
-        AudioThumbnailCache& cacheToUse, Track *track);
+    WaveformDisplay(WaveformCache& cacheToUse, Track *track, WaveformRenderer& rendererToUse);
 
     /******************************************
     * Name:
@@ -48,7 +48,7 @@ public:
     * Description:
     *  Destructor for the WaveformDisplay class.
     *  Sets the LookAndFeel to nullptr to release
-    *  the reference.
+    *  the reference and stops the renderer drawing it.
     * Parameters:
     *  N/A
     * Output:
@@ -61,7 +61,9 @@ public:
     * Name:
     *  paint
     * Description:
-    *  override of base class paint method
+    *  override of base class paint method. Copies the
+    *  repainted region from the waveform image, or just
+    *  draws the border over what the renderer draws.
     * Parameters:
     *  g: reference to Graphics used for drawing the
     *    time-domain waveform
@@ -75,7 +77,8 @@ public:
     *  resized
     * Description:
     *  override of base class resized function to
-    *  properly scale subcomponents.
+    *  properly scale subcomponents and redraw the
+    *  waveform image at the new size.
     * Parameters:
     *  N/A
     * Output:
@@ -83,19 +86,19 @@ public:
     *******************************************/
     void resized() override;
 
-    // ChangeListener overrides
     /******************************************
     * Name:
-    *  changeListenerCallback
+    *  mouseWheelMove
     * Description:
-    *  Used to associate this with the audio thumbnail cache
-    *  to repaint when notified that the thumbnail is changed (ready).
+    *  override of base class mouseWheelMove method. Zooms
+    *  in or out of the waveform around the playhead.
     * Parameters:
-    *  source: Not Used.
+    *  event: Not Used.
+    *  wheel: details of the wheel movement
     * Output:
     *  N/A
     *******************************************/
-    void changeListenerCallback(ChangeBroadcaster* source) override;
+    void mouseWheelMove(const MouseEvent& event, const MouseWheelDetails& wheel) override;
 
     // methods
     /******************************************
@@ -103,7 +106,8 @@ public:
     *  repaintPlayhead
     * Description:
     *  relay function to repaint only the playhead when timer
-    *  in deck player component triggers.
+    *  in deck player component triggers. When zoomed in, the
+    *  waveform scrolls with the playhead and is updated too.
     * Parameters:
     *  N/A
     * Output:
@@ -115,8 +119,9 @@ public:
     * Name:
     *  loadURL
     * Description:
-    *  load the audio file at specified URL and start
-    *  loading the waveform in the audio thumbnail cache
+    *  get the peaks of the audio file at specified URL from
+    *  the waveform cache, which builds them in the background
+    *  if needed, and draw them once they are ready.
     * Parameters:
     *  audioURL: url to audio file
     * Output:
@@ -124,13 +129,72 @@ public:
     *******************************************/
     void loadURL(URL audioURL);
 
+    // getters & setters
+    /******************************************
+    * Name:
+    *  setZoom
+    * Description:
+    *  setter for how far the waveform is zoomed in. At the
+    *  lowest zoom the whole track is shown, otherwise a part of
+    *  it centred on the playhead.
+    * Parameters:
+    *  zoom: track length / visible length (MIN_ZOOM - MAX_ZOOM)
+    * Output:
+    *  N/A
+    *******************************************/
+    void setZoom(double zoom);
+
+    // public constants
+    static const double MIN_ZOOM;   // min. zoom, whole track visible
+    static const double MAX_ZOOM;   // max. zoom
+    static const double STEP_ZOOM;  // zoom factor per mouse wheel step
+
 private:
+    // methods
+    /******************************************
+    * Name:
+    *  updateWaveform
+    * Description:
+    *  computes the visible part of the track from the zoom and
+    *  the playhead position and passes it to the playhead. Brings
+    *  the waveform image up to date and repaints it, if it changed.
+    *  When the view only scrolled, the image is shifted and just
+    *  the newly visible columns are drawn. On the GPU, the view and
+    *  playhead are passed to the renderer instead.
+    * Parameters:
+    *  redrawAll: if the whole image must be drawn again
+    * Output:
+    *  N/A
+    *******************************************/
+    void updateWaveform(bool redrawAll);
+
+    /******************************************
+    * Name:
+    *  drawColumns
+    * Description:
+    *  draws a range of pixel columns of the waveform image
+    *  from the peaks.
+    * Parameters:
+    *  startX: first column to draw
+    *  endX: one past the last column to draw
+    * Output:
+    *  N/A
+    *******************************************/
+    void drawColumns(int startX, int endX);
+
     // functionality members
     bool fileLoaded;    // flag indicating if file has been loaded
     Track* track;   // pointer to associated track
+    WaveformCache& cache;   // reference to global WaveformCache
+    WaveformRenderer& renderer; // reference to global WaveformRenderer
+    std::shared_ptr<const WaveformPeaks> peaks; // peaks of the track, nullptr until ready
 
     // GUI related members
-    AudioThumbnail audioThumb;  // particular thumbnail that should be drawn
+    double zoom;        // track length / visible length
+    double samplesPerPixel; // no. of samples per pixel column at the current zoom
+    int64 viewColumn;   // first visible column, counted in columns from the start of the track
+    Image waveformImage;    // the visible waveform, drawn only when it changes
+    std::vector<WaveformPeaks::Peak> columns;   // peaks of the columns being drawn, reused
     OtoDecksLookAndFeel lookAndFeel;    // custom LookAndFeel
     WaveformDisplayPlayhead playhead;   // instance playhead component
 
@@ -24,7 +24,12 @@
 *  N/A
 *******************************************/
 WaveformDisplayPlayhead::WaveformDisplayPlayhead(Track* _track): position(0),
-    track(_track)
+    track(_track),
+    viewStart(0),
+    viewLength(1),
+    paintingEnabled(true),
+    dragStartX(0),
+    dragStartPosition(0)
 {
    // set custom look and feel 
     setLookAndFeel(&lookAndFeel);
@@ -67,13 +72,17 @@ WaveformDisplayPlayhead::~WaveformDisplayPlayhead()
 *******************************************/
 void WaveformDisplayPlayhead::paint (juce::Graphics& g)
 {
+    // drawn on the GPU instead
+    if (!paintingEnabled) {
+        return;
+    }
+
     // get and set playhead colour
     Colour c = getLookAndFeel().findColour(OtoDecksLookAndFeel::playheadColourId);
     g.setColour(Colour::fromRGBA(c.getRed(), c.getGreen(), c.getBlue(), 127));
-    auto windowWidth = getWidth()/ N_WINDOW;
     
-    // draw playhead
-    g.fillRect(position * getWidth() - windowWidth/2, 0, windowWidth, getHeight());
+    // draw playhead within the visible part of the track
+    g.fillRect(getPlayheadArea());
 }
 
 /******************************************
@@ -81,15 +90,21 @@ void WaveformDisplayPlayhead::paint (juce::Graphics& g)
 *  mouseDown
 * Description:
 *  callback for when mouse is clicked in this component area.
-*  Update track position using mouse horizontal position.
+*  Update track position using mouse horizontal position, or
+*  start scrubbing if the waveform is zoomed in.
 * Parameters:
 *  event: reference to MouseEvent used to retrieve mouse position.
 * Output:
 *  N/A
 *******************************************/
 void WaveformDisplayPlayhead::mouseDown(const MouseEvent& event) {
-    // update playhead position with mouse x
-    setPositionWithMouseX(event.x);
+    dragStartX = event.x;
+    dragStartPosition = position;
+
+    // update playhead position with mouse x, unless zoomed in
+    if (viewLength >= 1.0) {
+        setPositionWithMouseX(event.x);
+    }
 }
 
 /******************************************
@@ -97,15 +112,25 @@ void WaveformDisplayPlayhead::mouseDown(const MouseEvent& event) {
 *  mouseDrag
 * Description:
 *  callback for when mouse is dragged over this component's area.
-*  Update track position using mouse horizontal position.
+*  Update track position using mouse horizontal position. If the
+*  waveform is zoomed in, the track is moved by the drag distance
+*  instead, as the view is centred on the playhead.
 * Parameters:
 *  event: reference to MouseEvent used to retrieve mouse position.
 * Output:
 *  N/A
 *******************************************/
 void WaveformDisplayPlayhead::mouseDrag(const MouseEvent& event) {
+    // zoomed in, move the track with the waveform under the mouse
+    if (viewLength < 1.0) {
+        auto distance = (double)(event.x - dragStartX) / getWidth() * viewLength;
+        setPosition(jlimit(0.0, 1.0, dragStartPosition - distance));
+        track->setPositionRelative(position);
+    }
     // update playhead position with mouse x
-    setPositionWithMouseX(event.x);
+    else {
+        setPositionWithMouseX(event.x);
+    }
 }
 
 /******************************************
@@ -114,15 +139,25 @@ void WaveformDisplayPlayhead::mouseDrag(const MouseEvent& event) {
 * Description:
 *  Used to set relative position used for drawing. Called by
 *  timer callback in deck player component to update playhead during
-*  playback
+*  playback. Repaints only the areas the playhead moved from and to
 * Parameters:
 *  position: relative position (0.0 - 1.0)
 * Output:
 *  N/A
 *******************************************/
 void WaveformDisplayPlayhead::setPosition(double pos) {
-    // set relative position
+    if (pos == position) {
+        return;
+    }
+
+    // set relative position, repainting ONLY the old and the new playhead area
+    auto oldArea = getPlayheadArea();
     position = pos;
+    if (!paintingEnabled) {
+        return;
+    }
+    repaint(oldArea);
+    repaint(getPlayheadArea());
 }
 
 /******************************************
@@ -138,8 +173,59 @@ void WaveformDisplayPlayhead::setPosition(double pos) {
 *******************************************/
 void WaveformDisplayPlayhead::setPositionWithMouseX(int x) {
     // compute relative position from mouses x and component width
-    position = (float)x / getWidth();
+    setPosition(jlimit(0.0, 1.0, viewStart + (double)x / getWidth() * viewLength));
 
     // update track position
     track->setPositionRelative(position);
+}
+
+/******************************************
+* Name:
+*  setView
+* Description:
+*  Used to set the part of the track the waveform display
+*  shows, so the playhead is drawn and mouse positions are
+*  mapped within it.
+* Parameters:
+*  start: start of the visible part (relative; can be < 0)
+*  length: length of the visible part (relative; 0.0-1.0)
+* Output:
+*  N/A
+*******************************************/
+void WaveformDisplayPlayhead::setView(double start, double length) {
+    viewStart = start;
+    viewLength = length;
+}
+
+/******************************************
+* Name:
+*  setPaintingEnabled
+* Description:
+*  Used to turn painting of the playhead off when it is drawn
+*  on the GPU instead. It still follows the mouse.
+* Parameters:
+*  enabled: true to paint the playhead, false to not paint it
+* Output:
+*  N/A
+*******************************************/
+void WaveformDisplayPlayhead::setPaintingEnabled(bool enabled) {
+    paintingEnabled = enabled;
+    repaint();
+}
+
+/******************************************
+* Name:
+*  getPlayheadArea
+* Description:
+*  getter for the area the playhead is drawn in, at its
+*  current position within the visible part of the track.
+* Parameters:
+*  N/A
+* Output:
+*  area covered by the playhead
+*******************************************/
+Rectangle<int> WaveformDisplayPlayhead::getPlayheadArea() {
+    auto windowWidth = getWidth() / N_WINDOW;
+    auto x = (int)((position - viewStart) / viewLength * getWidth());
+    return { x - windowWidth / 2, 0, windowWidth, getHeight() };
 }
\ No newline at end of file
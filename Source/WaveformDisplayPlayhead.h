@@ -70,8 +70,9 @@ public:
     * Name:
     *  mouseDown
     * Description:
-    *  callback for when mouse is clicked in this component area. 
-    *  Update track position using mouse horizontal position.
+    *  callback for when mouse is clicked in this component area.
+    *  Update track position using mouse horizontal position, or
+    *  start scrubbing if the waveform is zoomed in.
     * Parameters:
     *  event: reference to MouseEvent used to retrieve mouse position.
     * Output:
@@ -84,7 +85,9 @@ public:
     *  mouseDrag
     * Description:
     *  callback for when mouse is dragged over this component's area.
-    *  Update track position using mouse horizontal position.
+    *  Update track position using mouse horizontal position. If the
+    *  waveform is zoomed in, the track is moved by the drag distance
+    *  instead, as the view is centred on the playhead.
     * Parameters:
     *  event: reference to MouseEvent used to retrieve mouse position.
     * Output:
@@ -99,7 +102,7 @@ public:
     * Description:
     *  Used to set relative position used for drawing. Called by
     *  timer callback in deck player component to update playhead during 
-    *  playback
+    *  playback. Repaints only the areas the playhead moved from and to
     * Parameters:
     *  position: relative position (0.0 - 1.0)
     * Output:
@@ -120,13 +123,60 @@ public:
     *******************************************/
     void setPositionWithMouseX(int x);
 
+    /******************************************
+    * Name:
+    *  setView
+    * Description:
+    *  Used to set the part of the track the waveform display
+    *  shows, so the playhead is drawn and mouse positions are
+    *  mapped within it.
+    * Parameters:
+    *  start: start of the visible part (relative; can be < 0)
+    *  length: length of the visible part (relative; 0.0-1.0)
+    * Output:
+    *  N/A
+    *******************************************/
+    void setView(double start, double length);
+
+    /******************************************
+    * Name:
+    *  setPaintingEnabled
+    * Description:
+    *  Used to turn painting of the playhead off when it is drawn
+    *  on the GPU instead. It still follows the mouse.
+    * Parameters:
+    *  enabled: true to paint the playhead, false to not paint it
+    * Output:
+    *  N/A
+    *******************************************/
+    void setPaintingEnabled(bool enabled);
+
     // public constants
     static const int N_WINDOW = 128;    // divide component width into n divisions
 
 private:
+    // getters & setters
+    /******************************************
+    * Name:
+    *  getPlayheadArea
+    * Description:
+    *  getter for the area the playhead is drawn in, at its
+    *  current position within the visible part of the track.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  area covered by the playhead
+    *******************************************/
+    Rectangle<int> getPlayheadArea();
+
     // functionality members
     Track* track;   // pointer to associated track
     double position;    // current position to draw playhead at (relative; 0.0-1.0)
+    double viewStart;   // start of the visible part of the track (relative)
+    double viewLength;  // length of the visible part of the track (relative)
+    bool paintingEnabled;   // if the playhead paints itself, false when drawn on the GPU
+    int dragStartX;     // mouse x position where the current drag started
+    double dragStartPosition;   // track position where the current drag started
 
     // GUI members
     OtoDecksLookAndFeel lookAndFeel;    // custom LookAndFeel
@@ -0,0 +1,225 @@
+/*
+  ==============================================================================
+
+    WaveformPeaks.cpp
+    Created: 18 Oct 2026 4:12:37am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#include "WaveformPeaks.h"
+
+/******************************************
+* Name:
+*  WaveformPeaks
+* Description:
+*  constructor of the WaveformPeaks class. Takes the peaks of
+*  the finest level and computes the coarser levels from them,
+*  each level combining two peaks of the level below.
+* Parameters:
+*  sampleRate: sampling rate of the audio file
+*  lengthInSamples: length of the audio file in samples
+*  peaks: peaks of SAMPLES_PER_PEAK samples each
+* Output:
+*  N/A
+*******************************************/
+WaveformPeaks::WaveformPeaks(double _sampleRate, int64 _lengthInSamples, std::vector<Peak> peaks) :
+    sampleRate(_sampleRate),
+    lengthInSamples(_lengthInSamples)
+{
+    levels.push_back(std::move(peaks));
+
+    // halve the resolution until a single peak covers the whole file
+    while (levels.back().size() > 1) {
+        const auto& below = levels.back();
+        std::vector<Peak> level((below.size() + 1) / 2);
+        for (size_t i = 0; i < level.size(); ++i) {
+            // an odd peak at the end is combined with itself
+            const auto& a = below[2 * i];
+            const auto& b = below[jmin(2 * i + 1, below.size() - 1)];
+            level[i].min = jmin(a.min, b.min);
+            level[i].max = jmax(a.max, b.max);
+            level[i].rms = std::sqrt((a.rms * a.rms + b.rms * b.rms) * 0.5f);
+        }
+        levels.push_back(std::move(level));
+    }
+}
+
+/******************************************
+* Name:
+*  build
+* Description:
+*  decodes the whole audio file once and computes its peaks.
+*  Slow, must be called on a background thread.
+* Parameters:
+*  reader: reader of the audio file
+*  cancelled: checked between blocks, stops building when set
+* Output:
+*  the peaks, nullptr if cancelled or the file could not be read
+*******************************************/
+std::shared_ptr<WaveformPeaks> WaveformPeaks::build(AudioFormatReader& reader,
+    const std::atomic<bool>& cancelled) {
+    auto length = reader.lengthInSamples;
+    if (length <= 0 || reader.sampleRate <= 0) {
+        DBG("WaveformPeaks::build: nothing to read");
+        return nullptr;
+    }
+
+    auto nChannels = jlimit(1, N_CHANNELS, (int)reader.numChannels);
+    AudioBuffer<float> buffer(nChannels, SIZE_BLOCK);
+    std::vector<Peak> peaks;
+    peaks.reserve((size_t)((length + SAMPLES_PER_PEAK - 1) / SAMPLES_PER_PEAK));
+
+    // decode block by block, SIZE_BLOCK is a multiple of SAMPLES_PER_PEAK
+    for (int64 pos = 0; pos < length; pos += SIZE_BLOCK) {
+        if (cancelled.load()) {
+            return nullptr;
+        }
+        auto n = (int)jmin((int64)SIZE_BLOCK, length - pos);
+        reader.read(&buffer, 0, n, pos, true, true);
+
+        // one peak per SAMPLES_PER_PEAK samples, over all channels
+        for (auto offset = 0; offset < n; offset += SAMPLES_PER_PEAK) {
+            auto m = jmin(SAMPLES_PER_PEAK, n - offset);
+            auto range = FloatVectorOperations::findMinAndMax(buffer.getReadPointer(0, offset), m);
+            auto sumSquares = 0.0f;
+            for (auto ch = 0; ch < nChannels; ++ch) {
+                if (ch > 0) {
+                    range = range.getUnionWith(
+                        FloatVectorOperations::findMinAndMax(buffer.getReadPointer(ch, offset), m));
+                }
+                auto rms = buffer.getRMSLevel(ch, offset, m);
+                sumSquares += rms * rms;
+            }
+            peaks.push_back({ range.getStart(), range.getEnd(), std::sqrt(sumSquares / nChannels) });
+        }
+    }
+
+    return std::make_shared<WaveformPeaks>(reader.sampleRate, length, std::move(peaks));
+}
+
+/******************************************
+* Name:
+*  getPeaks
+* Description:
+*  computes one peak per pixel for the given range of samples,
+*  reading from the coarsest level that still has at least one
+*  peak per pixel, so the cost only depends on the no. of pixels.
+*  Pixels outside the audio file get a silent peak.
+* Parameters:
+*  startSample: sample at the left edge of the first pixel
+*  samplesPerPixel: no. of samples covered by each pixel
+*  dest: array to write the peaks to
+*  numPixels: no. of pixels (peaks) to compute
+* Output:
+*  N/A
+*******************************************/
+void WaveformPeaks::getPeaks(double startSample, double samplesPerPixel, Peak* dest,
+    int numPixels) const {
+    // pick the coarsest level with at least one peak per pixel
+    auto level = (size_t)0;
+    auto samplesPerPeak = (double)SAMPLES_PER_PEAK;
+    while (level + 1 < levels.size() && samplesPerPeak * 2 <= samplesPerPixel) {
+        ++level;
+        samplesPerPeak *= 2;
+    }
+    const auto& peaks = levels[level];
+    auto numPeaks = (int64)peaks.size();
+
+    for (auto x = 0; x < numPixels; ++x) {
+        // samples covered by the pixel, clipped to the file
+        auto start = jmax(0.0, startSample + x * samplesPerPixel);
+        auto end = jmin(startSample + (x + 1) * samplesPerPixel, (double)lengthInSamples);
+        auto first = (int64)(start / samplesPerPeak);
+        if (start >= end || first >= numPeaks) {
+            dest[x] = { 0.0f, 0.0f, 0.0f };
+            continue;
+        }
+
+        // combine the (at most three) peaks the pixel overlaps
+        auto last = jmin(numPeaks, jmax(first + 1, (int64)std::ceil(end / samplesPerPeak)));
+        auto peak = peaks[(size_t)first];
+        auto sumSquares = peak.rms * peak.rms;
+        for (auto i = first + 1; i < last; ++i) {
+            const auto& p = peaks[(size_t)i];
+            peak.min = jmin(peak.min, p.min);
+            peak.max = jmax(peak.max, p.max);
+            sumSquares += p.rms * p.rms;
+        }
+        peak.rms = std::sqrt(sumSquares / (float)(last - first));
+        dest[x] = peak;
+    }
+}
+
+/******************************************
+* Name:
+*  getSampleRate
+* Description:
+*  getter for the sampling rate of the audio file.
+* Parameters:
+*  N/A
+* Output:
+*  sampling rate of the audio file
+*******************************************/
+double WaveformPeaks::getSampleRate() const {
+    return sampleRate;
+}
+
+/******************************************
+* Name:
+*  getLengthInSamples
+* Description:
+*  getter for the length of the audio file.
+* Parameters:
+*  N/A
+* Output:
+*  length of the audio file in samples
+*******************************************/
+int64 WaveformPeaks::getLengthInSamples() const {
+    return lengthInSamples;
+}
+
+/******************************************
+* Name:
+*  getBasePeaks
+* Description:
+*  getter for the peaks of the finest level, from which all
+*  other levels are computed.
+* Parameters:
+*  N/A
+* Output:
+*  peaks of SAMPLES_PER_PEAK samples each
+*******************************************/
+const std::vector<WaveformPeaks::Peak>& WaveformPeaks::getBasePeaks() const {
+    return levels.front();
+}
+
+/******************************************
+* Name:
+*  getNumLevels
+* Description:
+*  getter for the no. of levels, each holding half as many
+*  peaks as the one before.
+* Parameters:
+*  N/A
+* Output:
+*  no. of levels, at least 1
+*******************************************/
+int WaveformPeaks::getNumLevels() const {
+    return (int)levels.size();
+}
+
+/******************************************
+* Name:
+*  getLevel
+* Description:
+*  getter for the peaks of a level.
+* Parameters:
+*  level: level to get, 0 being the finest (0 - getNumLevels() - 1)
+* Output:
+*  peaks of SAMPLES_PER_PEAK * 2^level samples each
+*******************************************/
+const std::vector<WaveformPeaks::Peak>& WaveformPeaks::getLevel(int level) const {
+    return levels[(size_t)jlimit(0, (int)levels.size() - 1, level)];
+}
\ No newline at end of file
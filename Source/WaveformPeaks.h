@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    WaveformPeaks.h
+    Created: 18 Oct 2026 4:12:37am
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+using namespace juce;
+
+class WaveformPeaks {
+public:
+    // min., max. and RMS level of a range of samples, over all channels
+    struct Peak {
+        float min;  // lowest sample value
+        float max;  // highest sample value
+        float rms;  // root mean square level
+    };
+
+    // constructors & destructors
+    /******************************************
+    * Name:
+    *  WaveformPeaks
+    * Description:
+    *  constructor of the WaveformPeaks class. Takes the peaks of
+    *  the finest level and computes the coarser levels from them,
+    *  each level combining two peaks of the level below.
+    * Parameters:
+    *  sampleRate: sampling rate of the audio file
+    *  lengthInSamples: length of the audio file in samples
+    *  peaks: peaks of SAMPLES_PER_PEAK samples each
+    * Output:
+    *  N/A
+    *******************************************/
+    WaveformPeaks(double sampleRate, int64 lengthInSamples, std::vector<Peak> peaks);
+
+    // methods
+    /******************************************
+    * Name:
+    *  build
+    * Description:
+    *  decodes the whole audio file once and computes its peaks.
+    *  Slow, must be called on a background thread.
+    * Parameters:
+    *  reader: reader of the audio file
+    *  cancelled: checked between blocks, stops building when set
+    * Output:
+    *  the peaks, nullptr if cancelled or the file could not be read
+    *******************************************/
+    static std::shared_ptr<WaveformPeaks> build(AudioFormatReader& reader,
+        const std::atomic<bool>& cancelled);
+
+    /******************************************
+    * Name:
+    *  getPeaks
+    * Description:
+    *  computes one peak per pixel for the given range of samples,
+    *  reading from the coarsest level that still has at least one
+    *  peak per pixel, so the cost only depends on the no. of pixels.
+    *  Pixels outside the audio file get a silent peak.
+    * Parameters:
+    *  startSample: sample at the left edge of the first pixel
+    *  samplesPerPixel: no. of samples covered by each pixel
+    *  dest: array to write the peaks to
+    *  numPixels: no. of pixels (peaks) to compute
+    * Output:
+    *  N/A
+    *******************************************/
+    void getPeaks(double startSample, double samplesPerPixel, Peak* dest, int numPixels) const;
+
+    // getters & setters
+    /******************************************
+    * Name:
+    *  getSampleRate
+    * Description:
+    *  getter for the sampling rate of the audio file.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  sampling rate of the audio file
+    *******************************************/
+    double getSampleRate() const;
+
+    /******************************************
+    * Name:
+    *  getLengthInSamples
+    * Description:
+    *  getter for the length of the audio file.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  length of the audio file in samples
+    *******************************************/
+    int64 getLengthInSamples() const;
+
+    /******************************************
+    * Name:
+    *  getBasePeaks
+    * Description:
+    *  getter for the peaks of the finest level, from which all
+    *  other levels are computed.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  peaks of SAMPLES_PER_PEAK samples each
+    *******************************************/
+    const std::vector<Peak>& getBasePeaks() const;
+
+    /******************************************
+    * Name:
+    *  getNumLevels
+    * Description:
+    *  getter for the no. of levels, each holding half as many
+    *  peaks as the one before.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  no. of levels, at least 1
+    *******************************************/
+    int getNumLevels() const;
+
+    /******************************************
+    * Name:
+    *  getLevel
+    * Description:
+    *  getter for the peaks of a level.
+    * Parameters:
+    *  level: level to get, 0 being the finest (0 - getNumLevels() - 1)
+    * Output:
+    *  peaks of SAMPLES_PER_PEAK * 2^level samples each
+    *******************************************/
+    const std::vector<Peak>& getLevel(int level) const;
+
+    // public constants
+    static const int SAMPLES_PER_PEAK = 256;    // no. of samples per peak of the finest level
+
+private:
+    // functionality members
+    double sampleRate;      // sampling rate of the audio file
+    int64 lengthInSamples;  // length of the audio file in samples
+    std::vector<std::vector<Peak>> levels;  // peaks per level, finest first; each level
+                                            // holds half as many peaks as the one before
+
+    // private constants
+    static const int SIZE_BLOCK = SAMPLES_PER_PEAK * 256;   // no. of samples decoded at a time
+    static const int N_CHANNELS = 2;    // max. no. of channels the peaks are computed over
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformPeaks)
+};
\ No newline at end of file
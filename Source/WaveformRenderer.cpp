@@ -0,0 +1,793 @@
+/*
+  ==============================================================================
+
+    WaveformRenderer.cpp
+    Created: 18 Oct 2026 2:15:09pm
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#include "WaveformRenderer.h"
+
+using namespace juce::gl;
+
+/******************************************
+* Name:
+*  WaveformRenderer
+* Description:
+*  constructor of the WaveformRenderer class. Draws the waveforms,
+*  playheads and spectra of all decks on the GPU underneath the
+*  components painted by the OpenGL context. Each track's peaks are
+*  uploaded as a texture once and every frame is drawn by shaders,
+*  so the CPU only passes on the view and the playhead position.
+* Parameters:
+*  context: OpenGL context the renderer is attached to
+*  enabled: if the displays are drawn by the renderer instead of
+*    the software renderer
+* Output:
+*  N/A
+*******************************************/
+WaveformRenderer::WaveformRenderer(OpenGLContext& _context, bool _enabled) :
+    context(_context),
+    enabled(_enabled),
+    backgroundColour(Colours::black)
+{
+}
+
+/******************************************
+* Name:
+*  ~WaveformRenderer
+* Description:
+*  destructor of the WaveformRenderer class. The context must be
+*  detached before, which releases the GPU resources.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+WaveformRenderer::~WaveformRenderer() {
+    jassert(textures.empty() && vertexBuffer == 0);
+}
+
+/******************************************
+* Name:
+*  newOpenGLContextCreated
+* Description:
+*  override of base class newOpenGLContextCreated. Compiles the
+*  shaders and creates the vertex buffer of the quad every view
+*  is drawn with. Called on the rendering thread.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::newOpenGLContextCreated() {
+    waveformShader = createShader(SHADER_WAVEFORM);
+    spectrumShader = createShader(SHADER_SPECTRUM);
+
+    // a quad covering the whole frame, as a triangle strip
+    const GLfloat vertices[] = { -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+    glGenBuffers(1, &vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/******************************************
+* Name:
+*  renderOpenGL
+* Description:
+*  override of base class renderOpenGL. Clears the frame to the
+*  background colour, uploads peaks and spectra that changed and
+*  draws every visible view. Called on the rendering thread.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::renderOpenGL() {
+    // copy the views, so the message thread is not held up while they are drawn
+    auto background = Colours::black;
+    frame.clear();
+    {
+        const ScopedLock sl(lock);
+        background = backgroundColour;
+        for (auto& entry : views) {
+            frame.push_back(entry.second);
+            entry.second.spectrumChanged = false;
+        }
+    }
+
+    // release the textures of the displays removed since the last frame
+    for (auto it = textures.begin(); it != textures.end();) {
+        auto id = it->first;
+        auto used = std::any_of(frame.begin(), frame.end(), [id](const View& view) { return view.id == id; });
+        it = used ? std::next(it) : textures.erase(it);
+    }
+
+    // window background, the components are drawn on top of the frame afterwards
+    OpenGLHelpers::clear(background);
+    if (waveformShader == nullptr || spectrumShader == nullptr) {
+        return;
+    }
+
+    // size of the frame, as set up by the context
+    GLint frameViewport[4];
+    glGetIntegerv(GL_VIEWPORT, frameViewport);
+    auto frameHeight = (int)frameViewport[3];
+    auto scale = (float)context.getRenderingScale();
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glEnableVertexAttribArray(0);
+    glActiveTexture(GL_TEXTURE0);
+    glEnable(GL_SCISSOR_TEST);
+
+    for (const auto& view : frame) {
+        auto& viewTexture = textures[view.id];
+
+        // upload what changed, the peaks only once per track
+        if (view.isSpectrum) {
+            if (!view.spectrum.empty() && (view.spectrumChanged || viewTexture.texture.getTextureID() == 0)) {
+                viewTexture.texture.loadARGB(view.spectrum.data(), (int)view.spectrum.size() / 2, 2);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            }
+        }
+        else if (viewTexture.peaks != view.peaks) {
+            viewTexture.peaks = view.peaks;
+            if (viewTexture.peaks != nullptr) {
+                uploadPeaks(viewTexture);
+            }
+        }
+
+        if (!view.visible || view.clip.isEmpty()) {
+            continue;
+        }
+        if (!view.isSpectrum) {
+            drawWaveform(view, viewTexture, frameHeight, scale);
+        }
+        else if (viewTexture.texture.getTextureID() != 0) {
+            drawSpectrum(view, viewTexture, frameHeight, scale);
+        }
+    }
+
+    // leave the state as the context expects it for drawing the components
+    glDisable(GL_SCISSOR_TEST);
+    glDisableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+}
+
+/******************************************
+* Name:
+*  openGLContextClosing
+* Description:
+*  override of base class openGLContextClosing. Releases the
+*  shaders, textures and vertex buffer. Called on the rendering
+*  thread.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::openGLContextClosing() {
+    textures.clear();
+    waveformShader.reset();
+    spectrumShader.reset();
+    if (vertexBuffer != 0) {
+        glDeleteBuffers(1, &vertexBuffer);
+        vertexBuffer = 0;
+    }
+}
+
+/******************************************
+* Name:
+*  addWaveform
+* Description:
+*  starts drawing a waveform display, with its playhead, in the
+*  display's bounds. The display is followed when it or any of
+*  its parents moves. Must be called from the message thread.
+* Parameters:
+*  display: component the waveform is drawn in
+*  colours: colours to draw with, one per ViewColour
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::addWaveform(Component* display, const Colour* colours) {
+    View view;
+    std::copy(colours, colours + numViewColours, view.colours);
+    addView(display, std::move(view));
+}
+
+/******************************************
+* Name:
+*  addSpectrum
+* Description:
+*  starts drawing a spectrum display in the display's bounds.
+*  The display is followed when it or any of its parents moves.
+*  Must be called from the message thread.
+* Parameters:
+*  display: component the spectrum is drawn in
+*  colours: colours of the bars, from level 0 to 1
+*  numColours: no. of colours
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::addSpectrum(Component* display, const PixelARGB* colours, int numColours) {
+    View view;
+    view.isSpectrum = true;
+    view.barColours.assign(colours, colours + numColours);
+    addView(display, std::move(view));
+}
+
+/******************************************
+* Name:
+*  removeView
+* Description:
+*  stops drawing a display added by addWaveform or addSpectrum,
+*  its texture is released on the next frame. Must be called from
+*  the message thread.
+* Parameters:
+*  display: component to stop drawing
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::removeView(Component* display) {
+    watchers.erase(display);
+
+    const ScopedLock sl(lock);
+    views.erase(display);
+    context.triggerRepaint();
+}
+
+/******************************************
+* Name:
+*  isEnabled
+* Description:
+*  getter for if the displays are drawn by the renderer.
+* Parameters:
+*  N/A
+* Output:
+*  true if the displays are drawn on the GPU
+*******************************************/
+bool WaveformRenderer::isEnabled() const {
+    return enabled;
+}
+
+/******************************************
+* Name:
+*  setBackgroundColour
+* Description:
+*  setter for the colour the frame is cleared to, showing
+*  wherever the components paint nothing.
+* Parameters:
+*  colour: background colour of the window
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::setBackgroundColour(Colour colour) {
+    const ScopedLock sl(lock);
+    backgroundColour = colour;
+    context.triggerRepaint();
+}
+
+/******************************************
+* Name:
+*  setPeaks
+* Description:
+*  setter for the peaks of a waveform display. They are uploaded
+*  to the GPU once, on the next frame.
+* Parameters:
+*  display: component the waveform is drawn in
+*  peaks: peaks of the track, nullptr to draw just the background
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::setPeaks(Component* display, std::shared_ptr<const WaveformPeaks> peaks) {
+    const ScopedLock sl(lock);
+    auto it = views.find(display);
+    if (it == views.end()) {
+        return;
+    }
+    it->second.peaks = std::move(peaks);
+    context.triggerRepaint();
+}
+
+/******************************************
+* Name:
+*  setView
+* Description:
+*  setter for the visible part of the track and the playhead
+*  position of a waveform display.
+* Parameters:
+*  display: component the waveform is drawn in
+*  viewStart: start of the visible part of the track (relative)
+*  viewLength: length of the visible part of the track (relative)
+*  position: playhead position (relative)
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::setView(Component* display, double viewStart, double viewLength, double position) {
+    const ScopedLock sl(lock);
+    auto it = views.find(display);
+    if (it == views.end()) {
+        return;
+    }
+
+    // only draw a new frame if the waveform moved
+    auto& view = it->second;
+    if (view.viewStart == viewStart && view.viewLength == viewLength && view.position == position) {
+        return;
+    }
+    view.viewStart = viewStart;
+    view.viewLength = viewLength;
+    view.position = position;
+    context.triggerRepaint();
+}
+
+/******************************************
+* Name:
+*  setSpectrum
+* Description:
+*  setter for the levels of a spectrum display, uploaded to the
+*  GPU on the next frame.
+* Parameters:
+*  display: component the spectrum is drawn in
+*  levels: levels of the spectrum (0.0 - 1.0)
+*  numLevels: no. of levels
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::setSpectrum(Component* display, const float* levels, int numLevels) {
+    const ScopedLock sl(lock);
+    auto it = views.find(display);
+    if (it == views.end()) {
+        return;
+    }
+    auto& view = it->second;
+
+    // a power of two wide, so the texture is not padded, with the bar colours in the second row
+    auto width = nextPowerOfTwo(jmax(numLevels, (int)view.barColours.size()));
+    if ((int)view.spectrum.size() != width * 2) {
+        view.spectrum.assign((size_t)width * 2, PixelARGB());
+        std::copy(view.barColours.begin(), view.barColours.end(), view.spectrum.begin() + width);
+    }
+
+    // levels in the first row as 16 bits, the high byte in red and the low byte in green
+    for (auto i = 0; i < numLevels; ++i) {
+        auto level = jlimit(0, 65535, roundToInt(levels[i] * 65535.0f));
+        view.spectrum[(size_t)i] = PixelARGB(255, (uint8)(level >> 8), (uint8)(level & 255), 0);
+    }
+    view.numLevels = numLevels;
+    view.spectrumChanged = true;
+    context.triggerRepaint();
+}
+
+/******************************************
+* Name:
+*  ViewWatcher
+* Description:
+*  constructor of the ViewWatcher class.
+* Parameters:
+*  renderer: renderer drawing the display
+*  display: component to follow
+* Output:
+*  N/A
+*******************************************/
+WaveformRenderer::ViewWatcher::ViewWatcher(WaveformRenderer& _renderer, Component* _display) :
+    ComponentMovementWatcher(_display),
+    renderer(_renderer),
+    display(_display)
+{
+}
+
+/******************************************
+* Name:
+*  componentMovedOrResized
+* Description:
+*  override of base class componentMovedOrResized. Updates
+*  where the display is drawn.
+* Parameters:
+*  wasMoved: Not Used.
+*  wasResized: Not Used.
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::ViewWatcher::componentMovedOrResized(bool wasMoved, bool wasResized) {
+    renderer.updateArea(display);
+}
+
+/******************************************
+* Name:
+*  componentPeerChanged
+* Description:
+*  override of base class componentPeerChanged. Updates
+*  where the display is drawn.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::ViewWatcher::componentPeerChanged() {
+    renderer.updateArea(display);
+}
+
+/******************************************
+* Name:
+*  componentVisibilityChanged
+* Description:
+*  override of base class componentVisibilityChanged.
+*  Updates if the display is drawn.
+* Parameters:
+*  N/A
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::ViewWatcher::componentVisibilityChanged() {
+    renderer.updateArea(display);
+}
+
+/******************************************
+* Name:
+*  addView
+* Description:
+*  starts drawing a display and following its position.
+* Parameters:
+*  display: component to draw in
+*  view: what to draw
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::addView(Component* display, View view) {
+    view.id = nextId++;
+    {
+        const ScopedLock sl(lock);
+        views[display] = std::move(view);
+    }
+    watchers[display] = std::make_unique<ViewWatcher>(*this, display);
+    updateArea(display);
+}
+
+/******************************************
+* Name:
+*  updateArea
+* Description:
+*  updates the bounds of a display within the target component
+*  and the part of them that is showing.
+* Parameters:
+*  display: component drawn in
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::updateArea(Component* display) {
+    // only the part inside all parents shows, e.g. none of a deck scrolled out of view
+    RectangleList<int> visibleArea;
+    if (display->isShowing()) {
+        display->getVisibleArea(visibleArea, false);
+    }
+    auto* target = context.getTargetComponent();
+
+    const ScopedLock sl(lock);
+    auto it = views.find(display);
+    if (it == views.end()) {
+        return;
+    }
+    auto& view = it->second;
+    view.visible = target != nullptr && !visibleArea.isEmpty();
+    if (view.visible) {
+        view.area = target->getLocalArea(display, display->getLocalBounds());
+        view.clip = target->getLocalArea(display, visibleArea.getBounds());
+    }
+    context.triggerRepaint();
+}
+
+/******************************************
+* Name:
+*  createShader
+* Description:
+*  compiles and links a shader program drawing the quad of a view.
+* Parameters:
+*  fragmentShader: source of the fragment shader
+* Output:
+*  linked shader program, nullptr if it failed to build
+*******************************************/
+std::unique_ptr<OpenGLShaderProgram> WaveformRenderer::createShader(const char* fragmentShader) {
+    auto shader = std::make_unique<OpenGLShaderProgram>(context);
+    if (shader->addVertexShader(OpenGLHelpers::translateVertexShaderToV3(SHADER_VERTEX))
+        && shader->addFragmentShader(OpenGLHelpers::translateFragmentShaderToV3(fragmentShader))) {
+        // both programs read the quad's vertices from attribute 0
+        glBindAttribLocation(shader->getProgramID(), 0, "position");
+        if (shader->link()) {
+            return shader;
+        }
+    }
+    DBG("WaveformRenderer::createShader: " << shader->getLastError());
+    return nullptr;
+}
+
+/******************************************
+* Name:
+*  uploadPeaks
+* Description:
+*  uploads the peaks of a waveform as a texture, one texel per
+*  peak holding its max., min. and RMS level. Each level of the
+*  peaks starts on a new row.
+* Parameters:
+*  viewTexture: texture to upload to, holding the peaks to upload
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::uploadPeaks(ViewTexture& viewTexture) {
+    const auto& peaks = *viewTexture.peaks;
+
+    // rows taken by each level
+    auto rows = 0;
+    viewTexture.levelRows.clear();
+    for (auto level = 0; level < peaks.getNumLevels(); ++level) {
+        viewTexture.levelRows.push_back(rows);
+        rows += ((int)peaks.getLevel(level).size() + WIDTH_TEXTURE - 1) / WIDTH_TEXTURE;
+    }
+
+    // max. in red and min. in green, mapped from -1 - 1 to 0 - 255, and RMS in blue;
+    // the height is a power of two too, so the texture is not padded
+    auto height = nextPowerOfTwo(rows);
+    auto toByte = [](float value) { return (uint8)jlimit(0, 255, roundToInt(value * 255.0f)); };
+    std::vector<PixelARGB> pixels((size_t)WIDTH_TEXTURE * (size_t)height);
+    for (auto level = 0; level < peaks.getNumLevels(); ++level) {
+        auto* pixel = pixels.data() + (size_t)viewTexture.levelRows[(size_t)level] * WIDTH_TEXTURE;
+        for (const auto& peak : peaks.getLevel(level)) {
+            *pixel++ = PixelARGB(255, toByte(peak.max * 0.5f + 0.5f), toByte(peak.min * 0.5f + 0.5f),
+                toByte(peak.rms));
+        }
+    }
+
+    // peaks are read one texel at a time
+    viewTexture.texture.loadARGB(pixels.data(), WIDTH_TEXTURE, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+}
+
+/******************************************
+* Name:
+*  drawWaveform
+* Description:
+*  draws a waveform and its playhead with the waveform shader,
+*  reading the level of the peaks that has about one peak per pixel.
+* Parameters:
+*  view: waveform to draw
+*  viewTexture: texture holding the peaks of the waveform
+*  frameHeight: height of the frame in pixels
+*  scale: no. of pixels per logical pixel
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::drawWaveform(const View& view, ViewTexture& viewTexture, int frameHeight,
+    float scale) {
+    auto& shader = *waveformShader;
+    shader.use();
+    setArea(shader, view, frameHeight, scale);
+
+    const char* colourNames[numViewColours] = { "background", "waveform", "rms", "playheadColour" };
+    for (auto i = 0; i < numViewColours; ++i) {
+        const auto& colour = view.colours[i];
+        shader.setUniform(colourNames[i], colour.getFloatRed(), colour.getFloatGreen(),
+            colour.getFloatBlue(), colour.getFloatAlpha());
+    }
+
+    // just the background until the peaks are ready
+    if (viewTexture.peaks == nullptr) {
+        shader.setUniform("numPeaks", 0.0f);
+        shader.setUniform("playhead", 0.0f, 0.0f);
+    }
+    else {
+        const auto& peaks = *viewTexture.peaks;
+        auto width = view.area.getWidth();
+        auto length = (double)peaks.getLengthInSamples();
+        auto samplesPerPixel = length * view.viewLength / width;
+
+        // the coarsest level with at least one peak per pixel, as WaveformPeaks::getPeaks picks it
+        auto level = 0;
+        auto samplesPerPeak = (double)WaveformPeaks::SAMPLES_PER_PEAK;
+        while (level + 1 < peaks.getNumLevels() && samplesPerPeak * 2 <= samplesPerPixel) {
+            ++level;
+            samplesPerPeak *= 2;
+        }
+        shader.setUniform("levelRow", (GLfloat)viewTexture.levelRows[(size_t)level]);
+        shader.setUniform("numPeaks", (GLfloat)peaks.getLevel(level).size());
+        shader.setUniform("startPeak", (GLfloat)(view.viewStart * length / samplesPerPeak));
+        shader.setUniform("peaksPerPixel", (GLfloat)(samplesPerPixel / samplesPerPeak));
+        shader.setUniform("lengthInPeaks", (GLfloat)(length / samplesPerPeak));
+
+        // the same columns WaveformDisplayPlayhead covers
+        auto windowWidth = width / WaveformDisplayPlayhead::N_WINDOW;
+        auto x = (int)((view.position - view.viewStart) / view.viewLength * width) - windowWidth / 2;
+        shader.setUniform("playhead", (GLfloat)x, (GLfloat)(x + windowWidth));
+    }
+
+    viewTexture.texture.bind();
+    shader.setUniform("peaks", 0);
+    shader.setUniform("textureSize", (GLfloat)viewTexture.texture.getWidth(),
+        (GLfloat)viewTexture.texture.getHeight());
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+/******************************************
+* Name:
+*  drawSpectrum
+* Description:
+*  draws a spectrum with the spectrum shader.
+* Parameters:
+*  view: spectrum to draw
+*  viewTexture: texture holding the levels and colours of the spectrum
+*  frameHeight: height of the frame in pixels
+*  scale: no. of pixels per logical pixel
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::drawSpectrum(const View& view, ViewTexture& viewTexture, int frameHeight,
+    float scale) {
+    auto& shader = *spectrumShader;
+    shader.use();
+    setArea(shader, view, frameHeight, scale);
+
+    // bars as wide as FrequencyDisplay draws them
+    shader.setUniform("numLevels", (GLfloat)view.numLevels);
+    shader.setUniform("numColours", (GLfloat)view.barColours.size());
+    shader.setUniform("barWidth", (GLfloat)jmax(1, view.area.getWidth() / jmax(1, view.numLevels)));
+
+    viewTexture.texture.bind();
+    shader.setUniform("spectrum", 0);
+    shader.setUniform("textureSize", (GLfloat)viewTexture.texture.getWidth(),
+        (GLfloat)viewTexture.texture.getHeight());
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+/******************************************
+* Name:
+*  setArea
+* Description:
+*  passes the area of a view to the shader in use and limits
+*  drawing to the part of it that is showing.
+* Parameters:
+*  shader: shader in use
+*  view: view to draw
+*  frameHeight: height of the frame in pixels
+*  scale: no. of pixels per logical pixel
+* Output:
+*  N/A
+*******************************************/
+void WaveformRenderer::setArea(OpenGLShaderProgram& shader, const View& view, int frameHeight, float scale) {
+    // the frame counts rows from the bottom
+    auto area = view.area.toFloat() * scale;
+    shader.setUniform("area", area.getX(), (GLfloat)frameHeight - area.getBottom(), scale);
+    shader.setUniform("size", (GLfloat)view.area.getWidth(), (GLfloat)view.area.getHeight());
+
+    auto clip = (view.clip.toFloat() * scale).getSmallestIntegerContainer();
+    glScissor(clip.getX(), frameHeight - clip.getBottom(), clip.getWidth(), clip.getHeight());
+}
+
+const char* const WaveformRenderer::SHADER_VERTEX = R"(
+attribute vec2 position;
+
+void main()
+{
+    gl_Position = vec4(position, 0.0, 1.0);
+}
+)";
+
+const char* const WaveformRenderer::SHADER_WAVEFORM = R"(
+#ifdef GL_ES
+precision highp float;
+#endif
+
+uniform sampler2D peaks;        // max., min. and RMS of each peak, the levels one after the other
+uniform vec2 textureSize;       // size of the texture in texels
+uniform vec3 area;              // bottom left corner of the view in the frame, pixels per logical pixel
+uniform vec2 size;              // size of the view in logical pixels
+uniform float levelRow;         // first row of the level drawn
+uniform float numPeaks;         // no. of peaks of the level, 0 for just the background
+uniform float startPeak;        // peak at the left edge of the view
+uniform float peaksPerPixel;    // no. of peaks per column
+uniform float lengthInPeaks;    // length of the track in peaks
+uniform vec2 playhead;          // first and one past the last column of the playhead
+uniform vec4 background;
+uniform vec4 waveform;
+uniform vec4 rms;
+uniform vec4 playheadColour;
+
+// min., max. and RMS of a peak of the level drawn
+vec3 getPeak(float index)
+{
+    float row = floor(index / textureSize.x);
+    vec2 texel = vec2(index - row * textureSize.x, levelRow + row) + 0.5;
+    vec4 peak = texture2D(peaks, texel / textureSize);
+    return vec3(peak.g * 2.0 - 1.0, peak.r * 2.0 - 1.0, peak.b);
+}
+
+void main()
+{
+    // column and row of the view in logical pixels, rows counted from the top
+    vec2 pixel = (gl_FragCoord.xy - area.xy) / area.z;
+    float x = floor(pixel.x);
+    float y = size.y - pixel.y;
+    vec4 colour = background;
+
+    // combine the (at most three) peaks the column overlaps, as WaveformPeaks::getPeaks does
+    float start = max(0.0, startPeak + x * peaksPerPixel);
+    float end = min(startPeak + (x + 1.0) * peaksPerPixel, lengthInPeaks);
+    float first = floor(start);
+    if (start < end && first < numPeaks) {
+        float last = min(numPeaks, max(first + 1.0, ceil(end)));
+        vec3 peak = getPeak(first);
+        float sumSquares = peak.z * peak.z;
+        for (int i = 1; i < 4; ++i) {
+            float index = first + float(i);
+            if (index >= last) {
+                break;
+            }
+            vec3 p = getPeak(index);
+            peak.x = min(peak.x, p.x);
+            peak.y = max(peak.y, p.y);
+            sumSquares += p.z * p.z;
+        }
+        peak.z = sqrt(sumSquares / (last - first));
+
+        // min. to max., at least a pixel high, with the RMS level on top of it
+        float centre = size.y * 0.5;
+        float top = centre - peak.y * centre;
+        float bottom = max(top + 1.0, centre - peak.x * centre);
+        if (y >= top && y < bottom) {
+            colour = waveform;
+        }
+        if (abs(y - centre) < peak.z * centre) {
+            colour = rms;
+        }
+    }
+
+    if (x >= playhead.x && x < playhead.y) {
+        colour.rgb = mix(colour.rgb, playheadColour.rgb, playheadColour.a);
+    }
+    gl_FragColor = vec4(colour.rgb, 1.0);
+}
+)";
+
+const char* const WaveformRenderer::SHADER_SPECTRUM = R"(
+#ifdef GL_ES
+precision highp float;
+#endif
+
+uniform sampler2D spectrum;     // levels in the first row as 16 bits, the high byte in red and the
+                                // low byte in green, the bar colours in the second row
+uniform vec2 textureSize;       // size of the texture in texels
+uniform vec3 area;              // bottom left corner of the view in the frame, pixels per logical pixel
+uniform vec2 size;              // size of the view in logical pixels
+uniform float numLevels;        // no. of levels
+uniform float numColours;       // no. of bar colours
+uniform float barWidth;         // width of a bar in logical pixels
+
+void main()
+{
+    // column and row of the view in logical pixels, rows counted from the top
+    vec2 pixel = (gl_FragCoord.xy - area.xy) / area.z;
+    float x = floor(pixel.x);
+    float y = floor(size.y - pixel.y);
+    vec4 colour = vec4(0.0, 0.0, 0.0, 1.0);
+
+    // column x shows the bar of level x + 1, as FrequencyDisplay draws it
+    if (x < numLevels - 2.0 + barWidth) {
+        float i = min(x + 1.0, numLevels - 1.0);
+        vec4 texel = texture2D(spectrum, vec2(i + 0.5, 0.5) / textureSize);
+        float level = (floor(texel.r * 255.0 + 0.5) * 256.0 + floor(texel.g * 255.0 + 0.5)) / 65535.0;
+        float top = floor((1.0 - level) * size.y);
+        float height = min(floor(level * size.y), size.y - top);
+        if (top > 0.0 && height > 0.0 && y >= top && y < top + height) {
+            float c = floor(level * (numColours - 1.0) + 0.5);
+            colour = texture2D(spectrum, vec2(c + 0.5, 1.5) / textureSize);
+        }
+    }
+    gl_FragColor = colour;
+}
+)";
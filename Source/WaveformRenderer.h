@@ -0,0 +1,438 @@
+/*
+  ==============================================================================
+
+    WaveformRenderer.h
+    Created: 18 Oct 2026 2:15:09pm
+    Author:  Anna
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+using namespace juce;
+
+#include "WaveformPeaks.h"
+#include "WaveformDisplayPlayhead.h"
+
+class WaveformRenderer : public OpenGLRenderer {
+public:
+    // colours a view is drawn with
+    enum ViewColour {
+        colourBackground,   // background of the view
+        colourWaveform,     // min. to max. of the waveform
+        colourRms,          // RMS level of the waveform
+        colourPlayhead,     // playhead, its alpha is how much it covers the waveform
+        numViewColours      // not a colour
+    };
+
+    // constructors & destructors
+    /******************************************
+    * Name:
+    *  WaveformRenderer
+    * Description:
+    *  constructor of the WaveformRenderer class. Draws the waveforms,
+    *  playheads and spectra of all decks on the GPU underneath the
+    *  components painted by the OpenGL context. Each track's peaks are
+    *  uploaded as a texture once and every frame is drawn by shaders,
+    *  so the CPU only passes on the view and the playhead position.
+    * Parameters:
+    *  context: OpenGL context the renderer is attached to
+    *  enabled: if the displays are drawn by the renderer instead of
+    *    the software renderer
+    * Output:
+    *  N/A
+    *******************************************/
+    WaveformRenderer(OpenGLContext& context, bool enabled);
+
+    /******************************************
+    * Name:
+    *  ~WaveformRenderer
+    * Description:
+    *  destructor of the WaveformRenderer class. The context must be
+    *  detached before, which releases the GPU resources.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    ~WaveformRenderer() override;
+
+    // OpenGLRenderer overrides
+    /******************************************
+    * Name:
+    *  newOpenGLContextCreated
+    * Description:
+    *  override of base class newOpenGLContextCreated. Compiles the
+    *  shaders and creates the vertex buffer of the quad every view
+    *  is drawn with. Called on the rendering thread.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void newOpenGLContextCreated() override;
+
+    /******************************************
+    * Name:
+    *  renderOpenGL
+    * Description:
+    *  override of base class renderOpenGL. Clears the frame to the
+    *  background colour, uploads peaks and spectra that changed and
+    *  draws every visible view. Called on the rendering thread.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void renderOpenGL() override;
+
+    /******************************************
+    * Name:
+    *  openGLContextClosing
+    * Description:
+    *  override of base class openGLContextClosing. Releases the
+    *  shaders, textures and vertex buffer. Called on the rendering
+    *  thread.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  N/A
+    *******************************************/
+    void openGLContextClosing() override;
+
+    // methods
+    /******************************************
+    * Name:
+    *  addWaveform
+    * Description:
+    *  starts drawing a waveform display, with its playhead, in the
+    *  display's bounds. The display is followed when it or any of
+    *  its parents moves. Must be called from the message thread.
+    * Parameters:
+    *  display: component the waveform is drawn in
+    *  colours: colours to draw with, one per ViewColour
+    * Output:
+    *  N/A
+    *******************************************/
+    void addWaveform(Component* display, const Colour* colours);
+
+    /******************************************
+    * Name:
+    *  addSpectrum
+    * Description:
+    *  starts drawing a spectrum display in the display's bounds.
+    *  The display is followed when it or any of its parents moves.
+    *  Must be called from the message thread.
+    * Parameters:
+    *  display: component the spectrum is drawn in
+    *  colours: colours of the bars, from level 0 to 1
+    *  numColours: no. of colours
+    * Output:
+    *  N/A
+    *******************************************/
+    void addSpectrum(Component* display, const PixelARGB* colours, int numColours);
+
+    /******************************************
+    * Name:
+    *  removeView
+    * Description:
+    *  stops drawing a display added by addWaveform or addSpectrum,
+    *  its texture is released on the next frame. Must be called from
+    *  the message thread.
+    * Parameters:
+    *  display: component to stop drawing
+    * Output:
+    *  N/A
+    *******************************************/
+    void removeView(Component* display);
+
+    // getters & setters
+    /******************************************
+    * Name:
+    *  isEnabled
+    * Description:
+    *  getter for if the displays are drawn by the renderer.
+    * Parameters:
+    *  N/A
+    * Output:
+    *  true if the displays are drawn on the GPU
+    *******************************************/
+    bool isEnabled() const;
+
+    /******************************************
+    * Name:
+    *  setBackgroundColour
+    * Description:
+    *  setter for the colour the frame is cleared to, showing
+    *  wherever the components paint nothing.
+    * Parameters:
+    *  colour: background colour of the window
+    * Output:
+    *  N/A
+    *******************************************/
+    void setBackgroundColour(Colour colour);
+
+    /******************************************
+    * Name:
+    *  setPeaks
+    * Description:
+    *  setter for the peaks of a waveform display. They are uploaded
+    *  to the GPU once, on the next frame.
+    * Parameters:
+    *  display: component the waveform is drawn in
+    *  peaks: peaks of the track, nullptr to draw just the background
+    * Output:
+    *  N/A
+    *******************************************/
+    void setPeaks(Component* display, std::shared_ptr<const WaveformPeaks> peaks);
+
+    /******************************************
+    * Name:
+    *  setView
+    * Description:
+    *  setter for the visible part of the track and the playhead
+    *  position of a waveform display.
+    * Parameters:
+    *  display: component the waveform is drawn in
+    *  viewStart: start of the visible part of the track (relative)
+    *  viewLength: length of the visible part of the track (relative)
+    *  position: playhead position (relative)
+    * Output:
+    *  N/A
+    *******************************************/
+    void setView(Component* display, double viewStart, double viewLength, double position);
+
+    /******************************************
+    * Name:
+    *  setSpectrum
+    * Description:
+    *  setter for the levels of a spectrum display, uploaded to the
+    *  GPU on the next frame.
+    * Parameters:
+    *  display: component the spectrum is drawn in
+    *  levels: levels of the spectrum (0.0 - 1.0)
+    *  numLevels: no. of levels
+    * Output:
+    *  N/A
+    *******************************************/
+    void setSpectrum(Component* display, const float* levels, int numLevels);
+
+private:
+    // a waveform or spectrum display drawn by the renderer
+    struct View {
+        int id = 0;             // identifies the view's texture on the rendering thread
+        bool isSpectrum = false;    // true for a spectrum, false for a waveform
+        bool visible = false;   // if any part of the display is showing
+        Rectangle<int> area;    // bounds of the display in the target component
+        Rectangle<int> clip;    // part of the bounds not hidden by the display's parents
+        Colour colours[numViewColours]; // colours of a waveform
+        std::shared_ptr<const WaveformPeaks> peaks; // peaks of a waveform, nullptr until ready
+        double viewStart = 0.0;     // start of the visible part of the track (relative)
+        double viewLength = 1.0;    // length of the visible part of the track (relative)
+        double position = 0.0;      // playhead position (relative)
+        int numLevels = 0;          // no. of levels of a spectrum
+        std::vector<PixelARGB> barColours;  // colours of the bars of a spectrum, from level 0 to 1
+        std::vector<PixelARGB> spectrum;    // texture of a spectrum, the levels in the first
+                                            // row and the colours in the second
+        bool spectrumChanged = false;   // if the spectrum changed since it was uploaded
+    };
+
+    // texture of a view, only used on the rendering thread
+    struct ViewTexture {
+        OpenGLTexture texture;  // peaks or spectrum of the view
+        std::shared_ptr<const WaveformPeaks> peaks; // peaks the texture holds
+        std::vector<int> levelRows; // first texture row of each level of the peaks
+    };
+
+    // follows a display moving with any of its parents, e.g. when the decks are scrolled
+    class ViewWatcher : public ComponentMovementWatcher {
+    public:
+        // constructors & destructors
+        /******************************************
+        * Name:
+        *  ViewWatcher
+        * Description:
+        *  constructor of the ViewWatcher class.
+        * Parameters:
+        *  renderer: renderer drawing the display
+        *  display: component to follow
+        * Output:
+        *  N/A
+        *******************************************/
+        ViewWatcher(WaveformRenderer& renderer, Component* display);
+
+        // ComponentMovementWatcher overrides
+        /******************************************
+        * Name:
+        *  componentMovedOrResized
+        * Description:
+        *  override of base class componentMovedOrResized. Updates
+        *  where the display is drawn.
+        * Parameters:
+        *  wasMoved: Not Used.
+        *  wasResized: Not Used.
+        * Output:
+        *  N/A
+        *******************************************/
+        void componentMovedOrResized(bool wasMoved, bool wasResized) override;
+
+        /******************************************
+        * Name:
+        *  componentPeerChanged
+        * Description:
+        *  override of base class componentPeerChanged. Updates
+        *  where the display is drawn.
+        * Parameters:
+        *  N/A
+        * Output:
+        *  N/A
+        *******************************************/
+        void componentPeerChanged() override;
+
+        /******************************************
+        * Name:
+        *  componentVisibilityChanged
+        * Description:
+        *  override of base class componentVisibilityChanged.
+        *  Updates if the display is drawn.
+        * Parameters:
+        *  N/A
+        * Output:
+        *  N/A
+        *******************************************/
+        void componentVisibilityChanged() override;
+
+    private:
+        WaveformRenderer& renderer; // renderer drawing the display
+        Component* display;         // component followed
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ViewWatcher)
+    };
+
+    // methods
+    /******************************************
+    * Name:
+    *  addView
+    * Description:
+    *  starts drawing a display and following its position.
+    * Parameters:
+    *  display: component to draw in
+    *  view: what to draw
+    * Output:
+    *  N/A
+    *******************************************/
+    void addView(Component* display, View view);
+
+    /******************************************
+    * Name:
+    *  updateArea
+    * Description:
+    *  updates the bounds of a display within the target component
+    *  and the part of them that is showing.
+    * Parameters:
+    *  display: component drawn in
+    * Output:
+    *  N/A
+    *******************************************/
+    void updateArea(Component* display);
+
+    /******************************************
+    * Name:
+    *  createShader
+    * Description:
+    *  compiles and links a shader program drawing the quad of a view.
+    * Parameters:
+    *  fragmentShader: source of the fragment shader
+    * Output:
+    *  linked shader program, nullptr if it failed to build
+    *******************************************/
+    std::unique_ptr<OpenGLShaderProgram> createShader(const char* fragmentShader);
+
+    /******************************************
+    * Name:
+    *  uploadPeaks
+    * Description:
+    *  uploads the peaks of a waveform as a texture, one texel per
+    *  peak holding its max., min. and RMS level. Each level of the
+    *  peaks starts on a new row.
+    * Parameters:
+    *  viewTexture: texture to upload to, holding the peaks to upload
+    * Output:
+    *  N/A
+    *******************************************/
+    void uploadPeaks(ViewTexture& viewTexture);
+
+    /******************************************
+    * Name:
+    *  drawWaveform
+    * Description:
+    *  draws a waveform and its playhead with the waveform shader,
+    *  reading the level of the peaks that has about one peak per pixel.
+    * Parameters:
+    *  view: waveform to draw
+    *  viewTexture: texture holding the peaks of the waveform
+    *  frameHeight: height of the frame in pixels
+    *  scale: no. of pixels per logical pixel
+    * Output:
+    *  N/A
+    *******************************************/
+    void drawWaveform(const View& view, ViewTexture& viewTexture, int frameHeight, float scale);
+
+    /******************************************
+    * Name:
+    *  drawSpectrum
+    * Description:
+    *  draws a spectrum with the spectrum shader.
+    * Parameters:
+    *  view: spectrum to draw
+    *  viewTexture: texture holding the levels and colours of the spectrum
+    *  frameHeight: height of the frame in pixels
+    *  scale: no. of pixels per logical pixel
+    * Output:
+    *  N/A
+    *******************************************/
+    void drawSpectrum(const View& view, ViewTexture& viewTexture, int frameHeight, float scale);
+
+    /******************************************
+    * Name:
+    *  setArea
+    * Description:
+    *  passes the area of a view to the shader in use and limits
+    *  drawing to the part of it that is showing.
+    * Parameters:
+    *  shader: shader in use
+    *  view: view to draw
+    *  frameHeight: height of the frame in pixels
+    *  scale: no. of pixels per logical pixel
+    * Output:
+    *  N/A
+    *******************************************/
+    static void setArea(OpenGLShaderProgram& shader, const View& view, int frameHeight, float scale);
+
+    // functionality members
+    OpenGLContext& context; // OpenGL context the renderer is attached to
+    bool enabled;           // if the displays are drawn by the renderer
+    CriticalSection lock;   // guards the members below, shared with the rendering thread
+    std::map<Component*, View> views;   // views drawn, by display
+    Colour backgroundColour;    // colour the frame is cleared to
+
+    // message thread members
+    int nextId = 1;     // id of the next view added
+    std::map<Component*, std::unique_ptr<ViewWatcher>> watchers;    // follows each display
+
+    // rendering thread members
+    std::vector<View> frame;    // views drawn in the current frame, copied from views
+    std::map<int, ViewTexture> textures;    // texture of each view, by id
+    std::unique_ptr<OpenGLShaderProgram> waveformShader;    // draws a waveform and playhead
+    std::unique_ptr<OpenGLShaderProgram> spectrumShader;    // draws a spectrum
+    GLuint vertexBuffer = 0;    // quad covering the frame, limited to a view by the scissor box
+
+    // private constants
+    static const int WIDTH_TEXTURE = 2048;  // width of a peak texture, in peaks
+    static const char* const SHADER_VERTEX;     // vertex shader of both programs
+    static const char* const SHADER_WAVEFORM;   // fragment shader of a waveform
+    static const char* const SHADER_SPECTRUM;   // fragment shader of a spectrum
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformRenderer)
+};